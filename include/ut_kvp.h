@@ -41,21 +41,132 @@ typedef enum
     UT_KVP_STATUS_NO_DATA,           /**!< No data to process. */
     UT_KVP_STATUS_NULL_PARAM,        /**!< Null parameter passed. */
     UT_KVP_STATUS_INVALID_INSTANCE,  /**!< Invalid KVP instance handle. */
+    UT_KVP_STATUS_TIMEOUT,           /**!< Includes were not fetched within the time allowed. */
     UT_KVP_STATUS_MAX                /**!< Out of range marker (not a valid status). */
 } ut_kvp_status_t;
 
 
+/**! Creation flags for a KVP instance, may be combined. */
+typedef enum
+{
+    UT_KVP_FLAG_NONE = 0,            /**!< Default behaviour. */
+    UT_KVP_FLAG_INDEX = (1 << 0),    /**!< Build a hash index over every key path when a profile is opened. */
+    UT_KVP_FLAG_PARALLEL_INCLUDES = (1 << 1),   /**!< Fetch and parse the includes of a profile on worker threads when it is opened. */
+    UT_KVP_FLAG_SHARED_INCLUDES = (1 << 2),     /**!< Expand each distinct `!include` once and reference it from every other site. */
+    UT_KVP_FLAG_CONCURRENT = (1 << 3),          /**!< Serve getters from any thread without locks, writers publish a new document atomically. */
+    UT_KVP_FLAG_THREADSAFE = (1 << 4),          /**!< Guard the instance with a reader-writer lock, getters share it and writers take it exclusively. */
+    UT_KVP_FLAG_LAZY = (1 << 5),                /**!< Parse each top-level section of a profile file when a getter first reaches into it. */
+} ut_kvp_flags_t;
+
 /**! Handle to a KVP instance. */
-typedef void ut_kvp_instance_t;    
+typedef void ut_kvp_instance_t;
+
+/**! Handle to a pre-compiled KVP key. */
+typedef void ut_kvp_key_t;
+
+/**! Handle to a cursor over the children of a KVP mapping or sequence. */
+typedef void ut_kvp_iterator_t;
 
 #define UT_KVP_MAX_ELEMENT_SIZE (256)  /**!< Maximum size of a single KVP element (in bytes). */
 
+/**! Value types understood by the batch API, `ut_kvp_getFields()`. */
+typedef enum
+{
+    UT_KVP_FIELD_TYPE_BOOL = 0,      /**!< `bool` destination. */
+    UT_KVP_FIELD_TYPE_UINT8,         /**!< `uint8_t` destination. */
+    UT_KVP_FIELD_TYPE_UINT16,        /**!< `uint16_t` destination. */
+    UT_KVP_FIELD_TYPE_UINT32,        /**!< `uint32_t` destination. */
+    UT_KVP_FIELD_TYPE_UINT64,        /**!< `uint64_t` destination. */
+    UT_KVP_FIELD_TYPE_FLOAT,         /**!< `float` destination. */
+    UT_KVP_FIELD_TYPE_DOUBLE,        /**!< `double` destination. */
+    UT_KVP_FIELD_TYPE_STRING,        /**!< `char` buffer of `uStringSize` bytes. */
+    UT_KVP_FIELD_TYPE_MAX            /**!< Out of range marker (not a valid type). */
+} ut_kvp_field_type_t;
+
+/**! Describes one field to read with `ut_kvp_getFields()`. */
+typedef struct
+{
+    const char *pszKey;              /**!< Key of the field (null-terminated string). */
+    ut_kvp_field_type_t type;        /**!< Type of the value to decode. */
+    void *pValue;                    /**!< Destination, of the type given by `type`. */
+    uint32_t uStringSize;            /**!< Size of the destination buffer, only used for `UT_KVP_FIELD_TYPE_STRING`. */
+    ut_kvp_status_t status;          /**!< Filled in with the result for this field. */
+} ut_kvp_field_t;
+
+/**! Counters for the process-wide include cache, see `ut_kvp_getIncludeCacheStats()`. */
+typedef struct
+{
+    uint64_t hits;                   /**!< Includes copied from an already parsed file or URL. */
+    uint64_t misses;                 /**!< Includes that had to be read and parsed, or URLs revalidated with their server. */
+    uint32_t entries;                /**!< Parsed includes currently held. */
+} ut_kvp_include_cache_stats_t;
+
 /**!
  * @brief Creates a new KVP instance.
  * @returns Handle to the created KVP instance, or NULL on failure. 
  */ 
 ut_kvp_instance_t *ut_kvp_createInstance(void);
 
+/**!
+ * @brief Creates a new KVP instance with the given creation flags.
+ *
+ * With `UT_KVP_FLAG_INDEX` set, every open builds a hash table from each full key path in the
+ * profile to its node. Lookups then cost one hash and one compare, regardless of how wide the
+ * profile is, at the price of building the index once per open.
+ *
+ * With `UT_KVP_FLAG_PARALLEL_INCLUDES` set, every file and URL the profile includes, at any depth,
+ * is read and parsed on a small pool of threads before the includes are expanded. Expansion then
+ * splices them in the usual order from the include cache, so the resulting profile is identical
+ * to a sequential open, while sibling includes no longer pay their latencies one after another.
+ *
+ * With `UT_KVP_FLAG_SHARED_INCLUDES` set, a file or URL included by value at several sites (an
+ * `!include` tag, or an `include:` sequence entry) is copied into the profile at its first site
+ * only, every later site becomes a YAML alias of that subtree. Memory then grows with the number of
+ * distinct fragments rather than with the number of references. Lookups, lists and iterators see
+ * through the aliases, `ut_kvp_getData()` emits them as anchors and aliases. Includes merged into
+ * a mapping by an `include` key are still copied, as their content becomes part of the mapping.
+ * A site at another depth than the first, or repeating a fragment cut short by the include depth
+ * or a cycle, is copied too, so the profile always reads the same as without the flag.
+ *
+ * With `UT_KVP_FLAG_CONCURRENT` set, the instance may be read from any number of threads while
+ * another thread opens, reloads or closes it. Getters read an immutable snapshot of the document
+ * through an atomic pointer and never block or write shared state, so read throughput scales with
+ * the number of cores. Every open, reload or close builds a complete new snapshot aside and
+ * publishes it in one atomic swap, writers are serialised against each other only. A write that
+ * fails leaves the published document in place, rather than closing the instance. A replaced
+ * snapshot is freed once no thread still reads it, tracked by one hazard pointer per thread, so
+ * strings and views returned to a thread stay valid until that thread next reads any concurrent
+ * instance. Compiled keys and iterators hold per-thread state, each must be used by one thread at a
+ * time, and an iterator ends when a new document is published.
+ *
+ * With `UT_KVP_FLAG_THREADSAFE` set, the instance may also be shared between threads, guarded by a
+ * reader-writer lock instead of snapshots. Every getter holds the lock shared for the duration of
+ * the call, opens, reloads, close and the include settings hold it exclusively, so a getter waits
+ * for a write in progress and the other way round. Values copied out by a getter, strings
+ * included, are consistent. Strings and views that point into the document stay valid only until
+ * the next write, so threads that read while another one re-opens the instance should use the
+ * copying getters. Compiled keys and iterators must be used by one thread at a time.
+ * `UT_KVP_FLAG_THREADSAFE` and `UT_KVP_FLAG_CONCURRENT` can't be combined.
+ *
+ * With `UT_KVP_FLAG_LAZY` set, `ut_kvp_open()` and `ut_kvp_openMapped()` map the profile and only
+ * scan it for the byte range of each top-level key. A section is parsed, and its includes
+ * expanded, the first time a getter reaches into it, so opening a large profile costs little more
+ * than reading it and a test pays only for the sections it reads. `ut_kvp_getData()`, iterating
+ * the root and `ut_kvp_compileImage()` parse every section left. A section that fails to parse, or
+ * whose includes run out of the include budget, is logged when first read. Getters reaching into it
+ * then return `UT_KVP_STATUS_PARSING_ERROR` or `UT_KVP_STATUS_TIMEOUT`, as a full open would have,
+ * where they report a status. The `UT_KVP_FLAG_INDEX` index is built once no section is left. Profiles the scan can't split safely, such as ones using anchors and aliases, holding
+ * several documents or a top-level `include`, or without a block mapping at the root, are opened
+ * in full as usual. As getters then modify the instance, `UT_KVP_FLAG_LAZY` can't be combined with
+ * `UT_KVP_FLAG_CONCURRENT` or `UT_KVP_FLAG_THREADSAFE`. Sections are expanded one at a time, each
+ * naming its own anchors, so it can't be combined with `UT_KVP_FLAG_SHARED_INCLUDES` either.
+ *
+ * @param[in] flags - Bitwise OR of `ut_kvp_flags_t` values.
+ *
+ * @returns Handle to the created KVP instance, or NULL on failure.
+ */
+ut_kvp_instance_t *ut_kvp_createInstanceWithFlags(uint32_t flags);
+
 /**!
  * @brief Destroys a KVP instance.
  * 
@@ -65,6 +176,22 @@ ut_kvp_instance_t *ut_kvp_createInstance(void);
  */
 void ut_kvp_destroyInstance(ut_kvp_instance_t *pInstance);
 
+/**!
+ * @brief Creates a copy of a KVP instance that shares its profile.
+ *
+ * The clone has the flags and include settings of `pInstance` and reads the same profile, without
+ * parsing or copying it. Both instances refer to one reference-counted document, which is never
+ * modified in place. An open, reload or close of either instance drops its own reference only,
+ * so the other keeps the profile it had, and the last instance to let go frees it. Cloning
+ * therefore costs the same for any size of profile. The clone starts without a watch, compiled
+ * keys and iterators belong to the instance they were created on.
+ *
+ * @param[in] pInstance - Handle to the instance to clone.
+ *
+ * @returns Handle to the new KVP instance, to be destroyed with `ut_kvp_destroyInstance()`, or NULL on failure.
+ */
+ut_kvp_instance_t *ut_kvp_clone(ut_kvp_instance_t *pInstance);
+
 /**!
  * @brief Opens and parses a Key-Value Pair (KVP) file into a KVP instance.
  *
@@ -78,6 +205,7 @@ void ut_kvp_destroyInstance(ut_kvp_instance_t *pInstance);
  * @retval UT_KVP_STATUS_FILE_OPEN_ERROR - The file could not be opened.
  * @retval UT_KVP_STATUS_INVALID_PARAM - One or more parameters are invalid (e.g., null pointer).
  * @retval UT_KVP_STATUS_PARSING_ERROR - An error occurred while parsing the file contents.
+ * @retval UT_KVP_STATUS_TIMEOUT - The includes were not fetched within the budget set by `ut_kvp_setIncludeTimeouts()`.
  * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
  */
 ut_kvp_status_t ut_kvp_open(ut_kvp_instance_t *pInstance, char *fileName);
@@ -96,10 +224,100 @@ ut_kvp_status_t ut_kvp_open(ut_kvp_instance_t *pInstance, char *fileName);
  * @retval UT_KVP_STATUS_SUCCESS - The file was opened and parsed successfully.
  * @retval UT_KVP_STATUS_INVALID_PARAM - One or more parameters are invalid (e.g., null pointer).
  * @retval UT_KVP_STATUS_PARSING_ERROR - An error occurred while parsing the file contents.
+ * @retval UT_KVP_STATUS_TIMEOUT - The includes were not fetched within the budget set by `ut_kvp_setIncludeTimeouts()`.
  * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
  */
 ut_kvp_status_t ut_kvp_openMemory(ut_kvp_instance_t *pInstance, char *pData, uint32_t length);
 
+/**!
+ * @brief Opens a Key-Value Pair (KVP) file by mapping it into memory, and parses it into a KVP instance.
+ *
+ * The file is parsed once, in place, straight from the page cache rather than from a heap copy,
+ * so processes opening the same profile share its pages. String values returned by the instance
+ * point into the mapping, which stays in place until the instance is closed or reopened.
+ * Any profile already held by the instance is replaced.
+ *
+ * @note The file must not be truncated while it is mapped.
+ *
+ * @param[in] pInstance - Handle to the KVP instance where the parsed data will be stored.
+ * @param[in] fileName - Null-terminated string containing the path to the KVP file.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The file was mapped and parsed successfully.
+ * @retval UT_KVP_STATUS_FILE_OPEN_ERROR - The file could not be opened or mapped.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - One or more parameters are invalid (e.g., null pointer).
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The file is empty or an error occurred while parsing it.
+ * @retval UT_KVP_STATUS_TIMEOUT - The includes were not fetched within the budget set by `ut_kvp_setIncludeTimeouts()`.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
+ */
+ut_kvp_status_t ut_kvp_openMapped(ut_kvp_instance_t *pInstance, char *fileName);
+
+/**!
+ * @brief Opens a profile from an include bundle, resolving its includes from the same file.
+ *
+ * A bundle is an uncompressed POSIX tar archive holding a profile and the files it includes,
+ * e.g. `tar --format=ustar -cf profile.tar profile.yaml include/`. The archive is mapped and its
+ * members indexed once, then every `!include` whose path names a member is parsed from the mapping
+ * without touching the filesystem or network. Includes not in the bundle are fetched as usual.
+ * Member names are matched as written in the include, a leading "./" is ignored on both sides.
+ * As with `ut_kvp_openMapped()`, the mapping stays in place until the instance is closed or reopened.
+ *
+ * @param[in] pInstance - Handle to the KVP instance where the parsed data will be stored.
+ * @param[in] fileName - Null-terminated string containing the path to the bundle.
+ * @param[in] pszProfile - Member to open as the profile, or NULL for the first file in the bundle.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The profile was opened and parsed successfully.
+ * @retval UT_KVP_STATUS_FILE_OPEN_ERROR - The bundle could not be mapped, or holds no member `pszProfile`.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - One or more parameters are invalid (e.g., null pointer).
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The bundle is not a tar archive, or an error occurred while parsing the profile.
+ * @retval UT_KVP_STATUS_TIMEOUT - The includes were not fetched within the budget set by `ut_kvp_setIncludeTimeouts()`.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
+ */
+ut_kvp_status_t ut_kvp_openBundle(ut_kvp_instance_t *pInstance, char *fileName, const char *pszProfile);
+
+/**!
+ * @brief Opens a compiled KVP image by mapping it into memory.
+ *
+ * An image is produced by `ut_kvp_compileImage()` (or the `ut-kvp-compile` tool) from a fully
+ * resolved profile. It holds a path-sorted entry table, the child lists of every mapping and
+ * sequence, and a string pool, with numeric and boolean values already parsed. Opening one
+ * only checks the header and section bounds, nothing is parsed, and lookups are a binary search.
+ * Any profile already held by the instance is replaced.
+ *
+ * @note `ut_kvp_getData()` is not available for an image, and the file must not be modified while it is mapped.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] fileName - Null-terminated string containing the path to the image file.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The image was mapped and validated successfully.
+ * @retval UT_KVP_STATUS_FILE_OPEN_ERROR - The file could not be opened or mapped.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - One or more parameters are invalid (e.g., null pointer).
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The file is not an image, was built by an incompatible version, or is corrupt.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
+ */
+ut_kvp_status_t ut_kvp_openImage(ut_kvp_instance_t *pInstance, char *fileName);
+
+/**!
+ * @brief Compiles the profile held by an instance into an image file for `ut_kvp_openImage()`.
+ *
+ * Includes, anchors and merge keys are resolved when the profile is opened, so the image holds
+ * the final document. The file is written alongside and renamed into place.
+ *
+ * @param[in] pInstance - Handle to an opened KVP instance.
+ * @param[in] fileName - Null-terminated string containing the path of the image to write.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The image was written successfully.
+ * @retval UT_KVP_STATUS_FILE_OPEN_ERROR - The image file could not be written.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - One or more parameters are invalid, or the profile is too large for an image.
+ * @retval UT_KVP_STATUS_NO_DATA - No profile is open.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The profile is empty.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
+ */
+ut_kvp_status_t ut_kvp_compileImage(ut_kvp_instance_t *pInstance, char *fileName);
+
 /**!
  * @brief Closes a previously opened KVP profile and frees its memory.
  * 
@@ -107,6 +325,133 @@ ut_kvp_status_t ut_kvp_openMemory(ut_kvp_instance_t *pInstance, char *pData, uin
  */
 void ut_kvp_close(ut_kvp_instance_t *pInstance);
 
+/**!
+ * @brief Starts watching the files of an open profile for changes.
+ *
+ * The profile and every local file it includes are watched with inotify. Nothing happens until
+ * `ut_kvp_reload()` is called, so a daemon can poll the returned descriptor for readability, or just
+ * call `ut_kvp_reload()` from time to time. URL includes and bundle members are not watched. Closing
+ * the instance, or an open that fails, stops watching.
+ *
+ * @param[in] pInstance - Handle to an instance opened with `ut_kvp_open()` or `ut_kvp_openMapped()`.
+ * @param[out] pFd - Filled in with a descriptor that becomes readable once a file changes, may be NULL.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The files are being watched.
+ * @retval UT_KVP_STATUS_NO_DATA - The instance holds no profile opened from a file.
+ * @retval UT_KVP_STATUS_FILE_OPEN_ERROR - The files could not be watched.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
+ */
+ut_kvp_status_t ut_kvp_watch(ut_kvp_instance_t *pInstance, int *pFd);
+
+/**!
+ * @brief Reloads a watched profile if any of its files have changed, without blocking.
+ *
+ * Only the files that changed are parsed again, every other include is taken from the include
+ * cache. The new profile is built aside and replaces the current one only once complete, so a
+ * profile saved half way, or one that no longer parses, leaves the current profile in place and
+ * is tried again on the next change. Compiled keys and iterators follow the new profile as they
+ * do after `ut_kvp_open()`. The files watched follow the includes of the reloaded profile.
+ *
+ * @param[in] pInstance - Handle to an instance being watched, see `ut_kvp_watch()`.
+ * @param[out] pReloaded - Set to true if the profile was replaced, may be NULL.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - Nothing changed, or the profile was reloaded.
+ * @retval UT_KVP_STATUS_NO_DATA - The instance is not being watched.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - A file changed but the profile could not be parsed, the current one is kept.
+ * @retval UT_KVP_STATUS_TIMEOUT - The includes were not fetched within the budget set by `ut_kvp_setIncludeTimeouts()`.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
+ */
+ut_kvp_status_t ut_kvp_reload(ut_kvp_instance_t *pInstance, bool *pReloaded);
+
+/**!
+ * @brief Bounds the time an instance may spend fetching includes.
+ *
+ * The budget is shared by every include of one open, nested ones included. Once it is spent,
+ * no further include is fetched, a URL include in progress is cut short, and the open fails
+ * with `UT_KVP_STATUS_TIMEOUT`. Each URL include is also bounded by its own connect and transfer
+ * timeouts, which only fail that include. New instances have no budget, a 10 second connect
+ * timeout and a 30 second transfer timeout.
+ *
+ * @param[in] pInstance - Handle to the instance.
+ * @param[in] budgetMs - Time every include of one open may take together, 0 for no limit.
+ * @param[in] connectTimeoutMs - Time to connect for one URL include, 0 for no limit.
+ * @param[in] transferTimeoutMs - Time for the whole of one URL include, 0 for no limit.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The limits apply from the next open.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
+ */
+ut_kvp_status_t ut_kvp_setIncludeTimeouts(ut_kvp_instance_t *pInstance, uint32_t budgetMs, uint32_t connectTimeoutMs, uint32_t transferTimeoutMs);
+
+/**!
+ * @brief Sets how deeply includes may nest.
+ *
+ * Every include is checked against the chain of files being expanded around it, by canonical path
+ * for files and by URL otherwise, so a cycle fails at its first repeat whatever the limit. The
+ * limit only bounds legitimate nesting, the profile itself being depth 0. New instances allow 5.
+ *
+ * @param[in] pInstance - Handle to the instance.
+ * @param[in] maxDepth - Deepest include allowed, at least 1.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The limit applies from the next open.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - `maxDepth` is 0 or too large.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - The provided `pInstance` is not a valid KVP instance.
+ */
+ut_kvp_status_t ut_kvp_setIncludeDepth(ut_kvp_instance_t *pInstance, uint32_t maxDepth);
+
+/**!
+ * @brief Reads the counters of the process-wide include cache.
+ *
+ * Every file or URL pulled in by an include is parsed once and kept, so later references from
+ * any instance copy the parsed tree instead of reading and parsing it again. Files are keyed by
+ * canonical path and are parsed again once their modification time or size changes. URLs are
+ * keyed by the URL as written and are revalidated with their server once per open, sending back
+ * the ETag or Last-Modified value it gave; a URL sent without either is downloaded again.
+ *
+ * @param[out] pStats - Filled in with the counters since start-up or the last `ut_kvp_clearIncludeCache()`.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The counters were read.
+ * @retval UT_KVP_STATUS_NULL_PARAM - `pStats` is NULL.
+ */
+ut_kvp_status_t ut_kvp_getIncludeCacheStats(ut_kvp_include_cache_stats_t *pStats);
+
+/**!
+ * @brief Drops every parsed include held by the process-wide include cache and resets its counters.
+ *
+ * Profiles already opened are unaffected, they hold their own copy of each include.
+ */
+void ut_kvp_clearIncludeCache(void);
+
+/**!
+ * @brief Sets a directory in which http(s) includes are kept between processes.
+ *
+ * Each downloaded include is stored with the ETag and Last-Modified values the server sent. When
+ * the include is next fetched, the request carries If-None-Match and If-Modified-Since, and on a
+ * 304 response the stored copy is used instead of downloading it again. Within a process, includes
+ * are also served by the include cache, see `ut_kvp_getIncludeCacheStats()`.
+ *
+ * @param[in] pszDirectory - Existing directory to use, or NULL to stop keeping URL includes.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The directory is in use.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - `pszDirectory` is not a directory, or its path is too long.
+ */
+ut_kvp_status_t ut_kvp_setUrlCacheDirectory(const char *pszDirectory);
+
+/**!
+ * @brief Selects whether http(s) includes may use the network.
+ *
+ * Offline, URL includes are served from the directory set by `ut_kvp_setUrlCacheDirectory()`
+ * without contacting the server, and an include that was never stored fails to open.
+ *
+ * @param[in] offline - true to stay off the network, false to fetch and revalidate as usual.
+ */
+void ut_kvp_setUrlOffline(bool offline);
+
 /**!
  * @brief Gets a boolean value from the KVP profile.
  * 
@@ -181,6 +526,48 @@ uint64_t ut_kvp_getUInt64Field(ut_kvp_instance_t *pInstance, const char *pszKey)
  */
 ut_kvp_status_t ut_kvp_getStringField( ut_kvp_instance_t *pInstance, const char *pszKey, char *pszReturnedString, uint32_t uStringSize );
 
+/**!
+ * @brief Retrieves a borrowed view of a string value from the KVP profile.
+ *
+ * No copy is made, `*ppString` points into the document's scalar storage. It is not null-terminated,
+ * use `*pLength`. The view stays valid until the instance is closed, re-opened or destroyed.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pszKey - Key of the string value to retrieve (null-terminated string).
+ * @param[out] ppString - Receives a pointer to the first character of the value.
+ * @param[out] pLength - Receives the length of the value in bytes.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The view was returned.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The key does not refer to a scalar value.
+ * @retval UT_KVP_STATUS_NO_DATA - The KVP instance does not contain any data.
+ * @retval UT_KVP_STATUS_KEY_NOT_FOUND - The specified key (`pszKey`) was not found in the KVP data.
+ * @retval UT_KVP_STATUS_NULL_PARAM - A null parameter was passed.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - An invalid KVP instance handle was passed.
+ */
+ut_kvp_status_t ut_kvp_getStringView( ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppString, size_t *pLength );
+
+/**!
+ * @brief Retrieves several values from the KVP profile in one call.
+ *
+ * Each descriptor is decoded as the single field getter for its type would decode it. Consecutive keys
+ * under the same parent share the walk to that parent, so ordering the descriptors by path is cheapest.
+ * A destination is only written when that descriptor's `status` is `UT_KVP_STATUS_SUCCESS`.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in,out] pFields - Array of field descriptors, `status` is filled in for each.
+ * @param[in] count - Number of descriptors in `pFields`.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - Every field was read.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - A value is not a scalar, or does not convert to its field's type.
+ * @retval UT_KVP_STATUS_NO_DATA - The KVP instance does not contain any data.
+ * @retval UT_KVP_STATUS_NULL_PARAM - `pFields` was NULL.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - An invalid KVP instance handle was passed.
+ * @retval Otherwise - The status of the first descriptor that failed.
+ */
+ut_kvp_status_t ut_kvp_getFields( ut_kvp_instance_t *pInstance, ut_kvp_field_t *pFields, uint32_t count );
+
 /**!
  * @brief Retrieves a float value from the KVP profile.
  *
@@ -232,6 +619,97 @@ char* ut_kvp_getData( ut_kvp_instance_t *pInstance );
  */
 uint32_t ut_kvp_getListCount( ut_kvp_instance_t *pInstance, const char *pszKey);
 
+/**!
+ * @brief Reads every element of a sequence of `uint32_t` values into a caller buffer.
+ *
+ * The sequence is walked once. Pass `maxCount` of 0 to query the number of elements.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pszKey - Key of the sequence (null-terminated string).
+ * @param[out] pValues - Buffer of `maxCount` elements, may be NULL when `maxCount` is 0.
+ * @param[in] maxCount - Number of elements `pValues` can hold.
+ * @param[out] pCount - Receives the number of elements in the sequence.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - Every element was read, or the count was returned.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - The buffer is too small, the first `maxCount` elements were read.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The key is not a sequence, or an element is not a scalar or not a valid number (it is set to 0).
+ * @retval UT_KVP_STATUS_NO_DATA - The KVP instance does not contain any data.
+ * @retval UT_KVP_STATUS_KEY_NOT_FOUND - The specified key (`pszKey`) was not found in the KVP data.
+ * @retval UT_KVP_STATUS_NULL_PARAM - A null parameter was passed.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - An invalid KVP instance handle was passed.
+ */
+ut_kvp_status_t ut_kvp_getUInt32Array( ut_kvp_instance_t *pInstance, const char *pszKey, uint32_t *pValues, uint32_t maxCount, uint32_t *pCount );
+
+/**!
+ * @brief Reads every element of a sequence of `uint64_t` values into a caller buffer.
+ *
+ * The sequence is walked once. Pass `maxCount` of 0 to query the number of elements.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pszKey - Key of the sequence (null-terminated string).
+ * @param[out] pValues - Buffer of `maxCount` elements, may be NULL when `maxCount` is 0.
+ * @param[in] maxCount - Number of elements `pValues` can hold.
+ * @param[out] pCount - Receives the number of elements in the sequence.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - Every element was read, or the count was returned.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - The buffer is too small, the first `maxCount` elements were read.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The key is not a sequence, or an element is not a scalar or not a valid number (it is set to 0).
+ * @retval UT_KVP_STATUS_NO_DATA - The KVP instance does not contain any data.
+ * @retval UT_KVP_STATUS_KEY_NOT_FOUND - The specified key (`pszKey`) was not found in the KVP data.
+ * @retval UT_KVP_STATUS_NULL_PARAM - A null parameter was passed.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - An invalid KVP instance handle was passed.
+ */
+ut_kvp_status_t ut_kvp_getUInt64Array( ut_kvp_instance_t *pInstance, const char *pszKey, uint64_t *pValues, uint32_t maxCount, uint32_t *pCount );
+
+/**!
+ * @brief Reads every element of a sequence of `double` values into a caller buffer.
+ *
+ * The sequence is walked once. Pass `maxCount` of 0 to query the number of elements.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pszKey - Key of the sequence (null-terminated string).
+ * @param[out] pValues - Buffer of `maxCount` elements, may be NULL when `maxCount` is 0.
+ * @param[in] maxCount - Number of elements `pValues` can hold.
+ * @param[out] pCount - Receives the number of elements in the sequence.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - Every element was read, or the count was returned.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - The buffer is too small, the first `maxCount` elements were read.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The key is not a sequence, or an element is not a scalar or not a valid number (it is set to 0).
+ * @retval UT_KVP_STATUS_NO_DATA - The KVP instance does not contain any data.
+ * @retval UT_KVP_STATUS_KEY_NOT_FOUND - The specified key (`pszKey`) was not found in the KVP data.
+ * @retval UT_KVP_STATUS_NULL_PARAM - A null parameter was passed.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - An invalid KVP instance handle was passed.
+ */
+ut_kvp_status_t ut_kvp_getDoubleArray( ut_kvp_instance_t *pInstance, const char *pszKey, double *pValues, uint32_t maxCount, uint32_t *pCount );
+
+/**!
+ * @brief Reads every element of a sequence of strings as borrowed views into a caller buffer.
+ *
+ * The sequence is walked once. Pass `maxCount` of 0 to query the number of elements. As with
+ * `ut_kvp_getStringView()` nothing is copied, each string is a pointer and length into the document
+ * that stays valid until the instance is closed.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pszKey - Key of the sequence (null-terminated string).
+ * @param[out] ppStrings - Buffer of `maxCount` elements, may be NULL when `maxCount` is 0.
+ * @param[out] pLengths - Buffer of `maxCount` lengths, one per string, may be NULL when `maxCount` is 0.
+ * @param[in] maxCount - Number of elements `ppStrings` and `pLengths` can hold.
+ * @param[out] pCount - Receives the number of elements in the sequence.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - Every element was read, or the count was returned.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - The buffer is too small, the first `maxCount` elements were read.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The key is not a sequence, or an element is not a scalar (it is set to NULL).
+ * @retval UT_KVP_STATUS_NO_DATA - The KVP instance does not contain any data.
+ * @retval UT_KVP_STATUS_KEY_NOT_FOUND - The specified key (`pszKey`) was not found in the KVP data.
+ * @retval UT_KVP_STATUS_NULL_PARAM - A null parameter was passed.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - An invalid KVP instance handle was passed.
+ */
+ut_kvp_status_t ut_kvp_getStringArray( ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppStrings, size_t *pLengths, uint32_t maxCount, uint32_t *pCount );
+
 /**
  * @brief Retrieves the data bytes associated with a given key from a key-value pair instance.
  *
@@ -254,6 +732,280 @@ uint32_t ut_kvp_getListCount( ut_kvp_instance_t *pInstance, const char *pszKey);
  */
 unsigned char* ut_kvp_getDataBytes(ut_kvp_instance_t *pInstance, const char *pszKey, int *size);
 
+/**!
+ * @brief Decodes the data bytes associated with a key into a caller supplied buffer.
+ *
+ * Accepts the same hex ("0x"/"0X" prefixed) and decimal byte lists, separated by spaces and/or commas,
+ * as `ut_kvp_getDataBytes()`. Nothing is allocated, and the call is safe to make from several threads
+ * reading the same open instance. Pass a NULL `pBuffer` and 0 `bufferSize` to query the decoded size.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pszKey - Null-terminated string representing the key to search for.
+ * @param[out] pBuffer - Buffer receiving the decoded bytes, may be NULL when `bufferSize` is 0.
+ * @param[in] bufferSize - Size of `pBuffer` in bytes.
+ * @param[out] pSize - Receives the number of bytes the value decodes to.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The bytes were decoded, or the size was returned.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - `pBuffer` is too small, `*pSize` holds the size required.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The value is not a scalar or holds an invalid byte.
+ * @retval UT_KVP_STATUS_NO_DATA - The KVP instance does not contain any data.
+ * @retval UT_KVP_STATUS_KEY_NOT_FOUND - The specified key (`pszKey`) was not found in the KVP data.
+ * @retval UT_KVP_STATUS_NULL_PARAM - A null parameter was passed.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - An invalid KVP instance handle was passed.
+ */
+ut_kvp_status_t ut_kvp_getDataBytesToBuffer(ut_kvp_instance_t *pInstance, const char *pszKey, unsigned char *pBuffer, uint32_t bufferSize, uint32_t *pSize);
+
+/**!
+ * @brief Compiles a key into a handle for repeated lookups.
+ *
+ * The key is converted and stored once. The node it refers to is resolved on first use and cached
+ * in the handle, so repeated reads through the `ByHandle` getters skip key conversion and the
+ * walk from the document root. The cache is invalidated whenever the instance is opened or closed,
+ * and the node is then resolved again on next use.
+ *
+ * @param[in] pInstance - Handle to the KVP instance the key will be used with.
+ * @param[in] pszKey - Null-terminated string representing the key, in either dot or slash notation.
+ *
+ * @returns Handle to the compiled key, or NULL on failure (check logs for details).
+ *
+ * @note The handle must be released with `ut_kvp_freeKey()`.
+ */
+ut_kvp_key_t *ut_kvp_compileKey(ut_kvp_instance_t *pInstance, const char *pszKey);
+
+/**!
+ * @brief Releases a key handle created by `ut_kvp_compileKey()`.
+ *
+ * @param[in] pKey - Handle to the compiled key to release.
+ */
+void ut_kvp_freeKey(ut_kvp_key_t *pKey);
+
+/**!
+ * @brief Gets a boolean value from the KVP profile using a compiled key.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pKey - Handle to a key compiled against `pInstance`.
+ *
+ * @returns `true` if the key is found and its value is "true", `false` otherwise.
+ */
+bool ut_kvp_getBoolByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey);
+
+/**!
+ * @brief Gets a uint8_t value from the KVP profile using a compiled key.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pKey - Handle to a key compiled against `pInstance`.
+ *
+ * @returns The `uint8_t` value on success, or 0 on error (check logs for details).
+ */
+uint8_t ut_kvp_getUInt8ByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey);
+
+/**!
+ * @brief Gets a uint16_t value from the KVP profile using a compiled key.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pKey - Handle to a key compiled against `pInstance`.
+ *
+ * @returns The `uint16_t` value on success, or 0 on error (check logs for details).
+ */
+uint16_t ut_kvp_getUInt16ByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey);
+
+/**!
+ * @brief Gets a uint32_t value from the KVP profile using a compiled key.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pKey - Handle to a key compiled against `pInstance`.
+ *
+ * @returns The `uint32_t` value on success, or 0 on error (check logs for details).
+ */
+uint32_t ut_kvp_getUInt32ByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey);
+
+/**!
+ * @brief Gets a uint64_t value from the KVP profile using a compiled key.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pKey - Handle to a key compiled against `pInstance`.
+ *
+ * @returns The `uint64_t` value on success, or 0 on error (check logs for details).
+ */
+uint64_t ut_kvp_getUInt64ByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey);
+
+/**!
+ * @brief Gets a float value from the KVP profile using a compiled key.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pKey - Handle to a key compiled against `pInstance`.
+ *
+ * @returns The `float` value on success, or 0 on error (check logs for details).
+ */
+float ut_kvp_getFloatByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey);
+
+/**!
+ * @brief Gets a double value from the KVP profile using a compiled key.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pKey - Handle to a key compiled against `pInstance`.
+ *
+ * @returns The `double` value on success, or 0 on error (check logs for details).
+ */
+double ut_kvp_getDoubleByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey);
+
+/**!
+ * @brief Retrieves a string value from the KVP profile using a compiled key.
+ *
+ * Behaves as `ut_kvp_getStringField()`, with the key supplied as a compiled handle.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pKey - Handle to a key compiled against `pInstance`.
+ * @param[out] pszReturnedString - Pre-allocated buffer to store the retrieved string.
+ * @param[in] uStringSize - Size of the `pszReturnedString` buffer (including space for the null-terminator).
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - String value was found and successfully copied to `pszReturnedString`.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The key does not refer to a scalar value.
+ * @retval UT_KVP_STATUS_NO_DATA - The KVP instance does not contain any data.
+ * @retval UT_KVP_STATUS_KEY_NOT_FOUND - The key was not found in the KVP data.
+ * @retval UT_KVP_STATUS_NULL_PARAM - A null parameter was passed.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - The key handle is invalid or was compiled against another instance.
+ * @retval UT_KVP_STATUS_INVALID_INSTANCE - An invalid KVP instance handle was passed.
+ */
+ut_kvp_status_t ut_kvp_getStringByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey, char *pszReturnedString, uint32_t uStringSize);
+
+/**!
+ * @brief Starts iterating over the children of a mapping or sequence.
+ *
+ * The cursor starts before the first child, call `ut_kvp_iteratorNext()` to move onto it. Each step
+ * follows the document's own child links, so a whole list is read in a single pass rather than one
+ * walk from the head per element.
+ *
+ * The iterator must be released with `ut_kvp_iteratorEnd()` before the instance is destroyed. Opening
+ * or closing the instance ends the iteration, `ut_kvp_iteratorNext()` then returns false.
+ *
+ * @param[in] pInstance - Handle to the KVP instance.
+ * @param[in] pszKey - Key of the mapping or sequence (null-terminated string).
+ *
+ * @returns Handle to the iterator, or NULL if the key is not found or is a scalar (check logs for details).
+ */
+ut_kvp_iterator_t *ut_kvp_iteratorBegin(ut_kvp_instance_t *pInstance, const char *pszKey);
+
+/**!
+ * @brief Moves the iterator onto the next child.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns true if the iterator is on a child, false once the children are exhausted or on error.
+ */
+bool ut_kvp_iteratorNext(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Releases an iterator.
+ *
+ * @param[in] pIterator - Handle to the iterator to release.
+ */
+void ut_kvp_iteratorEnd(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets the position of the current child, counting from 0.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns The position of the current child, or 0 on error (check logs for details).
+ */
+uint32_t ut_kvp_iteratorGetIndex(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets a borrowed view of the current child's key name, when iterating a mapping.
+ *
+ * The name is not null-terminated and stays valid until the instance is closed.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ * @param[out] pLength - Receives the length of the name in bytes.
+ *
+ * @returns Pointer to the name, or NULL when iterating a sequence or on error.
+ */
+const char *ut_kvp_iteratorGetName(ut_kvp_iterator_t *pIterator, size_t *pLength);
+
+/**!
+ * @brief Gets the current child as a boolean value.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns true if the value is "true", false otherwise or on error.
+ */
+bool ut_kvp_iteratorGetBool(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets the current child as a uint8_t value.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns The `uint8_t` value on success, or 0 on error (check logs for details).
+ */
+uint8_t ut_kvp_iteratorGetUInt8(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets the current child as a uint16_t value.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns The `uint16_t` value on success, or 0 on error (check logs for details).
+ */
+uint16_t ut_kvp_iteratorGetUInt16(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets the current child as a uint32_t value.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns The `uint32_t` value on success, or 0 on error (check logs for details).
+ */
+uint32_t ut_kvp_iteratorGetUInt32(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets the current child as a uint64_t value.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns The `uint64_t` value on success, or 0 on error (check logs for details).
+ */
+uint64_t ut_kvp_iteratorGetUInt64(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets the current child as a float value.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns The `float` value on success, or 0 on error (check logs for details).
+ */
+float ut_kvp_iteratorGetFloat(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets the current child as a double value.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ *
+ * @returns The `double` value on success, or 0 on error (check logs for details).
+ */
+double ut_kvp_iteratorGetDouble(ut_kvp_iterator_t *pIterator);
+
+/**!
+ * @brief Gets a borrowed view of the current child's string value.
+ *
+ * Behaves as `ut_kvp_getStringView()` for the current child.
+ *
+ * @param[in] pIterator - Handle to the iterator.
+ * @param[out] ppString - Receives a pointer to the first character of the value.
+ * @param[out] pLength - Receives the length of the value in bytes.
+ *
+ * @returns Status of the operation (`ut_kvp_status_t`):
+ * @retval UT_KVP_STATUS_SUCCESS - The view was returned.
+ * @retval UT_KVP_STATUS_PARSING_ERROR - The current child is not a scalar value.
+ * @retval UT_KVP_STATUS_NO_DATA - The iterator is not on a child, or the instance was re-opened or closed.
+ * @retval UT_KVP_STATUS_NULL_PARAM - A null parameter was passed.
+ * @retval UT_KVP_STATUS_INVALID_PARAM - The iterator handle is invalid.
+ */
+ut_kvp_status_t ut_kvp_iteratorGetStringView(ut_kvp_iterator_t *pIterator, const char **ppString, size_t *pLength);
+
 /* TODO:
  * - Implement functions for getting signed integer values (`ut_kvp_getInt8Field`, `ut_kvp_getInt16Field`, `ut_kvp_getInt32Field`,
  *`ut_kvp_getInt64Field`
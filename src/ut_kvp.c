@@ -20,9 +20,16 @@
 /* Standard Libraries */
 #include <errno.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
 #include <limits.h>
 #include <unistd.h>
 #include <assert.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <pthread.h>
 #include <curl/curl.h>
 
 /* Application Includes */
@@ -35,14 +42,341 @@
 ut_kvp_instance_t *gKVP_Instance = NULL;
 
 #define UT_KVP_MAGIC (0xdeadbeef)
-#define UT_KVP_MAX_INCLUDE_DEPTH 5
+#define UT_KVP_KEY_MAGIC (0xbeefcafe)
+#define UT_KVP_ITERATOR_MAGIC (0xcafef00d)
+#define UT_KVP_DEFAULT_INCLUDE_DEPTH (5)     /* Nesting allowed by default, see ut_kvp_setIncludeDepth() */
+#define UT_KVP_MAX_NUMBER_SIZE (64)     /* Longest numeric scalar accepted by the float/double getters */
+#define UT_KVP_INDEX_INITIAL_CAPACITY (64)  /* Must be a power of two */
+#define UT_KVP_ARENA_BLOCK_SIZE (16 * 1024)     /* First arena block, later blocks double up to the maximum */
+#define UT_KVP_ARENA_MAX_BLOCK_SIZE (1024 * 1024)
+#define UT_KVP_ARENA_ALIGNMENT (sizeof(uint64_t))
+#define UT_KVP_INCLUDE_CACHE_MAX_ENTRIES (64)   /* Parsed includes kept process-wide, least recently used are dropped */
+#define UT_KVP_INCLUDE_WORKERS (4)      /* Threads fetching includes for UT_KVP_FLAG_PARALLEL_INCLUDES */
+#define UT_KVP_URL_CACHE_MAGIC "ut-kvp-url-cache-1"
+#define UT_KVP_URL_VALIDATOR_SIZE (256)     /* Longer ETag or Last-Modified values are not kept */
+#define UT_KVP_DEFAULT_CONNECT_TIMEOUT_MS (10000)
+#define UT_KVP_DEFAULT_TRANSFER_TIMEOUT_MS (30000)
+#define UT_KVP_BUNDLE_BLOCK_SIZE (512)      /* tar header and data alignment */
+#define UT_KVP_BUNDLE_NAME_SIZE (100)       /* tar member name field */
+#define UT_KVP_IMAGE_MAGIC (0x494b5455)     /* "UTKI" */
+#define UT_KVP_IMAGE_VERSION (1)
+#define UT_KVP_IMAGE_BYTE_ORDER (0x01020304)
+#define UT_KVP_IMAGE_ALIGNMENT (8)          /* Entry table alignment, for its 64 bit members */
+
+#define UT_KVP_IMAGE_FLAG_NAMED (1 << 0)    /* nameOffset/nameLength hold the entry's mapping key */
+#define UT_KVP_IMAGE_FLAG_UINT (1 << 1)     /* uValue holds the scalar parsed as an unsigned integer */
+#define UT_KVP_IMAGE_FLAG_DOUBLE (1 << 2)   /* dValue and fValue hold the scalar parsed as floating point */
+#define UT_KVP_IMAGE_FLAG_TRUE (1 << 3)     /* The scalar reads as boolean true */
+#define UT_KVP_CACHE_LINE_SIZE (64)         /* Hazard pointers of different threads never share a line */
+
+// Struct to store a single slot of the path index
+typedef struct
+{
+    uint32_t hash;
+    uint32_t keyLength;
+    const char *pKey;       /* Path, not terminated, held in the instance arena */
+    struct fy_node *node;   /* NULL marks an empty slot */
+} ut_kvp_index_entry_t;
+
+// Struct to store one block of an instance arena
+typedef struct ut_kvp_arena_block_s
+{
+    struct ut_kvp_arena_block_s *pNext;
+    size_t size;
+    size_t used;
+    unsigned char *pData;   /* Follows the header in the same allocation */
+} ut_kvp_arena_block_t;
+
+// Struct to store a bump allocator whose allocations are only ever released together
+typedef struct
+{
+    ut_kvp_arena_block_t *pBlocks;  /* Most recent block first, allocations are carved from it */
+    size_t nextBlockSize;
+} ut_kvp_arena_t;
+
+// Struct to store an open-addressing hash table from full slash-path to node
+typedef struct
+{
+    ut_kvp_index_entry_t *pEntries;
+    uint32_t capacity;
+    uint32_t count;
+    ut_kvp_arena_t *pArena; /* Slots and paths are allocated from the owning instance's arena */
+} ut_kvp_index_t;
+
+// Kinds of entry held in a compiled image
+typedef enum
+{
+    UT_KVP_IMAGE_KIND_NULL = 0,     /* Mapping key without a value, only visited by iterators */
+    UT_KVP_IMAGE_KIND_SCALAR,
+    UT_KVP_IMAGE_KIND_MAPPING,
+    UT_KVP_IMAGE_KIND_SEQUENCE
+} ut_kvp_image_kind_t;
+
+// Struct to store the header of a compiled image, every offset is from the start of the image
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t byteOrder;         /* UT_KVP_IMAGE_BYTE_ORDER as written by the compiling host */
+    uint32_t entrySize;
+    uint32_t entryCount;
+    uint32_t childCount;
+    uint32_t poolSize;
+    uint32_t entriesOffset;     /* Entries, sorted by path */
+    uint32_t childrenOffset;    /* Entry indices of each container's children, in document order */
+    uint32_t poolOffset;        /* Zero terminated paths and scalar text */
+    uint32_t imageSize;
+    uint32_t reserved;
+} ut_kvp_image_header_t;
+
+// Struct to store one path of a compiled image, fixed width fields only so the layout matches across targets
+typedef struct
+{
+    uint64_t uValue;
+    double dValue;
+    float fValue;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t valueOffset;
+    uint32_t valueLength;
+    uint32_t firstChild;
+    uint32_t childCount;
+    uint8_t kind;               /* ut_kvp_image_kind_t */
+    uint8_t flags;              /* UT_KVP_IMAGE_FLAG_xxx */
+    uint16_t reserved;
+} ut_kvp_image_entry_t;
+
+// Struct to store the sections of an image mapped by ut_kvp_openImage()
+typedef struct
+{
+    const ut_kvp_image_header_t *pHeader;   /* NULL unless the instance holds an image */
+    const ut_kvp_image_entry_t *pEntries;
+    const uint32_t *pChildren;
+    const char *pPool;
+} ut_kvp_image_t;
+
+// Struct to store an image while ut_kvp_compileImage() builds it, entries are in document order
+typedef struct
+{
+    ut_kvp_image_entry_t *pEntries;
+    uint32_t entryCount;
+    uint32_t entryCapacity;
+    uint32_t *pChildren;
+    uint32_t childCount;
+    uint32_t childCapacity;
+    char *pPool;
+    size_t poolSize;
+    size_t poolUsed;
+} ut_kvp_image_builder_t;
+
+// Struct to store an entry's sort key while the image is ordered by path
+typedef struct
+{
+    const char *pPath;
+    uint32_t length;
+    uint32_t index;
+} ut_kvp_image_sort_t;
+
+// Struct to store one directory watched for changes to the files of a profile
+typedef struct
+{
+    int wd;
+    char *pszDir;
+} ut_kvp_watch_dir_t;
+
+// Struct to store the files behind an open profile and the inotify watches on them, see ut_kvp_watch()
+typedef struct
+{
+    int fd;                     /* inotify descriptor, -1 when not watching */
+    char **ppFiles;             /* Canonical paths of the profile and of every file it included */
+    uint32_t fileCount;
+    bool hasSource;             /* ppFiles[0] is the profile itself, parsed again by a reload */
+    ut_kvp_watch_dir_t *pDirs;
+    uint32_t dirCount;
+} ut_kvp_watch_t;
+
+// Struct to store the last parent resolved by ut_kvp_getFields(), shared by sibling keys
+typedef struct
+{
+    char zPath[UT_KVP_MAX_ELEMENT_SIZE];
+    size_t length;
+    bool valid;
+    struct fy_node *node;
+} ut_kvp_parent_cache_t;
+
+// Struct to store the snapshots of a UT_KVP_FLAG_CONCURRENT instance
+typedef struct
+{
+    struct ut_kvp_instance_internal_s *pCurrent;    /* Read by getters without a lock, replaced by an atomic swap */
+    pthread_mutex_t writeLock;                      /* Serialises writers only, readers never take it */
+    struct ut_kvp_instance_internal_s **ppRetired;  /* Replaced snapshots a reader may still hold */
+    uint32_t retiredCount;
+    uint32_t retiredCapacity;
+} ut_kvp_publish_t;
+
+// Struct to store a document shared by an instance and its clones, see ut_kvp_clone()
+typedef struct
+{
+    uint32_t refCount;              /* Instances referring to the document, the last one to let go frees it */
+    struct fy_document *fy_handle;
+    void *pMapped;                  /* Mapping the document or image points into */
+    size_t mappedSize;
+    ut_kvp_arena_t arena;           /* Holds the index every sharer refers to */
+} ut_kvp_shared_t;
 
+// Struct to store one top-level section of a profile opened with UT_KVP_FLAG_LAZY
+typedef struct
+{
+    size_t offset;          /* Byte range of the section in the profile text, from its key line on */
+    size_t length;
+    size_t keyLength;       /* Key as written, quotes included */
+    const char *pName;      /* Key as parsed, points into the document */
+    size_t nameLength;
+    struct fy_node_pair *pair;  /* Holds a null value until the section is parsed */
+    bool parsed;
+    ut_kvp_status_t status;     /* Why the section could not be parsed, reported by every getter reaching into it */
+} ut_kvp_lazy_section_t;
+
+// Struct to store the sections of a lazily opened profile, see lazyTouch()
 typedef struct
+{
+    const char *pText;      /* The mapped profile, sections are parsed from it in place */
+    char *pszSource;        /* Profile file, where the include chain of every section starts */
+    ut_kvp_lazy_section_t *pSections;   /* Sorted by name */
+    uint32_t sectionCount;
+    uint32_t pending;       /* Sections not parsed yet, the document is complete at 0 */
+    uint32_t failed;        /* Sections that could not be parsed */
+} ut_kvp_lazy_t;
+
+typedef struct ut_kvp_instance_internal_s
 {
     uint32_t magic;
     struct fy_document *fy_handle;
+    uint32_t generation;    /* Bumped on every open/close, invalidates compiled key caches */
+    uint32_t flags;
+    ut_kvp_arena_t arena;   /* Storage derived from the open document, released in one step on close */
+    ut_kvp_index_t index;
+    void *pMapped;          /* Profile mapped by ut_kvp_openMapped() or ut_kvp_openImage(), scalars point into it until close */
+    size_t mappedSize;
+    ut_kvp_image_t image;
+    uint32_t includeBudgetMs;       /* Time every include of one open may take together, 0 for no limit */
+    uint32_t connectTimeoutMs;      /* Per URL include, 0 for no limit */
+    uint32_t transferTimeoutMs;
+    uint32_t maxIncludeDepth;       /* Includes nested deeper than this fail */
+    ut_kvp_watch_t watch;
+    ut_kvp_publish_t publish;       /* UT_KVP_FLAG_CONCURRENT only, the document lives in publish.pCurrent */
+    pthread_rwlock_t lock;          /* UT_KVP_FLAG_THREADSAFE only, shared by getters and exclusive for writers */
+    uint32_t writeDepth;            /* Writes nested inside the one holding lock, touched by that thread only */
+    struct ut_kvp_instance_internal_s *pOwner;     /* Instance a snapshot was published by, NULL for any other */
+    ut_kvp_shared_t *pShared;       /* Set once the document is shared with a clone, it then owns the storage */
+    ut_kvp_lazy_t lazy;             /* UT_KVP_FLAG_LAZY only */
 } ut_kvp_instance_internal_t;
 
+// Struct to store a compiled key and its cached node
+typedef struct
+{
+    uint32_t magic;
+    ut_kvp_instance_internal_t *pInternal;  /* The instance handle, not a snapshot of it */
+    uint32_t generation;    /* Instance generation the cached node was resolved against */
+    bool resolved;
+    struct fy_node *node;
+    const ut_kvp_image_entry_t *pEntry;     /* Cached instead of node when the instance holds an image */
+    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
+} ut_kvp_key_internal_t;
+
+// Struct to store an iterator over the children of a mapping or sequence
+typedef struct
+{
+    uint32_t magic;
+    ut_kvp_instance_internal_t *pInternal;  /* The instance handle, not a snapshot of it */
+    uint32_t generation;    /* Instance generation the container was resolved against */
+    struct fy_node *container;
+    void *iter;             /* libfyaml iteration state */
+    struct fy_node *key;    /* Key of the current child, NULL for sequences */
+    struct fy_node *child;  /* Current child, NULL before the first and after the last */
+    uint32_t index;
+    bool done;              /* Set once the children are exhausted, libfyaml would restart from the head */
+    const ut_kvp_image_entry_t *pContainerEntry;    /* Used instead of container/child for an image */
+    const ut_kvp_image_entry_t *pChildEntry;
+} ut_kvp_iterator_internal_t;
+
+// Struct to store a child to be replaced or removed once its container has been walked
+typedef struct
+{
+    void *pChild;                   /* struct fy_node_pair * in a mapping, struct fy_node * in a sequence */
+    struct fy_node *replacement;    /* Merged into a mapping or put in place in a sequence, NULL just removes */
+} ut_kvp_include_edit_t;
+
+// Struct to store a mapping pair taken out while the includes of its mapping are merged
+typedef struct
+{
+    struct fy_node_pair *pair;
+    struct fy_node *key;            /* Copy of the pair's key, NULL for an include or a pair left in place */
+    struct fy_node *value;          /* The pair's value, or the included mapping to merge */
+} ut_kvp_include_move_t;
+
+// Struct to store an include expanded once and referenced from its other sites, see UT_KVP_FLAG_SHARED_INCLUDES
+typedef struct
+{
+    char *pszName;              /* As written at the include site */
+    int depth;                  /* Depth it was expanded at, sites at other depths could reach a different limit and copy instead */
+    bool complete;              /* No include inside it was left out for the depth limit or a cycle */
+    char zAnchor[32];
+} ut_kvp_include_share_t;
+
+// Struct to store one file held in an include bundle
+typedef struct
+{
+    const char *pName;      /* Not terminated, leading "./" removed */
+    size_t nameLength;
+    const char *pData;      /* Points into the mapped bundle */
+    size_t size;
+} ut_kvp_bundle_member_t;
+
+// Struct to store the index of an include bundle, members sorted by name
+typedef struct
+{
+    ut_kvp_bundle_member_t *pMembers;
+    uint32_t count;
+    const ut_kvp_bundle_member_t *pFirst;   /* First file in archive order, the default profile */
+} ut_kvp_bundle_t;
+
+// Struct to store what an include resolves to, found once by includeChainPush() for includeCacheCopy()
+typedef struct
+{
+    const ut_kvp_bundle_member_t *pMember;  /* Member of the bundle being opened, nothing else is set then */
+    const char *pszKey;                     /* Canonical path or URL, the include cache key */
+    char zPath[PATH_MAX];
+    struct stat fileStat;
+    bool isFile;
+} ut_kvp_include_target_t;
+
+// Struct to store the limits and state shared by every include expanded for one open
+typedef struct
+{
+    uint64_t deadlineMs;            /* CLOCK_MONOTONIC time the includes must be done by, 0 for none */
+    uint32_t connectTimeoutMs;
+    uint32_t transferTimeoutMs;
+    bool expired;                   /* Set once an include finds the budget spent, fails the open */
+    int maxDepth;
+    char **ppChain;                 /* Canonical names of the files being expanded, outermost first */
+    uint32_t chainLength;
+    uint32_t chainCapacity;
+    char **ppFiles;                 /* Every local file read, profile first, handed to the instance for ut_kvp_watch() */
+    uint32_t fileCount;
+    uint32_t fileCapacity;
+    const ut_kvp_bundle_t *pBundle; /* Resolves includes ahead of the filesystem, NULL outside ut_kvp_openBundle() */
+    bool share;                     /* UT_KVP_FLAG_SHARED_INCLUDES */
+    uint32_t shareSuspended;        /* Non-zero while expanding content that is merged, and so copied, into a mapping */
+    uint32_t leftOut;               /* Includes left out for the depth limit or a cycle so far */
+    ut_kvp_include_share_t *pShared;
+    uint32_t sharedCount;
+    uint32_t sharedCapacity;
+    uint64_t openSerial;            /* From gIncludeCache.opens, tells a URL revalidated by this open from a stale one */
+} ut_kvp_include_context_t;
+
 // Struct to store the downloaded data
 typedef struct
 {
@@ -50,22 +384,287 @@ typedef struct
     size_t size;
 } ut_kvp_download_memory_internal_t;
 
+// Struct to store the validators a server sent with a URL include
+typedef struct
+{
+    char zETag[UT_KVP_URL_VALIDATOR_SIZE];
+    char zLastModified[UT_KVP_URL_VALIDATOR_SIZE];
+} ut_kvp_url_validators_t;
+
+// Struct to store a parsed include, shared by every instance in the process
+typedef struct ut_kvp_include_cache_entry_s
+{
+    struct ut_kvp_include_cache_entry_s *pNext;    /* Most recently used first */
+    char *pszKey;                   /* Canonical path of a file, or the URL as written */
+    bool isFile;
+    struct timespec mtime;          /* Modification time and size the file had when parsed */
+    off_t size;
+    ut_kvp_url_validators_t validators; /* What the server sent with a URL, sent back to revalidate it */
+    uint64_t openSerial;            /* Open a URL was last revalidated for */
+    struct fy_document *pDocument;  /* As parsed, its includes are expanded in each copy */
+} ut_kvp_include_cache_entry_t;
+
+// Struct to store the process-wide include cache
+typedef struct
+{
+    pthread_mutex_t lock;
+    ut_kvp_include_cache_entry_t *pEntries;
+    uint32_t count;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t opens;                 /* Numbers each open, URL entries are revalidated once per open */
+} ut_kvp_include_cache_t;
+
+static ut_kvp_include_cache_t gIncludeCache = { PTHREAD_MUTEX_INITIALIZER, NULL, 0, 0, 0, 0 };
+static pthread_once_t gCurlInitOnce = PTHREAD_ONCE_INIT;
+
+// Struct to store where URL includes are kept on disk, and whether the network may be used
+typedef struct
+{
+    pthread_mutex_t lock;
+    char zDirectory[PATH_MAX];  /* Empty when URL includes are not kept */
+    bool offline;
+} ut_kvp_url_cache_t;
+
+static ut_kvp_url_cache_t gUrlCache = { PTHREAD_MUTEX_INITIALIZER, { 0 }, false };
+
+static CURLSH *gpCurlShare = NULL;     /* DNS and TLS session caches shared by every URL include */
+static pthread_mutex_t gCurlShareLocks[CURL_LOCK_DATA_LAST];
+
+// Struct to store idle curl handles, each keeps the connections it opened for its next fetch
+typedef struct
+{
+    pthread_mutex_t lock;
+    CURL *pHandles[UT_KVP_INCLUDE_WORKERS];
+    uint32_t count;
+} ut_kvp_curl_pool_t;
+
+static ut_kvp_curl_pool_t gCurlPool = { PTHREAD_MUTEX_INITIALIZER, { NULL }, 0 };
+
+// Struct to store an include to be fetched ahead of expansion
+typedef struct
+{
+    char *pszName;      /* File or URL as written in the profile */
+    int depth;          /* Depth process_include() will see it at */
+} ut_kvp_prefetch_job_t;
+
+// Struct to store the work shared by the include prefetch threads
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t wake;            /* Signalled when a job is added or a worker goes idle */
+    ut_kvp_prefetch_job_t *pJobs;   /* Every include seen, in discovery order, never removed */
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t next;                  /* First job not yet taken */
+    uint32_t busy;                  /* Workers fetching, which may still add jobs */
+    ut_kvp_include_context_t *pContext;     /* Of the open, only touched with the lock held */
+} ut_kvp_prefetch_t;
+
+// Struct to store one thread's hazard pointer, the snapshot it may be reading
+typedef struct ut_kvp_hazard_s
+{
+    ut_kvp_instance_internal_t *pSnapshot;  /* Written by its thread only, scanned by writers */
+    bool inUse;                             /* Cleared when the thread exits, so the slot is reused */
+    struct ut_kvp_hazard_s *pNext;
+} __attribute__((aligned(UT_KVP_CACHE_LINE_SIZE))) ut_kvp_hazard_t;
+
+// Enum of the writes replayed on a fresh snapshot of a UT_KVP_FLAG_CONCURRENT instance
+typedef enum
+{
+    UT_KVP_PUBLISH_OPEN = 0,
+    UT_KVP_PUBLISH_OPEN_MEMORY,
+    UT_KVP_PUBLISH_OPEN_MAPPED,
+    UT_KVP_PUBLISH_OPEN_BUNDLE,
+    UT_KVP_PUBLISH_OPEN_IMAGE,
+    UT_KVP_PUBLISH_CLOSE,
+    UT_KVP_PUBLISH_RELOAD
+} ut_kvp_publish_op_t;
+
+// Struct to store a write and its arguments, see publishWrite()
+typedef struct
+{
+    ut_kvp_publish_op_t op;
+    char *pszFile;
+    char *pData;
+    uint32_t length;
+    const char *pszProfile;
+} ut_kvp_publish_request_t;
+
+static ut_kvp_hazard_t *gpHazards = NULL;     /* Every slot ever handed out, pushed at the head, never removed */
+static pthread_key_t gHazardKey;
+static pthread_once_t gHazardOnce = PTHREAD_ONCE_INIT;
+static __thread ut_kvp_hazard_t *gpThreadHazard = NULL;
+static __thread ut_kvp_instance_internal_t *gpThreadWriting = NULL;     /* UT_KVP_FLAG_THREADSAFE instance whose write lock this thread holds */
+
 /* Static functions */
 static ut_kvp_instance_internal_t *validateInstance(ut_kvp_instance_t *pInstance);
+static ut_kvp_instance_internal_t *validateOwner(ut_kvp_instance_t *pInstance);
+static ut_kvp_instance_internal_t *snapshotAcquire(ut_kvp_instance_internal_t *pOwner);
+static ut_kvp_instance_internal_t *snapshotCreate(ut_kvp_instance_internal_t *pOwner);
+static ut_kvp_instance_internal_t *snapshotOwner(ut_kvp_instance_internal_t *pInternal);
+static ut_kvp_status_t publishWrite(ut_kvp_instance_internal_t *pOwner, const ut_kvp_publish_request_t *pRequest);
+static ut_kvp_status_t publishLocked(ut_kvp_instance_internal_t *pOwner, const ut_kvp_publish_request_t *pRequest);
+static ut_kvp_status_t publishApply(ut_kvp_instance_internal_t *pSnapshot, const ut_kvp_publish_request_t *pRequest);
+static void publishReclaim(ut_kvp_publish_t *pPublish);
+static void publishFree(ut_kvp_publish_t *pPublish);
+static void publishLock(ut_kvp_instance_internal_t *pInternal);
+static void publishUnlock(ut_kvp_instance_internal_t *pInternal);
+static bool publishRequired(ut_kvp_instance_internal_t *pInternal);
+static ut_kvp_instance_internal_t *readLock(ut_kvp_instance_t *pInstance);
+static ut_kvp_instance_internal_t *iteratorReadLock(ut_kvp_iterator_t *pIterator);
+static void readUnlock(ut_kvp_instance_internal_t *pLocked);
+static char *readData( ut_kvp_instance_t *pInstance );
+static bool readFieldPresent( ut_kvp_instance_t *pInstance, const char *pszKey );
+static ut_kvp_status_t readStringField( ut_kvp_instance_t *pInstance, const char *pszKey, char *pszReturnedString, uint32_t uStringSize );
+static void copyScalar(char *pszReturnedString, uint32_t uStringSize, const char *pString, size_t length);
+static ut_kvp_status_t readStringView( ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppString, size_t *pLength );
+static ut_kvp_status_t readFields( ut_kvp_instance_t *pInstance, ut_kvp_field_t *pFields, uint32_t count );
+static uint32_t readListCount( ut_kvp_instance_t *pInstance, const char *pszKey );
+static ut_kvp_status_t readStringArray( ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppStrings, size_t *pLengths, uint32_t maxCount, uint32_t *pCount );
+static ut_kvp_status_t readDataBytesToBuffer(ut_kvp_instance_t *pInstance, const char *pszKey, unsigned char *pBuffer, uint32_t bufferSize, uint32_t *pSize);
+static ut_kvp_status_t readDataBytesString(ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppString, size_t *pLength);
+static ut_kvp_status_t readStringByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey, char *pszReturnedString, uint32_t uStringSize);
+static ut_kvp_iterator_t *readIteratorBegin(ut_kvp_instance_t *pInstance, const char *pszKey);
+static bool readIteratorNext(ut_kvp_iterator_t *pIterator);
+static const char *readIteratorName(ut_kvp_iterator_t *pIterator, size_t *pLength);
+static ut_kvp_status_t readIteratorStringView(ut_kvp_iterator_t *pIterator, const char **ppString, size_t *pLength);
+static ut_kvp_status_t readCompileImage(ut_kvp_instance_t *pInstance, char *fileName);
+static ut_kvp_hazard_t *hazardSlot(void);
+static void hazardInit(void);
+static void hazardRelease(void *pArg);
+static bool hazardHeld(const ut_kvp_instance_internal_t *pSnapshot);
+static ut_kvp_status_t watchStart(ut_kvp_instance_internal_t *pInternal, int *pFd);
+static ut_kvp_status_t reloadChanged(ut_kvp_instance_internal_t *pInternal, bool *pReloaded);
+static ut_kvp_status_t shareDocument(ut_kvp_instance_internal_t *pSource, ut_kvp_instance_internal_t *pTarget);
+static void shareRelease(ut_kvp_instance_internal_t *pInternal);
+static ut_kvp_status_t mapFile(const char *fileName, void **ppMapped, size_t *pSize);
+static ut_kvp_status_t lazyAdopt(ut_kvp_instance_internal_t *pInternal, const char *pText, size_t size, const char *pszSource);
+static int lazyScan(const char *pText, size_t size, ut_kvp_lazy_section_t **ppSections, uint32_t *pCount);
+static size_t lazySpaces(const char *pLine, size_t length);
+static int lazyCompare(const void *pLeft, const void *pRight);
+static ut_kvp_status_t lazyTouch(ut_kvp_instance_internal_t *pInternal, const char *pszKey);
+static ut_kvp_status_t lazyMissStatus(ut_kvp_instance_internal_t *pInternal, const char *pszKey);
+static void lazyComplete(ut_kvp_instance_internal_t *pInternal);
+static void lazyParse(ut_kvp_instance_internal_t *pInternal, ut_kvp_lazy_section_t *pSection);
+static void lazyFree(ut_kvp_lazy_t *pLazy);
+static void unmapProfile(ut_kvp_instance_internal_t *pInternal);
+static ut_kvp_status_t adoptDocument(ut_kvp_instance_internal_t *pInternal, struct fy_document *srcDoc, const char *pszSource, const ut_kvp_bundle_t *pBundle);
+static void includeContextInit(ut_kvp_instance_internal_t *pInternal, ut_kvp_include_context_t *pContext, const ut_kvp_bundle_t *pBundle);
+static ut_kvp_status_t bundleIndex(const void *pData, size_t size, ut_kvp_bundle_t *pBundle);
+static uint64_t bundleOctal(const char *pField, size_t length, bool *pValid);
+static int bundleCompare(const void *pLeft, const void *pRight);
+static const ut_kvp_bundle_member_t *bundleFind(const ut_kvp_bundle_t *pBundle, const char *pszName);
 static unsigned long getUIntField( ut_kvp_instance_t *pInstance, const char *pszKey, unsigned long maxRange );
-static bool str_to_bool(const char *string);
-static ut_kvp_status_t ut_kvp_getField(ut_kvp_instance_t *pInstance, const char *pszKey, char *pszResult);
+static unsigned long convertUIntField( const char *pField, size_t length, unsigned long maxRange, const ut_kvp_image_entry_t *pEntry );
+static uint64_t convertUInt64Field( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry );
+static bool parseUIntField( const char *pField, size_t length, uint64_t maxRange, const ut_kvp_image_entry_t *pEntry, uint64_t *pValue );
+static bool parseUInt64( const char *pField, size_t length, uint64_t maxRange, uint64_t *pValue );
+static bool parseEightDigits( const char *pDigits, uint32_t *pValue );
+static float convertFloatField( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry );
+static double convertDoubleField( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry );
+static bool parseFloatField( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry, float *pValue );
+static bool parseDoubleField( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry, double *pValue );
+static bool str_to_bool(const char *string, size_t length, const ut_kvp_image_entry_t *pEntry);
+static ut_kvp_key_internal_t *validateKey(ut_kvp_instance_internal_t *pInternal, ut_kvp_key_t *pKey);
+static struct fy_node *resolveKey(ut_kvp_instance_internal_t *pInternal, ut_kvp_key_internal_t *pKeyInternal);
+static const ut_kvp_image_entry_t *resolveImageKey(ut_kvp_instance_internal_t *pInternal, ut_kvp_key_internal_t *pKeyInternal);
+static const char *getKeyScalar(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey, size_t *pLength, const ut_kvp_image_entry_t **ppEntry);
+static const char *getScalar(ut_kvp_instance_t *pInstance, const char *pszKey, size_t *pLength, const ut_kvp_image_entry_t **ppEntry);
+static ut_kvp_iterator_internal_t *validateIterator(ut_kvp_iterator_t *pIterator);
+static const char *getIteratorScalar(ut_kvp_iterator_t *pIterator, size_t *pLength, const ut_kvp_image_entry_t **ppEntry);
 static void convert_dot_to_slash(const char *key, char *output);
+static struct fy_node *findNode(ut_kvp_instance_internal_t *pInternal, const char *pszKey);
+static struct fy_node *followAlias(struct fy_node *node);
+static ut_kvp_status_t decodeDataBytes(const char *pString, size_t length, unsigned char *pBuffer, uint32_t bufferSize, uint32_t *pCount);
+static ut_kvp_status_t getSequence(ut_kvp_instance_t *pInstance, const char *pszKey, void *pBuffer, uint32_t maxCount, uint32_t *pCount, struct fy_node **pNode, const ut_kvp_image_t **ppImage, const ut_kvp_image_entry_t **ppEntry);
+static ut_kvp_status_t getArray(ut_kvp_instance_t *pInstance, const char *pszKey, ut_kvp_field_type_t type, void *pValues, uint32_t maxCount, uint32_t *pCount);
+static struct fy_node *findSiblingNode(ut_kvp_instance_internal_t *pInternal, const char *pszKey, ut_kvp_parent_cache_t *pCache, ut_kvp_status_t *pStatus);
+static ut_kvp_status_t storeField(ut_kvp_field_t *pField, struct fy_node *node);
+static ut_kvp_status_t storeValue(ut_kvp_field_t *pField, const char *pString, size_t length, const ut_kvp_image_entry_t *pEntry);
+static void *arenaAlloc(ut_kvp_arena_t *pArena, size_t size);
+static void arenaFree(ut_kvp_arena_t *pArena);
+static void indexBuild(ut_kvp_instance_internal_t *pInternal);
+static void indexFree(ut_kvp_index_t *pIndex);
+static int indexAddNode(ut_kvp_index_t *pIndex, struct fy_node *node, char **ppPath, size_t *pPathSize, size_t pathLength);
+static int indexInsert(ut_kvp_index_t *pIndex, const char *pPath, size_t pathLength, struct fy_node *node);
+static struct fy_node *indexLookup(ut_kvp_index_t *pIndex, const char *pszKey);
+static const char *imageValue(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry, size_t *pLength);
+static const char *imageScalar(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry, const char *pszKey, size_t *pLength, ut_kvp_status_t *pStatus);
+static int imageCompare(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry, const char *pszKey);
+static const ut_kvp_image_entry_t *imageFind(const ut_kvp_image_t *pImage, const char *pszKey);
+static const ut_kvp_image_entry_t *imageChild(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry, uint32_t position);
+static ut_kvp_status_t imageValidate(ut_kvp_image_t *pImage, const void *pData, size_t size);
+static int imagePoolAppend(ut_kvp_image_builder_t *pBuilder, const char *pString, size_t length, uint32_t *pOffset);
+static void imagePreparse(ut_kvp_image_entry_t *pEntry, const char *pValue, size_t length);
+static int imageAddNode(ut_kvp_image_builder_t *pBuilder, struct fy_node *node, char **ppPath, size_t *pPathSize, size_t pathLength, uint32_t *pIndex);
+static int imageSortCompare(const void *pLeft, const void *pRight);
+static ut_kvp_status_t imageSerialise(ut_kvp_image_builder_t *pBuilder, char **ppData, size_t *pSize);
+static ut_kvp_status_t imageWrite(const char *pszFileName, const void *pData, size_t size);
+static void imageBuilderFree(ut_kvp_image_builder_t *pBuilder);
 static size_t write_memory_callback(void *contents, size_t size, size_t nmemb, void *userp);
-static struct fy_node* process_include(const char *filename, int depth, struct fy_document *doc);
+static struct fy_node* process_include(const char *filename, int depth, struct fy_document *doc, ut_kvp_include_context_t *pContext);
+static struct fy_document *includeLoadUrl(const char *url, ut_kvp_include_context_t *pContext, ut_kvp_url_validators_t *pValidators, bool *pNotModified);
+static struct fy_document *urlBuildDocument(char *pBody, size_t size);
+static size_t url_header_callback(char *buffer, size_t size, size_t nitems, void *userdata);
+static void urlCachePath(const char *pszDirectory, const char *url, char *pszPath);
+static char *urlCacheRead(const char *pszPath, const char *url, ut_kvp_url_validators_t *pValidators, size_t *pSize);
+static void urlCacheWrite(const char *pszDirectory, const char *pszPath, const char *url, const ut_kvp_url_validators_t *pValidators, const char *pBody, size_t size);
+static struct fy_node *includeCacheCopy(const char *filename, const ut_kvp_include_target_t *pTarget, struct fy_document *doc, ut_kvp_include_context_t *pContext);
+static ut_kvp_include_cache_entry_t *includeCacheFind(const char *pszKey, const struct stat *pFileStat);
+static bool includeCacheCurrent(const ut_kvp_include_cache_entry_t *pEntry, const ut_kvp_include_context_t *pContext, ut_kvp_url_validators_t *pValidators);
+static void includeCacheInsert(ut_kvp_include_cache_entry_t *pEntry);
+static const char *includeCacheKey(const char *filename, char *pszPath, struct stat *pFileStat, bool *pIsFile);
+static struct fy_document *includeParse(const char *filename, bool isFile, ut_kvp_include_context_t *pContext, ut_kvp_url_validators_t *pValidators, bool *pNotModified);
+static struct fy_node *includeCacheStore(const char *pszKey, bool isFile, const struct stat *pFileStat, const ut_kvp_url_validators_t *pValidators, uint64_t openSerial, struct fy_document *srcDoc, struct fy_document *doc);
+static void includePrefetch(struct fy_document *doc, ut_kvp_include_context_t *pContext);
+static void *includePrefetchWorker(void *pArg);
+static void includeCollect(struct fy_node *node, ut_kvp_prefetch_t *pPrefetch, int depth);
+static void includeQueue(ut_kvp_prefetch_t *pPrefetch, const char *pszName, int depth);
+static void curlGlobalInit(void);
+static CURL *curlAcquire(void);
+static void curlRelease(CURL *curl);
+static bool includeBudgetLeft(ut_kvp_include_context_t *pContext, uint32_t *pRemainingMs);
+static uint64_t monotonicMs(void);
+static void curlShareLock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr);
+static void curlShareUnlock(CURL *handle, curl_lock_data data, void *userptr);
+static void includeCacheFreeEntry(ut_kvp_include_cache_entry_t *pEntry);
 static void merge_nodes(struct fy_node *mainNode, struct fy_node *includeNode);
-static struct fy_node* process_node_copy(struct fy_node *srcNode, struct fy_document *dstDoc, int depth);
+static int expandDocument(struct fy_document *doc, int depth, ut_kvp_include_context_t *pContext);
+static int expandNode(struct fy_node **pNode, struct fy_document *doc, int depth, ut_kvp_include_context_t *pContext);
+static void expandIncludes(struct fy_node *node, struct fy_document *doc, int depth, ut_kvp_include_context_t *pContext);
+static bool isIncludeTag(struct fy_node *node);
+static struct fy_node *includeShared(const char *filename, int depth, struct fy_document *doc, ut_kvp_include_context_t *pContext);
+static void includeShareFree(ut_kvp_include_context_t *pContext);
+static int includeChainPush(ut_kvp_include_context_t *pContext, const char *filename, ut_kvp_include_target_t *pTarget);
+static void includeChainPop(ut_kvp_include_context_t *pContext);
+static void includeFileRecord(ut_kvp_include_context_t *pContext, const char *pszPath);
+static void includeCacheDrop(const char *pszKey);
+static int watchRegister(ut_kvp_instance_internal_t *pInternal);
+static bool watchDrain(ut_kvp_instance_internal_t *pInternal);
+static void watchStop(ut_kvp_watch_t *pWatch);
+static void watchFilesFree(char **ppFiles, uint32_t fileCount);
+static void addIncludeEdit(ut_kvp_include_edit_t **ppEdits, uint32_t *pCount, uint32_t *pCapacity, void *pChild, struct fy_node *replacement);
+static void applyIncludeEdits(struct fy_node *node, ut_kvp_include_edit_t *pEdits, uint32_t editCount);
 static const void *find_pattern_from_buffer(const void *buffer, size_t bufferLength, const void *pattern, size_t patternLength);
 
 ut_kvp_instance_t *ut_kvp_createInstance(void)
 {
-    ut_kvp_instance_internal_t *pInstance = malloc(sizeof(ut_kvp_instance_internal_t));
+    return ut_kvp_createInstanceWithFlags(UT_KVP_FLAG_NONE);
+}
+
+ut_kvp_instance_t *ut_kvp_createInstanceWithFlags(uint32_t flags)
+{
+    ut_kvp_instance_internal_t *pInstance;
+
+    if (((flags & UT_KVP_FLAG_CONCURRENT) && (flags & UT_KVP_FLAG_THREADSAFE)) ||
+        ((flags & UT_KVP_FLAG_LAZY) && (flags & (UT_KVP_FLAG_CONCURRENT | UT_KVP_FLAG_THREADSAFE | UT_KVP_FLAG_SHARED_INCLUDES))))
+    {
+        UT_LOG_ERROR( "Invalid Param [flags]" );
+        return NULL;
+    }
 
+    pInstance = malloc(sizeof(ut_kvp_instance_internal_t));
     if ( pInstance == NULL )
     {
         return NULL;
@@ -74,13 +673,36 @@ ut_kvp_instance_t *ut_kvp_createInstance(void)
     memset(pInstance, 0, sizeof(ut_kvp_instance_internal_t));
 
     pInstance->magic = UT_KVP_MAGIC;
+    pInstance->flags = flags;
+    pInstance->connectTimeoutMs = UT_KVP_DEFAULT_CONNECT_TIMEOUT_MS;
+    pInstance->transferTimeoutMs = UT_KVP_DEFAULT_TRANSFER_TIMEOUT_MS;
+    pInstance->maxIncludeDepth = UT_KVP_DEFAULT_INCLUDE_DEPTH;
+    pInstance->watch.fd = -1;
+
+    // Readers are handed snapshots, the instance itself only holds settings and the watch
+    if (flags & UT_KVP_FLAG_CONCURRENT)
+    {
+        pthread_mutex_init(&pInstance->publish.writeLock, NULL);
+        pInstance->publish.pCurrent = snapshotCreate(pInstance);
+        if (pInstance->publish.pCurrent == NULL)
+        {
+            pthread_mutex_destroy(&pInstance->publish.writeLock);
+            free(pInstance);
+            return NULL;
+        }
+    }
+
+    if (flags & UT_KVP_FLAG_THREADSAFE)
+    {
+        pthread_rwlock_init(&pInstance->lock, NULL);
+    }
 
     return (ut_kvp_instance_t *)pInstance;
 }
 
 void ut_kvp_destroyInstance(ut_kvp_instance_t *pInstance)
 {
-    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
     if ( pInternal == NULL )
     {
@@ -89,18 +711,96 @@ void ut_kvp_destroyInstance(ut_kvp_instance_t *pInstance)
 
     ut_kvp_close( pInstance );
 
+    /* No thread may read the instance any more, every snapshot goes regardless of hazards */
+    if (pInternal->flags & UT_KVP_FLAG_CONCURRENT)
+    {
+        publishFree(&pInternal->publish);
+    }
+
+    if (pInternal->flags & UT_KVP_FLAG_THREADSAFE)
+    {
+        pthread_rwlock_destroy(&pInternal->lock);
+    }
+
     memset(pInternal, 0, sizeof(ut_kvp_instance_internal_t));
 
     free(pInternal);
     pInternal = NULL;
 }
 
+ut_kvp_instance_t *ut_kvp_clone(ut_kvp_instance_t *pInstance)
+{
+    ut_kvp_instance_internal_t *pClone;
+    ut_kvp_instance_internal_t *pSource;
+    ut_kvp_instance_internal_t *pTarget;
+    ut_kvp_status_t status = UT_KVP_STATUS_SUCCESS;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
+
+    if (pInternal == NULL)
+    {
+        return NULL;
+    }
+
+    pClone = (ut_kvp_instance_internal_t *)ut_kvp_createInstanceWithFlags(pInternal->flags);
+    if (pClone == NULL)
+    {
+        UT_LOG_ERROR("Memory allocation error");
+        return NULL;
+    }
+
+    // Writers are held off, so the document can't be replaced while its reference is taken
+    publishLock(pInternal);
+
+    pClone->includeBudgetMs = pInternal->includeBudgetMs;
+    pClone->connectTimeoutMs = pInternal->connectTimeoutMs;
+    pClone->transferTimeoutMs = pInternal->transferTimeoutMs;
+    pClone->maxIncludeDepth = pInternal->maxIncludeDepth;
+
+    /* A concurrent instance holds its document in the published snapshot */
+    pSource = (pInternal->flags & UT_KVP_FLAG_CONCURRENT) ? __atomic_load_n(&pInternal->publish.pCurrent, __ATOMIC_ACQUIRE) : pInternal;
+    pTarget = (pClone->flags & UT_KVP_FLAG_CONCURRENT) ? pClone->publish.pCurrent : pClone;
+    /* The shared document is never modified again, so every section left is parsed first */
+    lazyComplete(pSource);
+    status = shareDocument(pSource, pTarget);
+
+    /* The files behind the profile are copied, so ut_kvp_watch() and ut_kvp_reload() work on the clone */
+    if ((status == UT_KVP_STATUS_SUCCESS) && (pInternal->watch.fileCount > 0))
+    {
+        pClone->watch.ppFiles = calloc(pInternal->watch.fileCount, sizeof(char *));
+        for (uint32_t i = 0; (pClone->watch.ppFiles != NULL) && (i < pInternal->watch.fileCount); i++)
+        {
+            pClone->watch.ppFiles[i] = strdup(pInternal->watch.ppFiles[i]);
+            if (pClone->watch.ppFiles[i] == NULL)
+            {
+                break;
+            }
+            pClone->watch.fileCount++;
+        }
+        if (pClone->watch.fileCount != pInternal->watch.fileCount)
+        {
+            UT_LOG_ERROR("Memory allocation error");
+            status = UT_KVP_STATUS_INVALID_PARAM;
+        }
+        pClone->watch.hasSource = pInternal->watch.hasSource;
+    }
+
+    publishUnlock(pInternal);
+
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        ut_kvp_destroyInstance((ut_kvp_instance_t *)pClone);
+        return NULL;
+    }
+
+    return (ut_kvp_instance_t *)pClone;
+}
+
 ut_kvp_status_t ut_kvp_open(ut_kvp_instance_t *pInstance, char *fileName)
 {
-    struct fy_node *node;
-    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_status_t status;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
-    if (pInstance == NULL)
+    if (pInternal == NULL)
     {
         return UT_KVP_STATUS_INVALID_INSTANCE;
     }
@@ -117,52 +817,39 @@ ut_kvp_status_t ut_kvp_open(ut_kvp_instance_t *pInstance, char *fileName)
         return UT_KVP_STATUS_FILE_OPEN_ERROR;
     }
 
-    if(pInternal->fy_handle)
-    {
-        merge_nodes(fy_document_root(pInternal->fy_handle), fy_document_root(fy_document_build_from_file(NULL, fileName)));
-    }
-    else
+    /* Sections are parsed from the mapping as they are read */
+    if (pInternal->flags & UT_KVP_FLAG_LAZY)
     {
-        pInternal->fy_handle = fy_document_create(NULL);
+        return ut_kvp_openMapped(pInstance, fileName);
     }
 
-    if (NULL == pInternal->fy_handle)
+    if (publishRequired(pInternal))
     {
-        UT_LOG_ERROR("Unable to parse file/memory");
-        ut_kvp_close( pInstance );
-        return UT_KVP_STATUS_PARSING_ERROR;
+        ut_kvp_publish_request_t request = { .op = UT_KVP_PUBLISH_OPEN, .pszFile = fileName };
+        return publishWrite(pInternal, &request);
     }
 
-    struct fy_document *srcDoc = fy_document_build_from_file(NULL, fileName);
-
-    if(fy_document_resolve(srcDoc) != 0)
+    /* An image can't be merged into, it is replaced outright */
+    if (pInternal->image.pHeader != NULL)
     {
-        UT_LOG_ERROR("Error resolving document for anchors, aliases and merge keys");
         ut_kvp_close(pInstance);
-        return UT_KVP_STATUS_PARSING_ERROR;
     }
 
-    node = process_node_copy(fy_document_root(srcDoc), pInternal->fy_handle, 0);
-
-    if (node == NULL)
+    status = adoptDocument(pInternal, fy_document_build_from_file(NULL, fileName), fileName, NULL);
+    if (status != UT_KVP_STATUS_SUCCESS)
     {
-        UT_LOG_ERROR("Unable to process node");
         ut_kvp_close(pInstance);
-        return UT_KVP_STATUS_PARSING_ERROR;
     }
 
-    fy_document_set_root(pInternal->fy_handle, node);
-    fy_document_destroy(srcDoc);
-
-    return UT_KVP_STATUS_SUCCESS;
+    return status;
 }
 
 ut_kvp_status_t ut_kvp_openMemory(ut_kvp_instance_t *pInstance, char *pData, uint32_t length )
 {
-    struct fy_node *node;
-    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_status_t status;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
-    if (pInstance == NULL)
+    if (pInternal == NULL)
     {
         return UT_KVP_STATUS_INVALID_INSTANCE;
     }
@@ -173,969 +860,6725 @@ ut_kvp_status_t ut_kvp_openMemory(ut_kvp_instance_t *pInstance, char *pData, uin
         return UT_KVP_STATUS_INVALID_PARAM;
     }
 
-    if (pInternal->fy_handle)
-    {
-        merge_nodes(fy_document_root(pInternal->fy_handle), fy_document_root(fy_document_build_from_malloc_string(NULL, pData, length)));
-    }
-    else
-    {
-        pInternal->fy_handle = fy_document_create(NULL);
-    }
-
-    if (NULL == pInternal->fy_handle)
+    if (publishRequired(pInternal))
     {
-        UT_LOG_ERROR("Unable to parse file/memory");
-        ut_kvp_close( pInstance );
-        return UT_KVP_STATUS_PARSING_ERROR;
+        ut_kvp_publish_request_t request = { .op = UT_KVP_PUBLISH_OPEN_MEMORY, .pData = pData, .length = length };
+        return publishWrite(pInternal, &request);
     }
 
-    struct fy_document *srcDoc = fy_document_build_from_malloc_string(NULL, pData, length);
-
-    if(fy_document_resolve(srcDoc) != 0)
+    /* An image can't be merged into, it is replaced outright */
+    if (pInternal->image.pHeader != NULL)
     {
-        UT_LOG_ERROR("Error resolving document for anchors, aliases and merge keys");
         ut_kvp_close(pInstance);
-        return UT_KVP_STATUS_PARSING_ERROR;
     }
 
-    node = process_node_copy(fy_document_root(srcDoc), pInternal->fy_handle, 0);
-
-    if (node == NULL)
+    /* The document takes ownership of pData */
+    status = adoptDocument(pInternal, fy_document_build_from_malloc_string(NULL, pData, length), NULL, NULL);
+    if (status != UT_KVP_STATUS_SUCCESS)
     {
-        UT_LOG_ERROR("Unable to process node");
         ut_kvp_close(pInstance);
-        return UT_KVP_STATUS_PARSING_ERROR;
     }
 
-    fy_document_set_root(pInternal->fy_handle, node);
-    fy_document_destroy(srcDoc);
-
-    return UT_KVP_STATUS_SUCCESS;
+    return status;
 }
 
-void ut_kvp_close(ut_kvp_instance_t *pInstance)
+ut_kvp_status_t ut_kvp_openMapped(ut_kvp_instance_t *pInstance, char *fileName)
 {
-    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_status_t status;
+    void *pMapped;
+    size_t mappedSize;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
     if (pInternal == NULL)
     {
-        return;
+        return UT_KVP_STATUS_INVALID_INSTANCE;
     }
 
-    if ( pInternal->fy_handle != NULL)
+    if (fileName == NULL)
     {
-        fy_document_destroy(pInternal->fy_handle);
-        pInternal->fy_handle = NULL;
+        UT_LOG_ERROR( "Invalid Param [fileName]" );
+        return UT_KVP_STATUS_INVALID_PARAM;
     }
-}
 
-char* ut_kvp_getData( ut_kvp_instance_t *pInstance )
-{
-     ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
-     char *kvp_yaml_output = NULL;
+    if (publishRequired(pInternal))
+    {
+        ut_kvp_publish_request_t request = { .op = UT_KVP_PUBLISH_OPEN_MAPPED, .pszFile = fileName };
+        return publishWrite(pInternal, &request);
+    }
 
-     if (pInternal == NULL)
+    status = mapFile(fileName, &pMapped, &mappedSize);
+    if (status != UT_KVP_STATUS_SUCCESS)
     {
-        return NULL;
+        if (status == UT_KVP_STATUS_PARSING_ERROR)
+        {
+            /* Nothing ut_kvp_open() could parse either */
+            ut_kvp_close(pInstance);
+        }
+        return status;
     }
 
-    if ( pInternal->fy_handle == NULL)
+    if (pInternal->image.pHeader != NULL)
     {
-        return NULL;
+        ut_kvp_close(pInstance);
     }
 
-    kvp_yaml_output = fy_emit_document_to_string(pInternal->fy_handle, FYECF_DEFAULT);
-    if (kvp_yaml_output == NULL)
+    // The parser reads the mapping in place, the file is parsed exactly once and the tree refers into it
+    if (pInternal->flags & UT_KVP_FLAG_LAZY)
     {
-        UT_LOG_ERROR("Failed to emit YAML document\n");
-        return NULL;
+        status = lazyAdopt(pInternal, pMapped, mappedSize, fileName);
     }
-    return kvp_yaml_output;
+    else
+    {
+        status = adoptDocument(pInternal, fy_document_build_from_string(NULL, pMapped, mappedSize), fileName, NULL);
+    }
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        munmap(pMapped, mappedSize);
+        ut_kvp_close(pInstance);
+        return status;
+    }
+
+    /* The earlier mapping went with the previous document */
+    pInternal->pMapped = pMapped;
+    pInternal->mappedSize = mappedSize;
+
+    return UT_KVP_STATUS_SUCCESS;
 }
 
-static ut_kvp_status_t ut_kvp_getField(ut_kvp_instance_t *pInstance, const char *pszKey, char *pzResult)
+ut_kvp_status_t ut_kvp_openBundle(ut_kvp_instance_t *pInstance, char *fileName, const char *pszProfile)
 {
-    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
-    char zEntry[UT_KVP_MAX_ELEMENT_SIZE * 2];
-    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
-    char *str = "%s";
-    int fy_result;
+    ut_kvp_status_t status;
+    ut_kvp_bundle_t bundle;
+    const ut_kvp_bundle_member_t *pProfile;
+    char zProfile[UT_KVP_BUNDLE_NAME_SIZE + 1];
+    void *pMapped;
+    size_t mappedSize;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
     if (pInternal == NULL)
     {
         return UT_KVP_STATUS_INVALID_INSTANCE;
     }
 
-    if (pszKey == NULL)
+    if (fileName == NULL)
     {
-        UT_LOG_ERROR("Invalid Param - pszKey");
+        UT_LOG_ERROR( "Invalid Param [fileName]" );
         return UT_KVP_STATUS_INVALID_PARAM;
     }
 
-    if (pzResult == NULL)
+    if (publishRequired(pInternal))
     {
-        UT_LOG_ERROR("Invalid Param - pzResult");
-        return UT_KVP_STATUS_INVALID_PARAM;
+        ut_kvp_publish_request_t request = { .op = UT_KVP_PUBLISH_OPEN_BUNDLE, .pszFile = fileName, .pszProfile = pszProfile };
+        return publishWrite(pInternal, &request);
     }
 
-    if ( pInternal->fy_handle == NULL )
+    status = mapFile(fileName, &pMapped, &mappedSize);
+    if (status != UT_KVP_STATUS_SUCCESS)
     {
-        UT_LOG_ERROR("No Data File open");
-        return UT_KVP_STATUS_NO_DATA;
+        return status;
     }
 
-    convert_dot_to_slash(pszKey, zKey);
-
-    snprintf( zEntry, sizeof(zEntry), "%s %s", zKey, str );
-    fy_result = fy_document_scanf(pInternal->fy_handle, zEntry, pzResult);
-    if ( fy_result <= 0 )
+    // Every member is indexed once, includes then resolve against the index instead of the filesystem
+    status = bundleIndex(pMapped, mappedSize, &bundle);
+    if (status != UT_KVP_STATUS_SUCCESS)
     {
-        UT_LOG_ERROR("Parsing Error");
-        return UT_KVP_STATUS_PARSING_ERROR;
+        UT_LOG_ERROR("[%s] is not a valid bundle", fileName);
+        munmap(pMapped, mappedSize);
+        return status;
     }
 
-    return UT_KVP_STATUS_SUCCESS;
-}
+    pProfile = (pszProfile != NULL) ? bundleFind(&bundle, pszProfile) : bundle.pFirst;
+    if (pProfile == NULL)
+    {
+        UT_LOG_ERROR("[%s] has no member [%s]", fileName, (pszProfile != NULL) ? pszProfile : "");
+        free(bundle.pMembers);
+        munmap(pMapped, mappedSize);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
+    }
 
-bool ut_kvp_getBoolField( ut_kvp_instance_t *pInstance, const char *pszKey )
-{
-    char result[UT_KVP_MAX_ELEMENT_SIZE];
-    ut_kvp_status_t status;
-    bool bValue;
+    if (pInternal->image.pHeader != NULL)
+    {
+        ut_kvp_close(pInstance);
+    }
 
-    status = ut_kvp_getField(pInstance, pszKey, result);
-    if ( status != UT_KVP_STATUS_SUCCESS )
+    // Members are parsed in place, like ut_kvp_openMapped(), so the mapping is kept until close
+    snprintf(zProfile, sizeof(zProfile), "%.*s", (int)pProfile->nameLength, pProfile->pName);
+    status = adoptDocument(pInternal, fy_document_build_from_string(NULL, pProfile->pData, pProfile->size), zProfile, &bundle);
+    free(bundle.pMembers);
+    if (status != UT_KVP_STATUS_SUCCESS)
     {
-        return false;
+        munmap(pMapped, mappedSize);
+        ut_kvp_close(pInstance);
+        return status;
     }
 
-    bValue = str_to_bool(result);
-    return bValue;
+    pInternal->pMapped = pMapped;
+    pInternal->mappedSize = mappedSize;
+
+    return UT_KVP_STATUS_SUCCESS;
 }
 
-static unsigned long getUIntField( ut_kvp_instance_t *pInstance, const char *pszKey, unsigned long maxRange )
+ut_kvp_status_t ut_kvp_openImage(ut_kvp_instance_t *pInstance, char *fileName)
 {
-    char *pEndptr;
-    unsigned long uValue;
-    char result[UT_KVP_MAX_ELEMENT_SIZE];
+    ut_kvp_image_t image;
+    struct stat fileStat;
     ut_kvp_status_t status;
-    char *pField = &result[0];
+    void *pMapped;
+    int fd;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
-    errno = 0; // Clear the stdlib errno
+    if (pInternal == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_INSTANCE;
+    }
 
-    status = ut_kvp_getField(pInstance, pszKey, result);
-    if ( status != UT_KVP_STATUS_SUCCESS )
+    if (fileName == NULL)
     {
-        return 0;
+        UT_LOG_ERROR( "Invalid Param [fileName]" );
+        return UT_KVP_STATUS_INVALID_PARAM;
     }
 
-    if (strstr(result, "0x"))
+    if (publishRequired(pInternal))
     {
-        uValue = strtoul(pField, &pEndptr, 16); // Base 16 conversion
+        ut_kvp_publish_request_t request = { .op = UT_KVP_PUBLISH_OPEN_IMAGE, .pszFile = fileName };
+        return publishWrite(pInternal, &request);
     }
-    else
+
+    fd = open(fileName, O_RDONLY);
+    if (fd < 0)
     {
-        uValue = strtoul(pField, &pEndptr, 10); // Base 10 conversion
+        UT_LOG_ERROR("[%s] cannot be accesed", fileName);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
     }
 
-    // Error checking
-    if (pField == pEndptr)
+    if ((fstat(fd, &fileStat) != 0) || !S_ISREG(fileStat.st_mode))
     {
-        UT_LOG_ERROR("No conversion performed!");
-        return 0;
+        UT_LOG_ERROR("[%s] is not a regular file", fileName);
+        close(fd);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
+    }
+
+    if ((size_t)fileStat.st_size < sizeof(ut_kvp_image_header_t))
+    {
+        UT_LOG_ERROR("[%s] is not a KVP image", fileName);
+        close(fd);
+        return UT_KVP_STATUS_PARSING_ERROR;
     }
-    else if (*pEndptr != '\0')
+
+    pMapped = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pMapped == MAP_FAILED)
     {
-        UT_LOG_ERROR("Invalid characters in the string.");
-        return 0;
+        UT_LOG_ERROR("[%s] cannot be mapped", fileName);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
     }
-    else if (errno == ERANGE || uValue > maxRange)
+
+    // Validated before the instance is touched, so a bad image leaves the current profile in place
+    memset(&image, 0, sizeof(image));
+    status = imageValidate(&image, pMapped, (size_t)fileStat.st_size);
+    if (status != UT_KVP_STATUS_SUCCESS)
     {
-        UT_LOG_DEBUG("Value out of range for maxRange [0x%lx,%ld].", maxRange, maxRange);
-        return 0;
+        UT_LOG_ERROR("[%s] is not a valid KVP image", fileName);
+        munmap(pMapped, (size_t)fileStat.st_size);
+        return status;
     }
 
-    //UT_LOG_DEBUG("Converted value: %u", uValue);
-    return uValue;
-}
+    // The image replaces whatever the instance held
+    ut_kvp_close(pInstance);
 
-uint8_t ut_kvp_getUInt8Field( ut_kvp_instance_t *pInstance, const char *pszKey )
-{
-    unsigned long value;
-    value = getUIntField( pInstance, pszKey, UINT8_MAX );
+    /* Served straight from the mapping, nothing is parsed */
+    pInternal->image = image;
+    pInternal->pMapped = pMapped;
+    pInternal->mappedSize = (size_t)fileStat.st_size;
 
-    return (uint8_t)value;
+    return UT_KVP_STATUS_SUCCESS;
 }
 
-uint16_t ut_kvp_getUInt16Field( ut_kvp_instance_t *pInstance, const char *pszKey )
+ut_kvp_status_t ut_kvp_compileImage(ut_kvp_instance_t *pInstance, char *fileName)
 {
-    unsigned long value;
-    value = getUIntField( pInstance, pszKey, UINT16_MAX );
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    ut_kvp_status_t value;
 
-    return (uint16_t)value;
+    value = readCompileImage(pInstance, fileName);
+    readUnlock(pLocked);
+
+    return value;
 }
 
-uint32_t ut_kvp_getUInt32Field( ut_kvp_instance_t *pInstance, const char *pszKey )
+static ut_kvp_status_t readCompileImage(ut_kvp_instance_t *pInstance, char *fileName)
 {
-    unsigned long value;
-    value = getUIntField( pInstance, pszKey, UINT32_MAX );
+    ut_kvp_image_builder_t builder;
+    ut_kvp_status_t status = UT_KVP_STATUS_SUCCESS;
+    struct fy_node *root;
+    size_t pathSize = UT_KVP_MAX_ELEMENT_SIZE;
+    size_t size = 0;
+    uint32_t rootIndex;
+    char *pPath;
+    char *pData = NULL;
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
 
-    return (uint32_t)value;
-}
+    if (pInternal == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_INSTANCE;
+    }
 
-uint64_t ut_kvp_getUInt64Field( ut_kvp_instance_t *pInstance, const char *pszKey )
-{
-    char *pEndptr;
-    uint64_t u64Value;
-    char result[UT_KVP_MAX_ELEMENT_SIZE];
-    ut_kvp_status_t status;
-    char *pField = &result[0];
+    if (fileName == NULL)
+    {
+        UT_LOG_ERROR( "Invalid Param [fileName]" );
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
 
-    errno = 0; // Clear the stdlib errno
-    status = ut_kvp_getField(pInstance, pszKey, result);
-    if ( status != UT_KVP_STATUS_SUCCESS )
+    if (pInternal->image.pHeader != NULL)
     {
-        return 0;
+        /* Already compiled, the mapping is the image */
+        return imageWrite(fileName, pInternal->pMapped, pInternal->mappedSize);
     }
 
-    if(strstr(result, "0x"))
+    if (pInternal->fy_handle == NULL)
     {
-        u64Value = strtoull(pField, &pEndptr, 16); // Base 16 conversion
+        UT_LOG_ERROR("No Data File open");
+        return UT_KVP_STATUS_NO_DATA;
     }
-    else
+
+    lazyComplete(pInternal);
+    root = fy_document_root(pInternal->fy_handle);
+    if (root == NULL)
+    {
+        UT_LOG_ERROR("Empty document");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    memset(&builder, 0, sizeof(builder));
+    pPath = malloc(pathSize);
+    if (pPath == NULL)
     {
-        u64Value = strtoull(pField, &pEndptr, 10); // Base 10 conversion
+        UT_LOG_ERROR("Memory allocation error");
+        return UT_KVP_STATUS_INVALID_PARAM;
     }
 
-    // Error checking
-    if (pField == pEndptr) 
+    // Includes, anchors and merge keys were all resolved at open, the image holds the final document
+    if (imageAddNode(&builder, root, &pPath, &pathSize, 0, &rootIndex) != 0)
     {
-        UT_LOG_ERROR("No conversion performed!");
-        return 0;
+        UT_LOG_ERROR("Unable to compile image");
+        status = UT_KVP_STATUS_INVALID_PARAM;
     }
-    else if (*pEndptr != '\0') 
+    free(pPath);
+
+    if (status == UT_KVP_STATUS_SUCCESS)
     {
-        UT_LOG_ERROR("Invalid characters in the string.");
-        return 0;
-    } 
-    else if (errno == ERANGE || u64Value > UINT64_MAX) 
+        status = imageSerialise(&builder, &pData, &size);
+    }
+    imageBuilderFree(&builder);
+
+    if (status == UT_KVP_STATUS_SUCCESS)
     {
-        UT_LOG_ERROR("Value out of range for uint64_t.");
-        return 0;
+        status = imageWrite(fileName, pData, size);
     }
+    free(pData);
 
-    //UT_LOG_DEBUG("Converted value: %llu", u64Value);
-    return u64Value;
+    return status;
 }
 
-float ut_kvp_getFloatField( ut_kvp_instance_t *pInstance, const char *pszKey)
+void ut_kvp_close(ut_kvp_instance_t *pInstance)
 {
-    char result[UT_KVP_MAX_ELEMENT_SIZE];
-    ut_kvp_status_t status;
-    float fValue;
-    char *endPtr;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
-    status = ut_kvp_getField(pInstance, pszKey, result);
-    if ( status != UT_KVP_STATUS_SUCCESS )
+    if (pInternal == NULL)
     {
-        return 0;
+        return;
     }
 
-    fValue = strtof(result, &endPtr);
+    publishLock(pInternal);
 
-    if (*endPtr != '\0')
+    /* Readers move on to an empty snapshot, the instance itself holds no document */
+    if (pInternal->flags & UT_KVP_FLAG_CONCURRENT)
     {
-        UT_LOG_ERROR("Error: Invalid floating-point string: '%s'\n", result);
-        return 0;
+        ut_kvp_publish_request_t request = { .op = UT_KVP_PUBLISH_CLOSE };
+        publishLocked(pInternal, &request);
     }
-    return fValue;
+
+    /* A document shared with clones is freed by the last of them */
+    shareRelease(pInternal);
+    if ( pInternal->fy_handle != NULL)
+    {
+        fy_document_destroy(pInternal->fy_handle);
+        pInternal->fy_handle = NULL;
+    }
+    unmapProfile(pInternal);
+    pInternal->generation++;
+    lazyFree(&pInternal->lazy);
+    indexFree(&pInternal->index);
+    arenaFree(&pInternal->arena);
+
+    watchStop(&pInternal->watch);
+    watchFilesFree(pInternal->watch.ppFiles, pInternal->watch.fileCount);
+    pInternal->watch.ppFiles = NULL;
+    pInternal->watch.fileCount = 0;
+    pInternal->watch.hasSource = false;
+
+    publishUnlock(pInternal);
 }
 
-double ut_kvp_getDoubleField( ut_kvp_instance_t *pInstance, const char *pszKey)
+ut_kvp_status_t ut_kvp_watch(ut_kvp_instance_t *pInstance, int *pFd)
 {
-    char result[UT_KVP_MAX_ELEMENT_SIZE];
     ut_kvp_status_t status;
-    double dValue;
-    char *endPtr;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
-    status = ut_kvp_getField(pInstance, pszKey, result);
-    if ( status != UT_KVP_STATUS_SUCCESS )
+    if (pInternal == NULL)
     {
-        return 0;
+        return UT_KVP_STATUS_INVALID_INSTANCE;
     }
 
-    dValue = strtod(result, &endPtr);
+    publishLock(pInternal);
+    status = watchStart(pInternal, pFd);
+    publishUnlock(pInternal);
 
-    if (*endPtr != '\0')
-    {
-        UT_LOG_ERROR("Error: Invalid floating-point string: '%s'\n", result);
-        return 0;
-    }
-    return dValue;
+    return status;
 }
 
-bool ut_kvp_fieldPresent( ut_kvp_instance_t *pInstance, const char *pszKey)
+ut_kvp_status_t ut_kvp_reload(ut_kvp_instance_t *pInstance, bool *pReloaded)
 {
-    struct fy_node *node = NULL;
-    struct fy_node *root = NULL;
-    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
-
-    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_status_t status;
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
     if (pInternal == NULL)
     {
-        UT_LOG_ERROR("Invalid Param - pInternal");
-        return false;
+        return UT_KVP_STATUS_INVALID_INSTANCE;
     }
 
-    if (pszKey == NULL)
+    if (pReloaded != NULL)
     {
-        UT_LOG_ERROR("Invalid Param - pszKey");
-        return false;
+        *pReloaded = false;
     }
 
-    if ( pInternal->fy_handle == NULL )
-    {
-        UT_LOG_ERROR("No Data File open");
-        return false;
-    }
-    // Get the root node
-    root = fy_document_root(pInternal->fy_handle);
-    if ( root == NULL )
-    {
-        UT_LOG_ERROR("Empty document");
-        return false;
-    }
+    publishLock(pInternal);
+    status = reloadChanged(pInternal, pReloaded);
+    publishUnlock(pInternal);
 
-    convert_dot_to_slash(pszKey, zKey);
+    return status;
+}
 
-    // Find the node corresponding to the key
-    node = fy_node_by_path(root, zKey, -1, FYNWF_DONT_FOLLOW);
-    if ( node == NULL )
+ut_kvp_status_t ut_kvp_setIncludeTimeouts(ut_kvp_instance_t *pInstance, uint32_t budgetMs, uint32_t connectTimeoutMs, uint32_t transferTimeoutMs)
+{
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
+
+    if (pInternal == NULL)
     {
-        //UT_LOG_DEBUG("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
-        //Commented this out now, will uncomment it once logging module is upgraded
-        return false;
+        return UT_KVP_STATUS_INVALID_INSTANCE;
     }
 
-    return true;
+    publishLock(pInternal);
+    pInternal->includeBudgetMs = budgetMs;
+    pInternal->connectTimeoutMs = connectTimeoutMs;
+    pInternal->transferTimeoutMs = transferTimeoutMs;
+    publishUnlock(pInternal);
+
+    return UT_KVP_STATUS_SUCCESS;
 }
 
-ut_kvp_status_t ut_kvp_getStringField( ut_kvp_instance_t *pInstance, const char *pszKey, char *pszReturnedString, uint32_t uStringSize )
+ut_kvp_status_t ut_kvp_setIncludeDepth(ut_kvp_instance_t *pInstance, uint32_t maxDepth)
 {
-    struct fy_node *node = NULL;
-    struct fy_node *root = NULL;
-    const char *pString = NULL;
-    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
-
-    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
 
     if (pInternal == NULL)
     {
         return UT_KVP_STATUS_INVALID_INSTANCE;
     }
 
-    if (pszKey == NULL)
+    if ((maxDepth == 0) || (maxDepth > INT_MAX))
     {
-        UT_LOG_ERROR("Invalid Param - pszKey");
-        return UT_KVP_STATUS_NULL_PARAM;
+        UT_LOG_ERROR( "Invalid Param [maxDepth]" );
+        return UT_KVP_STATUS_INVALID_PARAM;
     }
 
-    if ( pszReturnedString == NULL )
+    publishLock(pInternal);
+    pInternal->maxIncludeDepth = maxDepth;
+    publishUnlock(pInternal);
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+ut_kvp_status_t ut_kvp_getIncludeCacheStats(ut_kvp_include_cache_stats_t *pStats)
+{
+    if (pStats == NULL)
     {
-        UT_LOG_ERROR("Invalid Param - pszReturnedString");
+        UT_LOG_ERROR( "Invalid Param [pStats]" );
         return UT_KVP_STATUS_NULL_PARAM;
     }
 
-    /* Make sure we populate the returned string with zt before any other action */
-    *pszReturnedString=0;
-    if ( pInternal->fy_handle == NULL )
-    {
-        UT_LOG_ERROR("No Data File open");
-        return UT_KVP_STATUS_NO_DATA;
-    }
-    // Get the root node
-    root = fy_document_root(pInternal->fy_handle);
-    if ( root == NULL )
+    pthread_mutex_lock(&gIncludeCache.lock);
+    pStats->hits = gIncludeCache.hits;
+    pStats->misses = gIncludeCache.misses;
+    pStats->entries = gIncludeCache.count;
+    pthread_mutex_unlock(&gIncludeCache.lock);
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+void ut_kvp_clearIncludeCache(void)
+{
+    ut_kvp_include_cache_entry_t *pEntry;
+
+    pthread_mutex_lock(&gIncludeCache.lock);
+    pEntry = gIncludeCache.pEntries;
+    while (pEntry != NULL)
     {
-        UT_LOG_ERROR("Empty document");
-        return UT_KVP_STATUS_PARSING_ERROR;
+        ut_kvp_include_cache_entry_t *pNext = pEntry->pNext;
+        includeCacheFreeEntry(pEntry);
+        pEntry = pNext;
     }
+    gIncludeCache.pEntries = NULL;
+    gIncludeCache.count = 0;
+    gIncludeCache.hits = 0;
+    gIncludeCache.misses = 0;
+    pthread_mutex_unlock(&gIncludeCache.lock);
+}
 
-    convert_dot_to_slash(pszKey, zKey);
+ut_kvp_status_t ut_kvp_setUrlCacheDirectory(const char *pszDirectory)
+{
+    struct stat dirStat;
 
-    // Find the node corresponding to the key
-    node = fy_node_by_path(root, zKey, -1, FYNWF_DONT_FOLLOW);
-    if ( node == NULL )
+    if ((pszDirectory != NULL) &&
+        ((strlen(pszDirectory) >= PATH_MAX - 32) || (stat(pszDirectory, &dirStat) != 0) || !S_ISDIR(dirStat.st_mode)))
     {
-        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
-        return UT_KVP_STATUS_KEY_NOT_FOUND;
+        UT_LOG_ERROR( "Invalid Param [pszDirectory]" );
+        return UT_KVP_STATUS_INVALID_PARAM;
     }
 
-    if (fy_node_is_scalar(node) == false)
+    pthread_mutex_lock(&gUrlCache.lock);
+    if (pszDirectory != NULL)
     {
-        UT_LOG_ERROR("invalid key");
-        return UT_KVP_STATUS_PARSING_ERROR;
+        strcpy(gUrlCache.zDirectory, pszDirectory);
     }
-
-    //Get the string value
-    pString = fy_node_get_scalar0(node);
-    if (pString == NULL)
+    else
     {
-        UT_LOG_ERROR("field not found: UT_KVP_STATUS_KEY_NOT_FOUND");
-        return UT_KVP_STATUS_KEY_NOT_FOUND;
+        gUrlCache.zDirectory[0] = '\0';
     }
+    pthread_mutex_unlock(&gUrlCache.lock);
 
-    strncpy( pszReturnedString, pString, uStringSize );
     return UT_KVP_STATUS_SUCCESS;
 }
 
-uint32_t ut_kvp_getListCount( ut_kvp_instance_t *pInstance, const char *pszKey)
+void ut_kvp_setUrlOffline(bool offline)
 {
-    struct fy_node *node = NULL;
-    struct fy_node *root = NULL;
-    uint32_t count;
-    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
+    pthread_mutex_lock(&gUrlCache.lock);
+    gUrlCache.offline = offline;
+    pthread_mutex_unlock(&gUrlCache.lock);
+}
 
-    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+char* ut_kvp_getData( ut_kvp_instance_t *pInstance )
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    char *value;
 
-    if (pInternal == NULL)
+    value = readData( pInstance );
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static char *readData( ut_kvp_instance_t *pInstance )
+{
+     ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+     char *kvp_yaml_output = NULL;
+
+     if (pInternal == NULL)
     {
-        UT_LOG_ERROR("Invalid instance - pInstance");
-        return 0;
+        return NULL;
     }
 
-    if (pszKey == NULL)
+    if (pInternal->image.pHeader != NULL)
     {
-        UT_LOG_ERROR("Invalid Param - pszKey");
-        return 0;
+        UT_LOG_ERROR("Not available for a compiled image");
+        return NULL;
     }
 
-    if ( pInternal->fy_handle == NULL )
+    if ( pInternal->fy_handle == NULL)
     {
-        UT_LOG_ERROR("No Data File open");
-        return 0;
+        return NULL;
     }
-    // Get the root node
-    root = fy_document_root(pInternal->fy_handle);
-    if ( root == NULL )
+
+    lazyComplete(pInternal);
+    kvp_yaml_output = fy_emit_document_to_string(pInternal->fy_handle, FYECF_DEFAULT);
+    if (kvp_yaml_output == NULL)
     {
-        /* The file has no content that can be decoded.*/
-        UT_LOG_ERROR("Empty document");
-        return 0;
+        UT_LOG_ERROR("Failed to emit YAML document\n");
+        return NULL;
     }
+    return kvp_yaml_output;
+}
 
-    convert_dot_to_slash(pszKey, zKey);
+bool ut_kvp_getBoolField( ut_kvp_instance_t *pInstance, const char *pszKey )
+{
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pField;
+    size_t length;
+    bool value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
 
-    // Find the node corresponding to the key
-    node = fy_node_by_path(root, zKey, -1, FYNWF_DONT_FOLLOW);
-    if ( node == NULL )
+    pField = getScalar(pInstance, pszKey, &length, &pEntry);
+    value = (pField != NULL) ? str_to_bool(pField, length, pEntry) : false;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static unsigned long getUIntField( ut_kvp_instance_t *pInstance, const char *pszKey, unsigned long maxRange )
+{
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pField;
+    size_t length;
+    unsigned long value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pField = getScalar(pInstance, pszKey, &length, &pEntry);
+    value = (pField != NULL) ? convertUIntField(pField, length, maxRange, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint8_t ut_kvp_getUInt8Field( ut_kvp_instance_t *pInstance, const char *pszKey )
+{
+    unsigned long value;
+    value = getUIntField( pInstance, pszKey, UINT8_MAX );
+
+    return (uint8_t)value;
+}
+
+uint16_t ut_kvp_getUInt16Field( ut_kvp_instance_t *pInstance, const char *pszKey )
+{
+    unsigned long value;
+    value = getUIntField( pInstance, pszKey, UINT16_MAX );
+
+    return (uint16_t)value;
+}
+
+uint32_t ut_kvp_getUInt32Field( ut_kvp_instance_t *pInstance, const char *pszKey )
+{
+    unsigned long value;
+    value = getUIntField( pInstance, pszKey, UINT32_MAX );
+
+    return (uint32_t)value;
+}
+
+uint64_t ut_kvp_getUInt64Field( ut_kvp_instance_t *pInstance, const char *pszKey )
+{
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pField;
+    size_t length;
+    uint64_t value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pField = getScalar(pInstance, pszKey, &length, &pEntry);
+    value = (pField != NULL) ? convertUInt64Field(pField, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+float ut_kvp_getFloatField( ut_kvp_instance_t *pInstance, const char *pszKey)
+{
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pField;
+    size_t length;
+    float value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pField = getScalar(pInstance, pszKey, &length, &pEntry);
+    value = (pField != NULL) ? convertFloatField(pField, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+double ut_kvp_getDoubleField( ut_kvp_instance_t *pInstance, const char *pszKey)
+{
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pField;
+    size_t length;
+    double value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pField = getScalar(pInstance, pszKey, &length, &pEntry);
+    value = (pField != NULL) ? convertDoubleField(pField, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+bool ut_kvp_fieldPresent( ut_kvp_instance_t *pInstance, const char *pszKey)
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    bool value;
+
+    value = readFieldPresent( pInstance, pszKey );
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static bool readFieldPresent( ut_kvp_instance_t *pInstance, const char *pszKey )
+{
+    struct fy_node *node = NULL;
+    struct fy_node *root = NULL;
+
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+
+    if (pInternal == NULL)
     {
-        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
-        return 0;
+        UT_LOG_ERROR("Invalid Param - pInternal");
+        return false;
     }
 
-    if (fy_node_is_sequence(node) == false)
+    if (pszKey == NULL)
     {
-        return 0; // Early return on negative check
+        UT_LOG_ERROR("Invalid Param - pszKey");
+        return false;
     }
 
-    count = fy_node_sequence_item_count(node);
-    if (count == -1)
+    if (pInternal->image.pHeader != NULL)
     {
-        UT_LOG_ERROR("fy_node_sequence_item_count() returned error\n");
-        return 0;
+        return (imageFind(&pInternal->image, pszKey) != NULL);
     }
 
-    return count;
+    if ( pInternal->fy_handle == NULL )
+    {
+        UT_LOG_ERROR("No Data File open");
+        return false;
+    }
+    // Get the root node
+    root = fy_document_root(pInternal->fy_handle);
+    if ( root == NULL )
+    {
+        UT_LOG_ERROR("Empty document");
+        return false;
+    }
+
+    // Find the node corresponding to the key
+    node = findNode(pInternal, pszKey);
+    if ( node == NULL )
+    {
+        //UT_LOG_DEBUG("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+        //Commented this out now, will uncomment it once logging module is upgraded
+        return false;
+    }
+
+    return true;
 }
 
-unsigned char* ut_kvp_getDataBytes(ut_kvp_instance_t *pInstance, const char *pszKey, int *size)
+ut_kvp_status_t ut_kvp_getStringField( ut_kvp_instance_t *pInstance, const char *pszKey, char *pszReturnedString, uint32_t uStringSize )
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    ut_kvp_status_t value;
+
+    value = readStringField( pInstance, pszKey, pszReturnedString, uStringSize );
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static ut_kvp_status_t readStringField( ut_kvp_instance_t *pInstance, const char *pszKey, char *pszReturnedString, uint32_t uStringSize )
 {
     struct fy_node *node = NULL;
     struct fy_node *root = NULL;
-    const char *byteString = NULL;
-    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
-    char *token;
-    int byte_count = 0;
-    size_t buffer_size = 16; // Initial buffer size
+    const char *pString = NULL;
+    size_t length = 0;
 
     ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
 
     if (pInternal == NULL)
     {
-        return NULL;
+        return UT_KVP_STATUS_INVALID_INSTANCE;
     }
 
     if (pszKey == NULL)
     {
         UT_LOG_ERROR("Invalid Param - pszKey");
-        return NULL;
+        return UT_KVP_STATUS_NULL_PARAM;
     }
 
-    if (size == NULL)
+    if ( pszReturnedString == NULL )
     {
-        UT_LOG_ERROR("Invalid address passed");
-        return NULL;
+        UT_LOG_ERROR("Invalid Param - pszReturnedString");
+        return UT_KVP_STATUS_NULL_PARAM;
     }
-    *size = 0; // Ensuring size is 0, initially
 
-    if (pInternal->fy_handle == NULL)
+    /* Make sure we populate the returned string with zt before any other action */
+    *pszReturnedString=0;
+    if (pInternal->image.pHeader != NULL)
+    {
+        ut_kvp_status_t status;
+
+        pString = imageScalar(&pInternal->image, imageFind(&pInternal->image, pszKey), pszKey, &length, &status);
+        if (pString != NULL)
+        {
+            copyScalar( pszReturnedString, uStringSize, pString, length );
+        }
+        return status;
+    }
+
+    if ( pInternal->fy_handle == NULL )
     {
         UT_LOG_ERROR("No Data File open");
-        return NULL;
+        return UT_KVP_STATUS_NO_DATA;
     }
     // Get the root node
     root = fy_document_root(pInternal->fy_handle);
-    if (root == NULL)
+    if ( root == NULL )
     {
         UT_LOG_ERROR("Empty document");
-        return NULL;
+        return UT_KVP_STATUS_PARSING_ERROR;
     }
 
-    convert_dot_to_slash(pszKey, zKey);
+    // Find the node corresponding to the key
+    node = findNode(pInternal, pszKey);
+    if ( node == NULL )
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+        return lazyMissStatus(pInternal, pszKey);
+    }
+
+    if (fy_node_is_scalar(node) == false)
+    {
+        UT_LOG_ERROR("invalid key");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    //Get the string value, fy_node_get_scalar0() caches a terminated copy on the node and is not safe for concurrent readers
+    pString = fy_node_get_scalar(node, &length);
+    if (pString == NULL)
+    {
+        UT_LOG_ERROR("field not found: UT_KVP_STATUS_KEY_NOT_FOUND");
+        return UT_KVP_STATUS_KEY_NOT_FOUND;
+    }
+
+    copyScalar( pszReturnedString, uStringSize, pString, length );
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static void copyScalar(char *pszReturnedString, uint32_t uStringSize, const char *pString, size_t length)
+{
+    if (uStringSize == 0)
+    {
+        return;
+    }
+
+    // Truncated to the buffer, always terminated
+    if (length >= uStringSize)
+    {
+        length = uStringSize - 1;
+    }
+    memcpy(pszReturnedString, pString, length);
+    pszReturnedString[length] = '\0';
+}
+
+ut_kvp_status_t ut_kvp_getStringView( ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppString, size_t *pLength )
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    ut_kvp_status_t value;
+
+    value = readStringView( pInstance, pszKey, ppString, pLength );
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static ut_kvp_status_t readStringView( ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppString, size_t *pLength )
+{
+    struct fy_node *node = NULL;
+    const char *pString = NULL;
+    size_t length = 0;
+
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+
+    if (pInternal == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_INSTANCE;
+    }
+
+    if ((pszKey == NULL) || (ppString == NULL) || (pLength == NULL))
+    {
+        UT_LOG_ERROR("Invalid Param - NULL");
+        return UT_KVP_STATUS_NULL_PARAM;
+    }
+
+    *ppString = NULL;
+    *pLength = 0;
+
+    if (pInternal->image.pHeader != NULL)
+    {
+        ut_kvp_status_t status;
+
+        *ppString = imageScalar(&pInternal->image, imageFind(&pInternal->image, pszKey), pszKey, pLength, &status);
+        return status;
+    }
+
+    if ( pInternal->fy_handle == NULL )
+    {
+        UT_LOG_ERROR("No Data File open");
+        return UT_KVP_STATUS_NO_DATA;
+    }
 
     // Find the node corresponding to the key
-    node = fy_node_by_path(root, zKey, -1, FYNWF_DONT_FOLLOW);
-    if (node == NULL)
+    node = findNode(pInternal, pszKey);
+    if ( node == NULL )
     {
         UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
-        return NULL;
+        return lazyMissStatus(pInternal, pszKey);
     }
 
     if (fy_node_is_scalar(node) == false)
     {
         UT_LOG_ERROR("invalid key");
-        return NULL;
+        return UT_KVP_STATUS_PARSING_ERROR;
     }
 
-    // Get the string value
-    byteString = fy_node_get_scalar0(node);
-    if (byteString == NULL)
+    /* Borrowed from the document, released on close */
+    pString = fy_node_get_scalar(node, &length);
+    if (pString == NULL)
     {
         UT_LOG_ERROR("field not found: UT_KVP_STATUS_KEY_NOT_FOUND");
-        return NULL;
+        return UT_KVP_STATUS_KEY_NOT_FOUND;
     }
 
-    unsigned char *output_bytes = (unsigned char *)malloc(buffer_size);
-    if (!output_bytes)
+    *ppString = pString;
+    *pLength = length;
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+ut_kvp_status_t ut_kvp_getFields( ut_kvp_instance_t *pInstance, ut_kvp_field_t *pFields, uint32_t count )
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    ut_kvp_status_t value;
+
+    value = readFields( pInstance, pFields, count );
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static ut_kvp_status_t readFields( ut_kvp_instance_t *pInstance, ut_kvp_field_t *pFields, uint32_t count )
+{
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_status_t result = UT_KVP_STATUS_SUCCESS;
+    ut_kvp_parent_cache_t cache;
+
+    if (pInternal == NULL)
     {
-        UT_LOG_ERROR("Initial memory allocation error");
-        return NULL;
+        return UT_KVP_STATUS_INVALID_INSTANCE;
     }
 
-    char *input_copy = strdup(byteString);
-    if (!input_copy)
+    if (pFields == NULL)
     {
-        UT_LOG_ERROR("Memory allocation error.");
-        free(output_bytes);
-        return NULL;
+        UT_LOG_ERROR("Invalid Param - pFields");
+        return UT_KVP_STATUS_NULL_PARAM;
     }
 
-    token = strtok(input_copy, ", ");
-    while (token != NULL)
+    if (( pInternal->fy_handle == NULL ) && (pInternal->image.pHeader == NULL))
     {
-        // Trim leading/trailing whitespace (if any)
-        while (*token == ' ')
+        UT_LOG_ERROR("No Data File open");
+        for (uint32_t i = 0; i < count; i++)
         {
-            token++;
+            pFields[i].status = UT_KVP_STATUS_NO_DATA;
         }
+        return UT_KVP_STATUS_NO_DATA;
+    }
 
-        char *endptr;
-        unsigned long value;
+    cache.valid = false;
 
-        // Try converting as hexadecimal (starts with "0x")
-        if (strncmp(token, "0x", 2) == 0 || strncmp(token, "0X", 2) == 0)
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ut_kvp_field_t *pField = &pFields[i];
+        struct fy_node *node;
+        ut_kvp_status_t status;
+
+        if ((pField->pszKey == NULL) || (pField->pValue == NULL))
+        {
+            UT_LOG_ERROR("Invalid Param - field %u", i);
+            status = UT_KVP_STATUS_NULL_PARAM;
+        }
+        else if (pInternal->image.pHeader != NULL)
         {
-            value = strtoul(token, &endptr, 16); // Base 16 for hexadecimal
+            const ut_kvp_image_entry_t *pEntry = imageFind(&pInternal->image, pField->pszKey);
+            const char *pString;
+            size_t length;
+
+            pString = imageScalar(&pInternal->image, pEntry, pField->pszKey, &length, &status);
+            if (pString != NULL)
+            {
+                status = storeValue(pField, pString, length, pEntry);
+            }
         }
         else
         {
-            value = strtoul(token, &endptr, 10); // Try decimal
+            node = findSiblingNode(pInternal, pField->pszKey, &cache, &status);
+            if (status == UT_KVP_STATUS_SUCCESS)
+            {
+                status = storeField(pField, node);
+            }
+        }
+
+        pField->status = status;
+        if ((status != UT_KVP_STATUS_SUCCESS) && (result == UT_KVP_STATUS_SUCCESS))
+        {
+            result = status;
         }
+    }
+
+    return result;
+}
+
+uint32_t ut_kvp_getListCount( ut_kvp_instance_t *pInstance, const char *pszKey)
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    uint32_t value;
+
+    value = readListCount( pInstance, pszKey );
+    readUnlock(pLocked);
+
+    return value;
+}
 
-        // Error checking
-        if (*endptr != '\0' || (value == ULONG_MAX && errno == ERANGE) || value > 255)
+static uint32_t readListCount( ut_kvp_instance_t *pInstance, const char *pszKey )
+{
+    struct fy_node *node = NULL;
+    struct fy_node *root = NULL;
+    uint32_t count;
+
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+
+    if (pInternal == NULL)
+    {
+        UT_LOG_ERROR("Invalid instance - pInstance");
+        return 0;
+    }
+
+    if (pszKey == NULL)
+    {
+        UT_LOG_ERROR("Invalid Param - pszKey");
+        return 0;
+    }
+
+    if (pInternal->image.pHeader != NULL)
+    {
+        const ut_kvp_image_entry_t *pEntry = imageFind(&pInternal->image, pszKey);
+
+        if ( pEntry == NULL )
+        {
+            UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+            return 0;
+        }
+        return (pEntry->kind == UT_KVP_IMAGE_KIND_SEQUENCE) ? pEntry->childCount : 0;
+    }
+
+    if ( pInternal->fy_handle == NULL )
+    {
+        UT_LOG_ERROR("No Data File open");
+        return 0;
+    }
+    // Get the root node
+    root = fy_document_root(pInternal->fy_handle);
+    if ( root == NULL )
+    {
+        /* The file has no content that can be decoded.*/
+        UT_LOG_ERROR("Empty document");
+        return 0;
+    }
+
+    // Find the node corresponding to the key
+    node = findNode(pInternal, pszKey);
+    if ( node == NULL )
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+        return 0;
+    }
+
+    if (fy_node_is_sequence(node) == false)
+    {
+        return 0; // Early return on negative check
+    }
+
+    count = fy_node_sequence_item_count(node);
+    if (count == -1)
+    {
+        UT_LOG_ERROR("fy_node_sequence_item_count() returned error\n");
+        return 0;
+    }
+
+    return count;
+}
+
+ut_kvp_status_t ut_kvp_getUInt32Array( ut_kvp_instance_t *pInstance, const char *pszKey, uint32_t *pValues, uint32_t maxCount, uint32_t *pCount )
+{
+    return getArray(pInstance, pszKey, UT_KVP_FIELD_TYPE_UINT32, pValues, maxCount, pCount);
+}
+
+ut_kvp_status_t ut_kvp_getUInt64Array( ut_kvp_instance_t *pInstance, const char *pszKey, uint64_t *pValues, uint32_t maxCount, uint32_t *pCount )
+{
+    return getArray(pInstance, pszKey, UT_KVP_FIELD_TYPE_UINT64, pValues, maxCount, pCount);
+}
+
+ut_kvp_status_t ut_kvp_getDoubleArray( ut_kvp_instance_t *pInstance, const char *pszKey, double *pValues, uint32_t maxCount, uint32_t *pCount )
+{
+    return getArray(pInstance, pszKey, UT_KVP_FIELD_TYPE_DOUBLE, pValues, maxCount, pCount);
+}
+
+ut_kvp_status_t ut_kvp_getStringArray( ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppStrings, size_t *pLengths, uint32_t maxCount, uint32_t *pCount )
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    ut_kvp_status_t value;
+
+    value = readStringArray( pInstance, pszKey, ppStrings, pLengths, maxCount, pCount );
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static ut_kvp_status_t readStringArray( ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppStrings, size_t *pLengths, uint32_t maxCount, uint32_t *pCount )
+{
+    ut_kvp_status_t status;
+    ut_kvp_status_t result = UT_KVP_STATUS_SUCCESS;
+    const ut_kvp_image_t *pImage = NULL;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    struct fy_node *node = NULL;
+    struct fy_node *item;
+    void *iter = NULL;
+    uint32_t count = 0;
+
+    if ((maxCount > 0) && (pLengths == NULL))
+    {
+        UT_LOG_ERROR("Invalid Param - pLengths");
+        return UT_KVP_STATUS_NULL_PARAM;
+    }
+
+    status = getSequence(pInstance, pszKey, ppStrings, maxCount, pCount, &node, &pImage, &pEntry);
+    if ((status != UT_KVP_STATUS_SUCCESS) || (maxCount == 0))
+    {
+        return status;
+    }
+
+    while (count < maxCount)
+    {
+        if (pEntry != NULL)
+        {
+            if (count >= pEntry->childCount)
+            {
+                break;
+            }
+            ppStrings[count] = imageValue(pImage, imageChild(pImage, pEntry, count), &pLengths[count]);
+        }
+        else
+        {
+            if ((item = fy_node_sequence_iterate(node, &iter)) == NULL)
+            {
+                break;
+            }
+            item = followAlias(item);
+            ppStrings[count] = fy_node_get_scalar(item, &pLengths[count]);
+        }
+        if (ppStrings[count] == NULL)
+        {
+            UT_LOG_ERROR("element [%u] of [%s] is not a scalar", count, pszKey);
+            pLengths[count] = 0;
+            result = UT_KVP_STATUS_PARSING_ERROR;
+        }
+        count++;
+    }
+
+    if ((result == UT_KVP_STATUS_SUCCESS) && (*pCount > maxCount))
+    {
+        UT_LOG_ERROR("buffer too small for [%s], %u of %u elements read", pszKey, maxCount, *pCount);
+        result = UT_KVP_STATUS_INVALID_PARAM;
+    }
+
+    return result;
+}
+
+unsigned char* ut_kvp_getDataBytes(ut_kvp_instance_t *pInstance, const char *pszKey, int *size)
+{
+    unsigned char *output_bytes;
+    uint32_t byte_count = 0;
+    const char *byteString = NULL;
+    size_t length = 0;
+    ut_kvp_status_t status;
+    ut_kvp_instance_internal_t *pLocked;
+
+    if (size == NULL)
+    {
+        UT_LOG_ERROR("Invalid address passed");
+        return NULL;
+    }
+    *size = 0; // Ensuring size is 0, initially
+
+    /* Found once, both passes decode the same scalar even if a concurrent instance publishes meanwhile */
+    pLocked = readLock(pInstance);
+    status = readDataBytesString(pInstance, pszKey, &byteString, &length);
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        readUnlock(pLocked);
+        return NULL;
+    }
+
+    // Size query first, so the output is allocated once at its final size
+    status = decodeDataBytes(byteString, length, NULL, 0, &byte_count);
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        readUnlock(pLocked);
+        return NULL;
+    }
+
+    output_bytes = (unsigned char *)malloc((byte_count > 0) ? byte_count : 1);
+    if (!output_bytes)
+    {
+        readUnlock(pLocked);
+        UT_LOG_ERROR("Memory allocation error");
+        return NULL;
+    }
+
+    status = decodeDataBytes(byteString, length, output_bytes, byte_count, &byte_count);
+    readUnlock(pLocked);
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        free(output_bytes);
+        return NULL;
+    }
+
+    *size = (int)byte_count;
+    return output_bytes;
+}
+
+ut_kvp_status_t ut_kvp_getDataBytesToBuffer(ut_kvp_instance_t *pInstance, const char *pszKey, unsigned char *pBuffer, uint32_t bufferSize, uint32_t *pSize)
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    ut_kvp_status_t value;
+
+    value = readDataBytesToBuffer(pInstance, pszKey, pBuffer, bufferSize, pSize);
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static ut_kvp_status_t readDataBytesToBuffer(ut_kvp_instance_t *pInstance, const char *pszKey, unsigned char *pBuffer, uint32_t bufferSize, uint32_t *pSize)
+{
+    const char *byteString = NULL;
+    size_t length = 0;
+    ut_kvp_status_t status;
+
+    if ((pSize == NULL) || ((pBuffer == NULL) && (bufferSize > 0)))
+    {
+        UT_LOG_ERROR("Invalid Param - NULL");
+        return UT_KVP_STATUS_NULL_PARAM;
+    }
+    *pSize = 0;
+
+    status = readDataBytesString(pInstance, pszKey, &byteString, &length);
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    status = decodeDataBytes(byteString, length, pBuffer, bufferSize, pSize);
+    if ((status == UT_KVP_STATUS_SUCCESS) && (pBuffer != NULL) && (*pSize > bufferSize))
+    {
+        UT_LOG_ERROR("buffer too small for [%s], %u bytes required", pszKey, *pSize);
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+
+    return status;
+}
+
+static ut_kvp_status_t readDataBytesString(ut_kvp_instance_t *pInstance, const char *pszKey, const char **ppString, size_t *pLength)
+{
+    struct fy_node *node = NULL;
+    ut_kvp_status_t status;
+
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+
+    if (pInternal == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_INSTANCE;
+    }
+
+    if (pszKey == NULL)
+    {
+        UT_LOG_ERROR("Invalid Param - NULL");
+        return UT_KVP_STATUS_NULL_PARAM;
+    }
+
+    if (pInternal->image.pHeader != NULL)
+    {
+        *ppString = imageScalar(&pInternal->image, imageFind(&pInternal->image, pszKey), pszKey, pLength, &status);
+        return status;
+    }
+
+    if (pInternal->fy_handle == NULL)
+    {
+        UT_LOG_ERROR("No Data File open");
+        return UT_KVP_STATUS_NO_DATA;
+    }
+
+    // Find the node corresponding to the key
+    node = findNode(pInternal, pszKey);
+    if (node == NULL)
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+        return lazyMissStatus(pInternal, pszKey);
+    }
+
+    if (fy_node_is_scalar(node) == false)
+    {
+        UT_LOG_ERROR("invalid key");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    /* Pointer and length, fy_node_get_scalar0() may allocate and cache a terminated copy */
+    *ppString = fy_node_get_scalar(node, pLength);
+    if (*ppString == NULL)
+    {
+        UT_LOG_ERROR("field not found: UT_KVP_STATUS_KEY_NOT_FOUND");
+        return UT_KVP_STATUS_KEY_NOT_FOUND;
+    }
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+
+ut_kvp_key_t *ut_kvp_compileKey(ut_kvp_instance_t *pInstance, const char *pszKey)
+{
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_key_internal_t *pKeyInternal;
+
+    if (pInternal == NULL)
+    {
+        return NULL;
+    }
+
+    if (pszKey == NULL)
+    {
+        UT_LOG_ERROR("Invalid Param - pszKey");
+        return NULL;
+    }
+
+    if (strlen(pszKey) >= UT_KVP_MAX_ELEMENT_SIZE)
+    {
+        UT_LOG_ERROR("Key too long [%s]", pszKey);
+        return NULL;
+    }
+
+    pKeyInternal = malloc(sizeof(ut_kvp_key_internal_t));
+    if (pKeyInternal == NULL)
+    {
+        UT_LOG_ERROR("Memory allocation error");
+        return NULL;
+    }
+
+    memset(pKeyInternal, 0, sizeof(ut_kvp_key_internal_t));
+    pKeyInternal->magic = UT_KVP_KEY_MAGIC;
+    pKeyInternal->pInternal = snapshotOwner(pInternal);
+    convert_dot_to_slash(pszKey, pKeyInternal->zKey);
+
+    return (ut_kvp_key_t *)pKeyInternal;
+}
+
+void ut_kvp_freeKey(ut_kvp_key_t *pKey)
+{
+    ut_kvp_key_internal_t *pKeyInternal = (ut_kvp_key_internal_t *)pKey;
+
+    if ((pKeyInternal == NULL) || (pKeyInternal->magic != UT_KVP_KEY_MAGIC))
+    {
+        UT_LOG_ERROR("Invalid Handle - pKey");
+        return;
+    }
+
+    memset(pKeyInternal, 0, sizeof(ut_kvp_key_internal_t));
+    free(pKeyInternal);
+}
+
+bool ut_kvp_getBoolByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    bool value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pString = getKeyScalar(pInstance, pKey, &length, &pEntry);
+    value = (pString != NULL) ? str_to_bool(pString, length, pEntry) : false;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint8_t ut_kvp_getUInt8ByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    uint8_t value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pString = getKeyScalar(pInstance, pKey, &length, &pEntry);
+    value = (pString != NULL) ? (uint8_t)convertUIntField(pString, length, UINT8_MAX, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint16_t ut_kvp_getUInt16ByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    uint16_t value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pString = getKeyScalar(pInstance, pKey, &length, &pEntry);
+    value = (pString != NULL) ? (uint16_t)convertUIntField(pString, length, UINT16_MAX, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint32_t ut_kvp_getUInt32ByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    uint32_t value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pString = getKeyScalar(pInstance, pKey, &length, &pEntry);
+    value = (pString != NULL) ? (uint32_t)convertUIntField(pString, length, UINT32_MAX, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint64_t ut_kvp_getUInt64ByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    uint64_t value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pString = getKeyScalar(pInstance, pKey, &length, &pEntry);
+    value = (pString != NULL) ? convertUInt64Field(pString, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+float ut_kvp_getFloatByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    float value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pString = getKeyScalar(pInstance, pKey, &length, &pEntry);
+    value = (pString != NULL) ? convertFloatField(pString, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+double ut_kvp_getDoubleByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    double value;
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+
+    pString = getKeyScalar(pInstance, pKey, &length, &pEntry);
+    value = (pString != NULL) ? convertDoubleField(pString, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+ut_kvp_status_t ut_kvp_getStringByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey, char *pszReturnedString, uint32_t uStringSize)
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    ut_kvp_status_t value;
+
+    value = readStringByHandle(pInstance, pKey, pszReturnedString, uStringSize);
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static ut_kvp_status_t readStringByHandle(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey, char *pszReturnedString, uint32_t uStringSize)
+{
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_key_internal_t *pKeyInternal;
+    struct fy_node *node;
+    const char *pString;
+    size_t length = 0;
+
+    if (pInternal == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_INSTANCE;
+    }
+
+    if ( pszReturnedString == NULL )
+    {
+        UT_LOG_ERROR("Invalid Param - pszReturnedString");
+        return UT_KVP_STATUS_NULL_PARAM;
+    }
+
+    /* Make sure we populate the returned string with zt before any other action */
+    *pszReturnedString=0;
+
+    if (pKey == NULL)
+    {
+        UT_LOG_ERROR("Invalid Param - pKey");
+        return UT_KVP_STATUS_NULL_PARAM;
+    }
+
+    pKeyInternal = validateKey(pInternal, pKey);
+    if (pKeyInternal == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+
+    if (pInternal->image.pHeader != NULL)
+    {
+        ut_kvp_status_t status;
+
+        pString = imageScalar(&pInternal->image, resolveImageKey(pInternal, pKeyInternal), pKeyInternal->zKey, &length, &status);
+        if (pString != NULL)
+        {
+            copyScalar( pszReturnedString, uStringSize, pString, length );
+        }
+        return status;
+    }
+
+    if ( pInternal->fy_handle == NULL )
+    {
+        UT_LOG_ERROR("No Data File open");
+        return UT_KVP_STATUS_NO_DATA;
+    }
+
+    node = resolveKey(pInternal, pKeyInternal);
+    if ( node == NULL )
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pKeyInternal->zKey);
+        return lazyMissStatus(pInternal, pKeyInternal->zKey);
+    }
+
+    if (fy_node_is_scalar(node) == false)
+    {
+        UT_LOG_ERROR("invalid key");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    /* Pointer and length, as readStringField() */
+    pString = fy_node_get_scalar(node, &length);
+    if (pString == NULL)
+    {
+        UT_LOG_ERROR("field not found: UT_KVP_STATUS_KEY_NOT_FOUND");
+        return UT_KVP_STATUS_KEY_NOT_FOUND;
+    }
+
+    copyScalar( pszReturnedString, uStringSize, pString, length );
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+ut_kvp_iterator_t *ut_kvp_iteratorBegin(ut_kvp_instance_t *pInstance, const char *pszKey)
+{
+    ut_kvp_instance_internal_t *pLocked = readLock(pInstance);
+    ut_kvp_iterator_t *value;
+
+    value = readIteratorBegin(pInstance, pszKey);
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static ut_kvp_iterator_t *readIteratorBegin(ut_kvp_instance_t *pInstance, const char *pszKey)
+{
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_iterator_internal_t *pIteratorInternal;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    struct fy_node *node = NULL;
+
+    if (pInternal == NULL)
+    {
+        return NULL;
+    }
+
+    if (pszKey == NULL)
+    {
+        UT_LOG_ERROR("Invalid Param - pszKey");
+        return NULL;
+    }
+
+    if (pInternal->image.pHeader != NULL)
+    {
+        pEntry = imageFind(&pInternal->image, pszKey);
+        if ( pEntry == NULL )
+        {
+            UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+            return NULL;
+        }
+
+        if ((pEntry->kind != UT_KVP_IMAGE_KIND_MAPPING) && (pEntry->kind != UT_KVP_IMAGE_KIND_SEQUENCE))
+        {
+            UT_LOG_ERROR("key [%s] is not a mapping or sequence", pszKey);
+            return NULL;
+        }
+    }
+    else
+    {
+        if ( pInternal->fy_handle == NULL )
+        {
+            UT_LOG_ERROR("No Data File open");
+            return NULL;
+        }
+
+        node = findNode(pInternal, pszKey);
+        if ( node == NULL )
+        {
+            UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+            return NULL;
+        }
+
+        if ((fy_node_is_mapping(node) == false) && (fy_node_is_sequence(node) == false))
+        {
+            UT_LOG_ERROR("key [%s] is not a mapping or sequence", pszKey);
+            return NULL;
+        }
+    }
+
+    pIteratorInternal = malloc(sizeof(ut_kvp_iterator_internal_t));
+    if (pIteratorInternal == NULL)
+    {
+        UT_LOG_ERROR("Memory allocation error");
+        return NULL;
+    }
+
+    memset(pIteratorInternal, 0, sizeof(ut_kvp_iterator_internal_t));
+    pIteratorInternal->magic = UT_KVP_ITERATOR_MAGIC;
+    pIteratorInternal->pInternal = snapshotOwner(pInternal);
+    pIteratorInternal->generation = pInternal->generation;
+    pIteratorInternal->container = node;
+    pIteratorInternal->pContainerEntry = pEntry;
+
+    return (ut_kvp_iterator_t *)pIteratorInternal;
+}
+
+bool ut_kvp_iteratorNext(ut_kvp_iterator_t *pIterator)
+{
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+    bool value;
+
+    value = readIteratorNext(pIterator);
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static bool readIteratorNext(ut_kvp_iterator_t *pIterator)
+{
+    ut_kvp_iterator_internal_t *pIteratorInternal = validateIterator(pIterator);
+    ut_kvp_instance_internal_t *pInternal;
+    bool first;
+
+    if (pIteratorInternal == NULL)
+    {
+        return false;
+    }
+
+    if (pIteratorInternal->done == true)
+    {
+        return false;
+    }
+
+    first = ((pIteratorInternal->iter == NULL) && (pIteratorInternal->pChildEntry == NULL));
+
+    /* Generations are never reused, a match means the snapshot holding the container */
+    pInternal = validateInstance((ut_kvp_instance_t *)pIteratorInternal->pInternal);
+    if ((pInternal == NULL) || (pIteratorInternal->generation != pInternal->generation))
+    {
+        UT_LOG_ERROR("Instance was re-opened or closed, iteration ended");
+        pIteratorInternal->child = NULL;
+        pIteratorInternal->key = NULL;
+        pIteratorInternal->pChildEntry = NULL;
+        pIteratorInternal->done = true;
+        return false;
+    }
+
+    if (pIteratorInternal->pContainerEntry != NULL)
+    {
+        const ut_kvp_image_entry_t *pContainer = pIteratorInternal->pContainerEntry;
+        uint32_t position = (first == true) ? 0 : (pIteratorInternal->index + 1);
+
+        /* Children are listed in document order, the position is all the state needed */
+        pIteratorInternal->done = (position >= pContainer->childCount);
+        pIteratorInternal->pChildEntry = (pIteratorInternal->done == false) ? imageChild(&pInternal->image, pContainer, position) : NULL;
+    }
+    else if (fy_node_is_mapping(pIteratorInternal->container))
+    {
+        struct fy_node_pair *pair = fy_node_mapping_iterate(pIteratorInternal->container, &pIteratorInternal->iter);
+
+        /* An empty value leaves child NULL without ending the mapping */
+        pIteratorInternal->done = (pair == NULL);
+        pIteratorInternal->key = (pair != NULL) ? fy_node_pair_key(pair) : NULL;
+        pIteratorInternal->child = (pair != NULL) ? followAlias(fy_node_pair_value(pair)) : NULL;
+    }
+    else
+    {
+        pIteratorInternal->child = followAlias(fy_node_sequence_iterate(pIteratorInternal->container, &pIteratorInternal->iter));
+        pIteratorInternal->done = (pIteratorInternal->child == NULL);
+    }
+
+    if (pIteratorInternal->done == true)
+    {
+        pIteratorInternal->key = NULL;
+        pIteratorInternal->child = NULL;
+        pIteratorInternal->pChildEntry = NULL;
+        return false;
+    }
+
+    if (first == false)
+    {
+        pIteratorInternal->index++;
+    }
+
+    return true;
+}
+
+void ut_kvp_iteratorEnd(ut_kvp_iterator_t *pIterator)
+{
+    ut_kvp_iterator_internal_t *pIteratorInternal = (ut_kvp_iterator_internal_t *)pIterator;
+
+    if ((pIteratorInternal == NULL) || (pIteratorInternal->magic != UT_KVP_ITERATOR_MAGIC))
+    {
+        UT_LOG_ERROR("Invalid Handle - pIterator");
+        return;
+    }
+
+    memset(pIteratorInternal, 0, sizeof(ut_kvp_iterator_internal_t));
+    free(pIteratorInternal);
+}
+
+uint32_t ut_kvp_iteratorGetIndex(ut_kvp_iterator_t *pIterator)
+{
+    ut_kvp_iterator_internal_t *pIteratorInternal = validateIterator(pIterator);
+
+    if (pIteratorInternal == NULL)
+    {
+        return 0;
+    }
+
+    return pIteratorInternal->index;
+}
+
+const char *ut_kvp_iteratorGetName(ut_kvp_iterator_t *pIterator, size_t *pLength)
+{
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+    const char *value;
+
+    value = readIteratorName(pIterator, pLength);
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static const char *readIteratorName(ut_kvp_iterator_t *pIterator, size_t *pLength)
+{
+    ut_kvp_iterator_internal_t *pIteratorInternal = validateIterator(pIterator);
+    ut_kvp_instance_internal_t *pInternal;
+
+    if ((pIteratorInternal == NULL) || (pLength == NULL))
+    {
+        return NULL;
+    }
+
+    *pLength = 0;
+    pInternal = validateInstance((ut_kvp_instance_t *)pIteratorInternal->pInternal);
+    if ((pInternal == NULL) || (pIteratorInternal->generation != pInternal->generation))
+    {
+        return NULL;
+    }
+
+    if (pIteratorInternal->pChildEntry != NULL)
+    {
+        if ((pIteratorInternal->pChildEntry->flags & UT_KVP_IMAGE_FLAG_NAMED) == 0)
+        {
+            return NULL;
+        }
+        *pLength = pIteratorInternal->pChildEntry->nameLength;
+        return &pInternal->image.pPool[pIteratorInternal->pChildEntry->nameOffset];
+    }
+
+    if (pIteratorInternal->key == NULL)
+    {
+        return NULL;
+    }
+
+    return fy_node_get_scalar(pIteratorInternal->key, pLength);
+}
+
+bool ut_kvp_iteratorGetBool(ut_kvp_iterator_t *pIterator)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    bool value;
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+
+    pString = getIteratorScalar(pIterator, &length, &pEntry);
+    value = (pString != NULL) ? str_to_bool(pString, length, pEntry) : false;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint8_t ut_kvp_iteratorGetUInt8(ut_kvp_iterator_t *pIterator)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    uint8_t value;
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+
+    pString = getIteratorScalar(pIterator, &length, &pEntry);
+    value = (pString != NULL) ? (uint8_t)convertUIntField(pString, length, UINT8_MAX, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint16_t ut_kvp_iteratorGetUInt16(ut_kvp_iterator_t *pIterator)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    uint16_t value;
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+
+    pString = getIteratorScalar(pIterator, &length, &pEntry);
+    value = (pString != NULL) ? (uint16_t)convertUIntField(pString, length, UINT16_MAX, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint32_t ut_kvp_iteratorGetUInt32(ut_kvp_iterator_t *pIterator)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    uint32_t value;
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+
+    pString = getIteratorScalar(pIterator, &length, &pEntry);
+    value = (pString != NULL) ? (uint32_t)convertUIntField(pString, length, UINT32_MAX, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+uint64_t ut_kvp_iteratorGetUInt64(ut_kvp_iterator_t *pIterator)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    uint64_t value;
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+
+    pString = getIteratorScalar(pIterator, &length, &pEntry);
+    value = (pString != NULL) ? convertUInt64Field(pString, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+float ut_kvp_iteratorGetFloat(ut_kvp_iterator_t *pIterator)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    float value;
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+
+    pString = getIteratorScalar(pIterator, &length, &pEntry);
+    value = (pString != NULL) ? convertFloatField(pString, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+double ut_kvp_iteratorGetDouble(ut_kvp_iterator_t *pIterator)
+{
+    size_t length;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    const char *pString;
+    double value;
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+
+    pString = getIteratorScalar(pIterator, &length, &pEntry);
+    value = (pString != NULL) ? convertDoubleField(pString, length, pEntry) : 0;
+    readUnlock(pLocked);
+
+    return value;
+}
+
+ut_kvp_status_t ut_kvp_iteratorGetStringView(ut_kvp_iterator_t *pIterator, const char **ppString, size_t *pLength)
+{
+    ut_kvp_instance_internal_t *pLocked = iteratorReadLock(pIterator);
+    ut_kvp_status_t value;
+
+    value = readIteratorStringView(pIterator, ppString, pLength);
+    readUnlock(pLocked);
+
+    return value;
+}
+
+static ut_kvp_status_t readIteratorStringView(ut_kvp_iterator_t *pIterator, const char **ppString, size_t *pLength)
+{
+    ut_kvp_iterator_internal_t *pIteratorInternal = validateIterator(pIterator);
+    ut_kvp_instance_internal_t *pInternal;
+    const char *pString;
+    size_t length = 0;
+
+    if (pIteratorInternal == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+
+    if ((ppString == NULL) || (pLength == NULL))
+    {
+        UT_LOG_ERROR("Invalid Param - NULL");
+        return UT_KVP_STATUS_NULL_PARAM;
+    }
+
+    *ppString = NULL;
+    *pLength = 0;
+
+    pInternal = validateInstance((ut_kvp_instance_t *)pIteratorInternal->pInternal);
+    if (((pIteratorInternal->iter == NULL) && (pIteratorInternal->pChildEntry == NULL)) || (pIteratorInternal->done == true) ||
+        (pInternal == NULL) || (pIteratorInternal->generation != pInternal->generation))
+    {
+        UT_LOG_ERROR("Iterator is not on a child");
+        return UT_KVP_STATUS_NO_DATA;
+    }
+
+    if (pIteratorInternal->pChildEntry != NULL)
+    {
+        ut_kvp_status_t status;
+
+        *ppString = imageScalar(&pInternal->image, pIteratorInternal->pChildEntry, "", pLength, &status);
+        return status;
+    }
+
+    if ((pIteratorInternal->child == NULL) || (fy_node_is_scalar(pIteratorInternal->child) == false))
+    {
+        UT_LOG_ERROR("invalid key");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    pString = fy_node_get_scalar(pIteratorInternal->child, &length);
+    if (pString == NULL)
+    {
+        UT_LOG_ERROR("field not found: UT_KVP_STATUS_KEY_NOT_FOUND");
+        return UT_KVP_STATUS_KEY_NOT_FOUND;
+    }
+
+    *ppString = pString;
+    *pLength = length;
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+/** Static Functions */
+static ut_kvp_instance_internal_t *validateInstance(ut_kvp_instance_t *pInstance)
+{
+    ut_kvp_instance_internal_t *pInternal = validateOwner(pInstance);
+
+    if (pInternal == NULL)
+    {
+        return NULL;
+    }
+
+    /* Getters read the published snapshot, never the instance a writer may be replacing it in */
+    if (pInternal->flags & UT_KVP_FLAG_CONCURRENT)
+    {
+        return snapshotAcquire(pInternal);
+    }
+
+    return pInternal;
+}
+
+static ut_kvp_instance_internal_t *validateOwner(ut_kvp_instance_t *pInstance)
+{
+    ut_kvp_instance_internal_t *pInternal = (ut_kvp_instance_internal_t *)pInstance;
+
+    if (pInstance == NULL)
+    {
+        UT_LOG_ERROR("Invalid Handle");
+        return NULL;
+    }
+
+    if (pInternal->magic != UT_KVP_MAGIC)
+    {
+        UT_LOG_ERROR("Invalid Handle - magic failure");
+        return NULL;
+    }
+
+    return pInternal;
+}
+
+static ut_kvp_instance_internal_t *snapshotAcquire(ut_kvp_instance_internal_t *pOwner)
+{
+    ut_kvp_hazard_t *pHazard = hazardSlot();
+    ut_kvp_instance_internal_t *pSnapshot;
+
+    if (pHazard == NULL)
+    {
+        return NULL;
+    }
+
+    // Announce the snapshot, then check it is still the published one, a writer that swapped it
+    // out in between may not have seen the hazard and the load is retried
+    do
+    {
+        pSnapshot = __atomic_load_n(&pOwner->publish.pCurrent, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&pHazard->pSnapshot, pSnapshot, __ATOMIC_SEQ_CST);
+    } while (pSnapshot != __atomic_load_n(&pOwner->publish.pCurrent, __ATOMIC_SEQ_CST));
+
+    return pSnapshot;
+}
+
+static ut_kvp_instance_internal_t *snapshotCreate(ut_kvp_instance_internal_t *pOwner)
+{
+    ut_kvp_instance_internal_t *pSnapshot;
+
+    pSnapshot = (ut_kvp_instance_internal_t *)ut_kvp_createInstanceWithFlags(pOwner->flags & ~UT_KVP_FLAG_CONCURRENT);
+    if (pSnapshot == NULL)
+    {
+        UT_LOG_ERROR("Memory allocation error");
+        return NULL;
+    }
+
+    pSnapshot->includeBudgetMs = pOwner->includeBudgetMs;
+    pSnapshot->connectTimeoutMs = pOwner->connectTimeoutMs;
+    pSnapshot->transferTimeoutMs = pOwner->transferTimeoutMs;
+    pSnapshot->maxIncludeDepth = pOwner->maxIncludeDepth;
+    pSnapshot->pOwner = pOwner;
+
+    /* Carries on from every earlier snapshot, so no two of them ever share a generation */
+    pSnapshot->generation = ++pOwner->generation;
+
+    return pSnapshot;
+}
+
+static ut_kvp_instance_internal_t *snapshotOwner(ut_kvp_instance_internal_t *pInternal)
+{
+    return (pInternal->pOwner != NULL) ? pInternal->pOwner : pInternal;
+}
+
+static ut_kvp_status_t publishWrite(ut_kvp_instance_internal_t *pOwner, const ut_kvp_publish_request_t *pRequest)
+{
+    ut_kvp_status_t status;
+
+    publishLock(pOwner);
+    if (pOwner->flags & UT_KVP_FLAG_CONCURRENT)
+    {
+        status = publishLocked(pOwner, pRequest);
+    }
+    else
+    {
+        /* UT_KVP_FLAG_THREADSAFE, the write runs in place with readers shut out */
+        status = publishApply(pOwner, pRequest);
+    }
+    publishUnlock(pOwner);
+
+    return status;
+}
+
+static ut_kvp_status_t publishLocked(ut_kvp_instance_internal_t *pOwner, const ut_kvp_publish_request_t *pRequest)
+{
+    ut_kvp_publish_t *pPublish = &pOwner->publish;
+    ut_kvp_instance_internal_t *pSnapshot;
+    ut_kvp_instance_internal_t *pPrevious;
+    ut_kvp_status_t status;
+
+    if (pPublish->retiredCount == pPublish->retiredCapacity)
+    {
+        uint32_t newCapacity = (pPublish->retiredCapacity == 0) ? 8 : (pPublish->retiredCapacity * 2);
+        ut_kvp_instance_internal_t **ppRetired = realloc(pPublish->ppRetired, newCapacity * sizeof(ut_kvp_instance_internal_t *));
+
+        /* Checked up front, a published snapshot must always find a place to retire to */
+        if (ppRetired == NULL)
+        {
+            UT_LOG_ERROR("Memory allocation error");
+            return UT_KVP_STATUS_INVALID_PARAM;
+        }
+        pPublish->ppRetired = ppRetired;
+        pPublish->retiredCapacity = newCapacity;
+    }
+
+    pSnapshot = snapshotCreate(pOwner);
+    if (pSnapshot == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+
+    // The write runs on a snapshot no reader can see yet, exactly as it would on a plain instance
+    status = publishApply(pSnapshot, pRequest);
+    pOwner->generation = pSnapshot->generation;
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        ut_kvp_destroyInstance((ut_kvp_instance_t *)pSnapshot);
+        return status;
+    }
+
+    /* The files behind the new document are followed by the instance, which outlives its snapshots */
+    watchFilesFree(pOwner->watch.ppFiles, pOwner->watch.fileCount);
+    pOwner->watch.ppFiles = pSnapshot->watch.ppFiles;
+    pOwner->watch.fileCount = pSnapshot->watch.fileCount;
+    pOwner->watch.hasSource = pSnapshot->watch.hasSource;
+    pSnapshot->watch.ppFiles = NULL;
+    pSnapshot->watch.fileCount = 0;
+    pSnapshot->watch.hasSource = false;
+    if (pOwner->watch.fd >= 0)
+    {
+        watchRegister(pOwner);
+    }
+
+    pPrevious = __atomic_exchange_n(&pPublish->pCurrent, pSnapshot, __ATOMIC_SEQ_CST);
+    pPublish->ppRetired[pPublish->retiredCount++] = pPrevious;
+    publishReclaim(pPublish);
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static ut_kvp_status_t publishApply(ut_kvp_instance_internal_t *pSnapshot, const ut_kvp_publish_request_t *pRequest)
+{
+    ut_kvp_instance_t *pInstance = (ut_kvp_instance_t *)pSnapshot;
+
+    switch (pRequest->op)
+    {
+        case UT_KVP_PUBLISH_OPEN:
+            return ut_kvp_open(pInstance, pRequest->pszFile);
+        case UT_KVP_PUBLISH_OPEN_MEMORY:
+            return ut_kvp_openMemory(pInstance, pRequest->pData, pRequest->length);
+        case UT_KVP_PUBLISH_OPEN_MAPPED:
+            return ut_kvp_openMapped(pInstance, pRequest->pszFile);
+        case UT_KVP_PUBLISH_OPEN_BUNDLE:
+            return ut_kvp_openBundle(pInstance, pRequest->pszFile, pRequest->pszProfile);
+        case UT_KVP_PUBLISH_OPEN_IMAGE:
+            return ut_kvp_openImage(pInstance, pRequest->pszFile);
+        case UT_KVP_PUBLISH_RELOAD:
+            return adoptDocument(pSnapshot, fy_document_build_from_file(NULL, pRequest->pszFile), pRequest->pszFile, NULL);
+        default:
+            /* UT_KVP_PUBLISH_CLOSE, an empty snapshot */
+            return UT_KVP_STATUS_SUCCESS;
+    }
+}
+
+static void publishReclaim(ut_kvp_publish_t *pPublish)
+{
+    uint32_t kept = 0;
+
+    // A thread holds at most one hazard, so at most one retired snapshot per reading thread survives
+    for (uint32_t i = 0; i < pPublish->retiredCount; i++)
+    {
+        if (hazardHeld(pPublish->ppRetired[i]))
+        {
+            pPublish->ppRetired[kept++] = pPublish->ppRetired[i];
+        }
+        else
+        {
+            ut_kvp_destroyInstance((ut_kvp_instance_t *)pPublish->ppRetired[i]);
+        }
+    }
+    pPublish->retiredCount = kept;
+}
+
+static void publishFree(ut_kvp_publish_t *pPublish)
+{
+    for (uint32_t i = 0; i < pPublish->retiredCount; i++)
+    {
+        ut_kvp_destroyInstance((ut_kvp_instance_t *)pPublish->ppRetired[i]);
+    }
+    free(pPublish->ppRetired);
+    ut_kvp_destroyInstance((ut_kvp_instance_t *)pPublish->pCurrent);
+    pthread_mutex_destroy(&pPublish->writeLock);
+    memset(pPublish, 0, sizeof(ut_kvp_publish_t));
+}
+
+static void publishLock(ut_kvp_instance_internal_t *pInternal)
+{
+    if (pInternal->flags & UT_KVP_FLAG_CONCURRENT)
+    {
+        pthread_mutex_lock(&pInternal->publish.writeLock);
+    }
+    else if (pInternal->flags & UT_KVP_FLAG_THREADSAFE)
+    {
+        // Opens close the instance on failure, the writer already holds the lock then
+        if (gpThreadWriting == pInternal)
+        {
+            pInternal->writeDepth++;
+            return;
+        }
+        pthread_rwlock_wrlock(&pInternal->lock);
+        gpThreadWriting = pInternal;
+        pInternal->writeDepth = 1;
+    }
+}
+
+static void publishUnlock(ut_kvp_instance_internal_t *pInternal)
+{
+    if (pInternal->flags & UT_KVP_FLAG_CONCURRENT)
+    {
+        pthread_mutex_unlock(&pInternal->publish.writeLock);
+    }
+    else if ((pInternal->flags & UT_KVP_FLAG_THREADSAFE) && (--pInternal->writeDepth == 0))
+    {
+        gpThreadWriting = NULL;
+        pthread_rwlock_unlock(&pInternal->lock);
+    }
+}
+
+static bool publishRequired(ut_kvp_instance_internal_t *pInternal)
+{
+    if (pInternal->flags & UT_KVP_FLAG_CONCURRENT)
+    {
+        return true;
+    }
+
+    /* Replayed by publishWrite() with the lock held, it then runs as on a plain instance */
+    return ((pInternal->flags & UT_KVP_FLAG_THREADSAFE) && (gpThreadWriting != pInternal));
+}
+
+static ut_kvp_instance_internal_t *readLock(ut_kvp_instance_t *pInstance)
+{
+    ut_kvp_instance_internal_t *pInternal = (ut_kvp_instance_internal_t *)pInstance;
+
+    /* An invalid handle is reported by the getter itself */
+    if ((pInternal == NULL) || (pInternal->magic != UT_KVP_MAGIC) || ((pInternal->flags & UT_KVP_FLAG_THREADSAFE) == 0))
+    {
+        return NULL;
+    }
+
+    pthread_rwlock_rdlock(&pInternal->lock);
+
+    return pInternal;
+}
+
+static ut_kvp_instance_internal_t *iteratorReadLock(ut_kvp_iterator_t *pIterator)
+{
+    ut_kvp_iterator_internal_t *pIteratorInternal = (ut_kvp_iterator_internal_t *)pIterator;
+
+    if ((pIteratorInternal == NULL) || (pIteratorInternal->magic != UT_KVP_ITERATOR_MAGIC))
+    {
+        return NULL;
+    }
+
+    return readLock((ut_kvp_instance_t *)pIteratorInternal->pInternal);
+}
+
+static void readUnlock(ut_kvp_instance_internal_t *pLocked)
+{
+    if (pLocked != NULL)
+    {
+        pthread_rwlock_unlock(&pLocked->lock);
+    }
+}
+
+static ut_kvp_hazard_t *hazardSlot(void)
+{
+    ut_kvp_hazard_t *pHazard = gpThreadHazard;
+
+    if (pHazard != NULL)
+    {
+        return pHazard;
+    }
+
+    pthread_once(&gHazardOnce, hazardInit);
+
+    /* A slot released by an exited thread is taken over first */
+    for (pHazard = __atomic_load_n(&gpHazards, __ATOMIC_ACQUIRE); pHazard != NULL; pHazard = pHazard->pNext)
+    {
+        bool expected = false;
+
+        if (__atomic_compare_exchange_n(&pHazard->inUse, &expected, true, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+    }
+
+    if (pHazard == NULL)
+    {
+        if (posix_memalign((void **)&pHazard, UT_KVP_CACHE_LINE_SIZE, sizeof(ut_kvp_hazard_t)) != 0)
+        {
+            UT_LOG_ERROR("Memory allocation error");
+            return NULL;
+        }
+        memset(pHazard, 0, sizeof(ut_kvp_hazard_t));
+        pHazard->inUse = true;
+
+        // Slots are only ever pushed, so writers can walk the list without a lock
+        pHazard->pNext = __atomic_load_n(&gpHazards, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&gpHazards, &pHazard->pNext, pHazard, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+        }
+    }
+
+    pthread_setspecific(gHazardKey, pHazard);
+    gpThreadHazard = pHazard;
+
+    return pHazard;
+}
+
+static void hazardInit(void)
+{
+    pthread_key_create(&gHazardKey, hazardRelease);
+}
+
+static void hazardRelease(void *pArg)
+{
+    ut_kvp_hazard_t *pHazard = (ut_kvp_hazard_t *)pArg;
+
+    __atomic_store_n(&pHazard->pSnapshot, NULL, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&pHazard->inUse, false, __ATOMIC_RELEASE);
+}
+
+static bool hazardHeld(const ut_kvp_instance_internal_t *pSnapshot)
+{
+    for (ut_kvp_hazard_t *pHazard = __atomic_load_n(&gpHazards, __ATOMIC_ACQUIRE); pHazard != NULL; pHazard = pHazard->pNext)
+    {
+        if (__atomic_load_n(&pHazard->pSnapshot, __ATOMIC_SEQ_CST) == pSnapshot)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static ut_kvp_status_t shareDocument(ut_kvp_instance_internal_t *pSource, ut_kvp_instance_internal_t *pTarget)
+{
+    ut_kvp_shared_t *pShared = pSource->pShared;
+
+    if ((pSource->fy_handle == NULL) && (pSource->pMapped == NULL))
+    {
+        /* Nothing open, the clone starts empty */
+        return UT_KVP_STATUS_SUCCESS;
+    }
+
+    // The first clone moves the storage into a shared block, readers of the source still see the same pointers
+    if (pShared == NULL)
+    {
+        pShared = malloc(sizeof(ut_kvp_shared_t));
+        if (pShared == NULL)
+        {
+            UT_LOG_ERROR("Memory allocation error");
+            return UT_KVP_STATUS_INVALID_PARAM;
+        }
+        pShared->refCount = 1;
+        pShared->fy_handle = pSource->fy_handle;
+        pShared->pMapped = pSource->pMapped;
+        pShared->mappedSize = pSource->mappedSize;
+        pShared->arena = pSource->arena;
+        memset(&pSource->arena, 0, sizeof(ut_kvp_arena_t));
+        pSource->pShared = pShared;
+    }
+
+    __atomic_add_fetch(&pShared->refCount, 1, __ATOMIC_RELAXED);
+
+    /* Nothing is copied but the handles, the document, index and image are never modified in place */
+    pTarget->fy_handle = pSource->fy_handle;
+    pTarget->pMapped = pSource->pMapped;
+    pTarget->mappedSize = pSource->mappedSize;
+    pTarget->image = pSource->image;
+    pTarget->index = pSource->index;
+    pTarget->index.pArena = NULL;
+    pTarget->pShared = pShared;
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static void shareRelease(ut_kvp_instance_internal_t *pInternal)
+{
+    ut_kvp_shared_t *pShared = pInternal->pShared;
+
+    if (pShared == NULL)
+    {
+        return;
+    }
+
+    // Only this instance lets go, the document stays with every other instance sharing it
+    pInternal->fy_handle = NULL;
+    pInternal->pMapped = NULL;
+    pInternal->mappedSize = 0;
+    memset(&pInternal->image, 0, sizeof(ut_kvp_image_t));
+    indexFree(&pInternal->index);
+    pInternal->pShared = NULL;
+
+    if (__atomic_sub_fetch(&pShared->refCount, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        if (pShared->fy_handle != NULL)
+        {
+            fy_document_destroy(pShared->fy_handle);
+        }
+        if (pShared->pMapped != NULL)
+        {
+            munmap(pShared->pMapped, pShared->mappedSize);
+        }
+        arenaFree(&pShared->arena);
+        free(pShared);
+    }
+}
+
+static ut_kvp_status_t mapFile(const char *fileName, void **ppMapped, size_t *pSize)
+{
+    struct stat fileStat;
+    void *pMapped;
+    int fd;
+
+    fd = open(fileName, O_RDONLY);
+    if (fd < 0)
+    {
+        UT_LOG_ERROR("[%s] cannot be accesed", fileName);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
+    }
+
+    if ((fstat(fd, &fileStat) != 0) || !S_ISREG(fileStat.st_mode))
+    {
+        UT_LOG_ERROR("[%s] is not a regular file", fileName);
+        close(fd);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
+    }
+
+    if (fileStat.st_size == 0)
+    {
+        UT_LOG_ERROR("[%s] is empty", fileName);
+        close(fd);
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    // A private read-only mapping shares the page cache with every other reader of the file
+    pMapped = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pMapped == MAP_FAILED)
+    {
+        UT_LOG_ERROR("[%s] cannot be mapped", fileName);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
+    }
+
+    *ppMapped = pMapped;
+    *pSize = (size_t)fileStat.st_size;
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static void unmapProfile(ut_kvp_instance_internal_t *pInternal)
+{
+    if (pInternal->pMapped != NULL)
+    {
+        munmap(pInternal->pMapped, pInternal->mappedSize);
+        pInternal->pMapped = NULL;
+        pInternal->mappedSize = 0;
+    }
+    memset(&pInternal->image, 0, sizeof(ut_kvp_image_t));
+}
+
+static ut_kvp_status_t bundleIndex(const void *pData, size_t size, ut_kvp_bundle_t *pBundle)
+{
+    const unsigned char *pBase = pData;
+    size_t offset = 0;
+    uint32_t capacity = 0;
+    uint32_t first = UINT32_MAX;
+
+    memset(pBundle, 0, sizeof(ut_kvp_bundle_t));
+
+    // An uncompressed POSIX tar archive: 512 byte headers, each followed by its data padded to 512 bytes
+    while (offset + UT_KVP_BUNDLE_BLOCK_SIZE <= size)
+    {
+        const char *pHeader = (const char *)&pBase[offset];
+        ut_kvp_bundle_member_t *pMember;
+        uint64_t memberSize;
+        uint64_t checksum;
+        uint32_t sum = 0;
+        size_t nameLength;
+        bool valid = true;
+
+        if (pHeader[0] == '\0')
+        {
+            /* End of archive marker */
+            break;
+        }
+
+        for (size_t i = 0; i < UT_KVP_BUNDLE_BLOCK_SIZE; i++)
+        {
+            sum += ((i >= 148) && (i < 156)) ? ' ' : (unsigned char)pHeader[i];
+        }
+        checksum = bundleOctal(&pHeader[148], 8, &valid);
+        memberSize = bundleOctal(&pHeader[124], 12, &valid);
+        if (!valid || (checksum != sum) ||
+            (memberSize > size - offset - UT_KVP_BUNDLE_BLOCK_SIZE))
+        {
+            free(pBundle->pMembers);
+            memset(pBundle, 0, sizeof(ut_kvp_bundle_t));
+            return UT_KVP_STATUS_PARSING_ERROR;
+        }
+
+        // Only regular files are members, directories and extended headers are stepped over
+        if ((pHeader[156] == '0') || (pHeader[156] == '\0'))
+        {
+            if (pBundle->count == capacity)
+            {
+                uint32_t newCapacity = (capacity == 0) ? 32 : capacity * 2;
+                ut_kvp_bundle_member_t *pNewMembers = realloc(pBundle->pMembers, newCapacity * sizeof(ut_kvp_bundle_member_t));
+
+                if (pNewMembers == NULL)
+                {
+                    free(pBundle->pMembers);
+                    memset(pBundle, 0, sizeof(ut_kvp_bundle_t));
+                    return UT_KVP_STATUS_PARSING_ERROR;
+                }
+                pBundle->pMembers = pNewMembers;
+                capacity = newCapacity;
+            }
+
+            pMember = &pBundle->pMembers[pBundle->count];
+            nameLength = strnlen(pHeader, UT_KVP_BUNDLE_NAME_SIZE);
+            pMember->pName = pHeader;
+            pMember->nameLength = nameLength;
+            if ((memcmp(&pHeader[257], "ustar", 5) == 0) && (pHeader[345] != '\0'))
+            {
+                /* Names over 100 characters are split, which the index doesn't hold */
+                UT_LOG_ERROR("Bundle member name too long, skipped");
+            }
+            else
+            {
+                while ((pMember->nameLength > 2) && (memcmp(pMember->pName, "./", 2) == 0))
+                {
+                    pMember->pName += 2;
+                    pMember->nameLength -= 2;
+                }
+                pMember->pData = (const char *)&pBase[offset + UT_KVP_BUNDLE_BLOCK_SIZE];
+                pMember->size = (size_t)memberSize;
+                if (first == UINT32_MAX)
+                {
+                    first = pBundle->count;
+                }
+                pBundle->count++;
+            }
+        }
+
+        offset += UT_KVP_BUNDLE_BLOCK_SIZE + (((size_t)memberSize + UT_KVP_BUNDLE_BLOCK_SIZE - 1) & ~(size_t)(UT_KVP_BUNDLE_BLOCK_SIZE - 1));
+    }
+
+    if (pBundle->count == 0)
+    {
+        free(pBundle->pMembers);
+        memset(pBundle, 0, sizeof(ut_kvp_bundle_t));
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    // Remembered by content, the sort below moves it
+    ut_kvp_bundle_member_t firstMember = pBundle->pMembers[first];
+    qsort(pBundle->pMembers, pBundle->count, sizeof(ut_kvp_bundle_member_t), bundleCompare);
+    for (uint32_t i = 0; i < pBundle->count; i++)
+    {
+        if (pBundle->pMembers[i].pData == firstMember.pData)
+        {
+            pBundle->pFirst = &pBundle->pMembers[i];
+            break;
+        }
+    }
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static uint64_t bundleOctal(const char *pField, size_t length, bool *pValid)
+{
+    uint64_t value = 0;
+    size_t i = 0;
+
+    while ((i < length) && (pField[i] == ' '))
+    {
+        i++;
+    }
+    if ((i == length) || (pField[i] < '0') || (pField[i] > '7'))
+    {
+        *pValid = false;
+        return 0;
+    }
+    for (; (i < length) && (pField[i] >= '0') && (pField[i] <= '7'); i++)
+    {
+        value = (value << 3) | (uint64_t)(pField[i] - '0');
+    }
+    return value;
+}
+
+static int bundleCompare(const void *pLeft, const void *pRight)
+{
+    const ut_kvp_bundle_member_t *pA = pLeft;
+    const ut_kvp_bundle_member_t *pB = pRight;
+    size_t length = (pA->nameLength < pB->nameLength) ? pA->nameLength : pB->nameLength;
+    int result = memcmp(pA->pName, pB->pName, length);
+
+    if (result != 0)
+    {
+        return result;
+    }
+    return (pA->nameLength < pB->nameLength) ? -1 : (pA->nameLength > pB->nameLength);
+}
+
+static const ut_kvp_bundle_member_t *bundleFind(const ut_kvp_bundle_t *pBundle, const char *pszName)
+{
+    ut_kvp_bundle_member_t key;
+
+    while (strncmp(pszName, "./", 2) == 0)
+    {
+        pszName += 2;
+    }
+    key.pName = pszName;
+    key.nameLength = strlen(pszName);
+
+    return bsearch(&key, pBundle->pMembers, pBundle->count, sizeof(ut_kvp_bundle_member_t), bundleCompare);
+}
+
+static ut_kvp_status_t adoptDocument(ut_kvp_instance_internal_t *pInternal, struct fy_document *srcDoc, const char *pszSource, const ut_kvp_bundle_t *pBundle)
+{
+    ut_kvp_include_context_t context;
+    int status;
+
+    if (srcDoc == NULL)
+    {
+        UT_LOG_ERROR("Unable to parse file/memory");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    if (fy_document_resolve(srcDoc) != 0)
+    {
+        UT_LOG_ERROR("Error resolving document for anchors, aliases and merge keys");
+        fy_document_destroy(srcDoc);
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    includeContextInit(pInternal, &context, pBundle);
+
+    // Fetched concurrently into the include cache, then spliced in order by the sequential expansion
+    if (pInternal->flags & UT_KVP_FLAG_PARALLEL_INCLUDES)
+    {
+        includePrefetch(srcDoc, &context);
+    }
+
+    /* The profile itself starts the chain, so a file including its own profile is caught at once */
+    if ((pszSource != NULL) && (includeChainPush(&context, pszSource, NULL) != 0))
+    {
+        watchFilesFree(context.ppFiles, context.fileCount);
+        fy_document_destroy(srcDoc);
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    // Includes are expanded in the parsed tree itself, a document without any is taken over as it is
+    status = expandDocument(srcDoc, 0, &context);
+    includeShareFree(&context);
+    includeChainPop(&context);
+    free(context.ppChain);
+    if (status != 0)
+    {
+        UT_LOG_ERROR("Unable to process node");
+        watchFilesFree(context.ppFiles, context.fileCount);
+        fy_document_destroy(srcDoc);
+        return context.expired ? UT_KVP_STATUS_TIMEOUT : UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    /* Includes that ran out of time were skipped, the profile is incomplete */
+    if (context.expired)
+    {
+        UT_LOG_ERROR("Includes not fetched within %u ms", pInternal->includeBudgetMs);
+        watchFilesFree(context.ppFiles, context.fileCount);
+        fy_document_destroy(srcDoc);
+        return UT_KVP_STATUS_TIMEOUT;
+    }
+
+    /* Keys, iterators and the index of the previous document are stale from here */
+    pInternal->generation++;
+    shareRelease(pInternal);
+    lazyFree(&pInternal->lazy);
+    indexFree(&pInternal->index);
+    arenaFree(&pInternal->arena);
+    if (pInternal->fy_handle != NULL)
+    {
+        fy_document_destroy(pInternal->fy_handle);
+    }
+    pInternal->fy_handle = srcDoc;
+
+    /* Nothing refers to a profile mapped for the previous document any more, the caller maps the new one */
+    unmapProfile(pInternal);
+
+    // The files just read are the ones a watch has to follow from now on
+    watchFilesFree(pInternal->watch.ppFiles, pInternal->watch.fileCount);
+    pInternal->watch.ppFiles = context.ppFiles;
+    pInternal->watch.fileCount = context.fileCount;
+    pInternal->watch.hasSource = (pszSource != NULL) && (pBundle == NULL) && (context.fileCount > 0);
+    if (pInternal->watch.fd >= 0)
+    {
+        watchRegister(pInternal);
+    }
+
+    if (pInternal->flags & UT_KVP_FLAG_INDEX)
+    {
+        indexBuild(pInternal);
+    }
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static void includeContextInit(ut_kvp_instance_internal_t *pInternal, ut_kvp_include_context_t *pContext, const ut_kvp_bundle_t *pBundle)
+{
+    memset(pContext, 0, sizeof(ut_kvp_include_context_t));
+    if (pInternal->includeBudgetMs != 0)
+    {
+        pContext->deadlineMs = monotonicMs() + pInternal->includeBudgetMs;
+    }
+    pContext->connectTimeoutMs = pInternal->connectTimeoutMs;
+    pContext->transferTimeoutMs = pInternal->transferTimeoutMs;
+    pContext->pBundle = pBundle;
+    pContext->share = ((pInternal->flags & UT_KVP_FLAG_SHARED_INCLUDES) != 0);
+    pContext->maxDepth = (int)pInternal->maxIncludeDepth;
+    pContext->openSerial = __atomic_add_fetch(&gIncludeCache.opens, 1, __ATOMIC_RELAXED);
+}
+
+static ut_kvp_status_t lazyAdopt(ut_kvp_instance_internal_t *pInternal, const char *pText, size_t size, const char *pszSource)
+{
+    ut_kvp_lazy_section_t *pSections = NULL;
+    uint32_t count = 0;
+    ut_kvp_status_t status;
+    struct fy_node *root;
+    void *iter = NULL;
+    size_t skeletonSize = 1;
+    char *pSkeleton;
+    char *pszCopy;
+    char *p;
+
+    /* Anything the scan can't split is opened in full */
+    if (lazyScan(pText, size, &pSections, &count) != 0)
+    {
+        free(pSections);
+        return adoptDocument(pInternal, fy_document_build_from_string(NULL, pText, size), pszSource, NULL);
+    }
+
+    // The document starts as every top-level key with a null value, each is filled in when first read
+    for (uint32_t i = 0; i < count; i++)
+    {
+        skeletonSize += pSections[i].keyLength + sizeof(": ~\n") - 1;
+    }
+    pSkeleton = malloc(skeletonSize);
+    pszCopy = strdup(pszSource);
+    if ((pSkeleton == NULL) || (pszCopy == NULL))
+    {
+        UT_LOG_ERROR("Memory allocation error");
+        free(pSkeleton);
+        free(pszCopy);
+        free(pSections);
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+    p = pSkeleton;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        memcpy(p, &pText[pSections[i].offset], pSections[i].keyLength);
+        p += pSections[i].keyLength;
+        memcpy(p, ": ~\n", sizeof(": ~\n") - 1);
+        p += sizeof(": ~\n") - 1;
+    }
+    *p = '\0';
+
+    /* The document takes ownership of pSkeleton, the profile itself becomes the first watched file */
+    status = adoptDocument(pInternal, fy_document_build_from_malloc_string(NULL, pSkeleton, skeletonSize - 1), pszSource, NULL);
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        free(pszCopy);
+        free(pSections);
+        return status;
+    }
+    /* Would only hold the null values, it is built once no section is left */
+    indexFree(&pInternal->index);
+
+    root = fy_document_root(pInternal->fy_handle);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pSections[i].pair = fy_node_mapping_iterate(root, &iter);
+        if (pSections[i].pair != NULL)
+        {
+            pSections[i].pName = fy_node_get_scalar(fy_node_pair_key(pSections[i].pair), &pSections[i].nameLength);
+        }
+        if (pSections[i].pName == NULL)
+        {
+            /* Not the keys the scan found, fall back to parsing the whole profile */
+            free(pszCopy);
+            free(pSections);
+            return adoptDocument(pInternal, fy_document_build_from_string(NULL, pText, size), pszSource, NULL);
+        }
+    }
+    qsort(pSections, count, sizeof(ut_kvp_lazy_section_t), lazyCompare);
+
+    pInternal->lazy.pText = pText;
+    pInternal->lazy.pszSource = pszCopy;
+    pInternal->lazy.pSections = pSections;
+    pInternal->lazy.sectionCount = count;
+    pInternal->lazy.pending = count;
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static int lazyScan(const char *pText, size_t size, ut_kvp_lazy_section_t **ppSections, uint32_t *pCount)
+{
+    ut_kvp_lazy_section_t *pSections = NULL;
+    uint32_t count = 0;
+    uint32_t capacity = 0;
+    size_t start = 0;
+    bool marker = false;
+
+    // Only the lines that start in column 0 are looked at closely, they begin the top-level keys
+    while (start < size)
+    {
+        const char *pLine = &pText[start];
+        const char *pEnd = memchr(pLine, '\n', size - start);
+        size_t length = (pEnd == NULL) ? (size - start) : (size_t)(pEnd - pLine);
+        size_t keyLength;
+        size_t i;
+
+        /* Anchors and aliases may reach across sections, a merge key pulls one into another */
+        for (i = lazySpaces(pLine, length); (i < length) && (pLine[i] != '#'); i++)
+        {
+            if (((pLine[i] == '&') || (pLine[i] == '*')) && ((i == 0) || (strchr(" \t[{,", pLine[i - 1]) != NULL)) &&
+                (i + 1 < length) && (strchr(" \t\r", pLine[i + 1]) == NULL))
+            {
+                *ppSections = pSections;
+                return -1;
+            }
+        }
+
+        if ((length == 0) || (pLine[0] == '#') || (pLine[0] == '\r') || (pLine[0] == ' ') || (pLine[0] == '\t'))
+        {
+            // Blank lines, comments and indented lines belong to the section before them
+            if ((count == 0) && (length > 0) && (pLine[0] != '#') && (lazySpaces(pLine, length) != length))
+            {
+                *ppSections = pSections;
+                return -1;
+            }
+            start += length + 1;
+            continue;
+        }
+
+        /* The marker starting the one document the profile holds */
+        if ((count == 0) && (marker == false) && (length >= 3) && (memcmp(pLine, "---", 3) == 0) &&
+            (lazySpaces(&pLine[3], length - 3) == length - 3))
+        {
+            marker = true;
+            start += length + 1;
+            continue;
+        }
+
+        /* Sequences, flow collections, complex keys, tags, directives and other document markers */
+        if ((strchr("-?[]{},!%@`|>&*", pLine[0]) != NULL) || ((length >= 3) && (memcmp(pLine, "...", 3) == 0)))
+        {
+            *ppSections = pSections;
+            return -1;
+        }
+
+        // Find the ': ' ending the key, a quoted key ends at its closing quote
+        i = 0;
+        if ((pLine[0] == '"') || (pLine[0] == '\''))
+        {
+            for (i = 1; i < length; i++)
+            {
+                if ((pLine[0] == '"') && (pLine[i] == '\\'))
+                {
+                    i++;
+                }
+                else if (pLine[i] == pLine[0])
+                {
+                    if ((pLine[0] == '\'') && (i + 1 < length) && (pLine[i + 1] == '\''))
+                    {
+                        i++;
+                        continue;
+                    }
+                    break;
+                }
+            }
+            i++;
+        }
+        for (; i < length; i++)
+        {
+            if ((pLine[i] == ':') && ((i + 1 == length) || (strchr(" \t\r", pLine[i + 1]) != NULL)))
+            {
+                break;
+            }
+            if ((pLine[i] == '#') && (strchr(" \t", pLine[i - 1]) != NULL))
+            {
+                i = length;
+            }
+        }
+        if (i >= length)
+        {
+            *ppSections = pSections;
+            return -1;
+        }
+        keyLength = i;
+        while ((keyLength > 0) && (strchr(" \t", pLine[keyLength - 1]) != NULL))
+        {
+            keyLength--;
+        }
+
+        /* An include key merges its file into the root, a merge key another mapping */
+        if (((keyLength == 7) && (memcmp(pLine, "include", 7) == 0)) || ((keyLength == 2) && (memcmp(pLine, "<<", 2) == 0)))
+        {
+            *ppSections = pSections;
+            return -1;
+        }
+
+        /* A quoted value left open continues on lines the scan would take for keys */
+        for (i++; (i < length) && (strchr(" \t", pLine[i]) != NULL); i++)
+        {
+        }
+        if ((i < length) && ((pLine[i] == '"') || (pLine[i] == '\'')) && (memchr(&pLine[i + 1], pLine[i], length - i - 1) == NULL))
+        {
+            *ppSections = pSections;
+            return -1;
+        }
+
+        if (count == capacity)
+        {
+            uint32_t newCapacity = (capacity == 0) ? 64 : (capacity * 2);
+            ut_kvp_lazy_section_t *pNewSections = realloc(pSections, newCapacity * sizeof(ut_kvp_lazy_section_t));
+
+            if (pNewSections == NULL)
+            {
+                *ppSections = pSections;
+                return -1;
+            }
+            pSections = pNewSections;
+            capacity = newCapacity;
+        }
+        if (count > 0)
+        {
+            pSections[count - 1].length = start - pSections[count - 1].offset;
+        }
+        memset(&pSections[count], 0, sizeof(ut_kvp_lazy_section_t));
+        pSections[count].offset = start;
+        pSections[count].keyLength = keyLength;
+        count++;
+
+        start += length + 1;
+    }
+
+    if (count == 0)
+    {
+        *ppSections = pSections;
+        return -1;
+    }
+    pSections[count - 1].length = size - pSections[count - 1].offset;
+
+    *ppSections = pSections;
+    *pCount = count;
+    return 0;
+}
+
+static size_t lazySpaces(const char *pLine, size_t length)
+{
+    size_t i = 0;
+
+    /* The mapped text has no terminator, so the string functions can't be used on it */
+    while ((i < length) && ((pLine[i] == ' ') || (pLine[i] == '\t') || (pLine[i] == '\r')))
+    {
+        i++;
+    }
+    return i;
+}
+
+static int lazyCompare(const void *pLeft, const void *pRight)
+{
+    const ut_kvp_lazy_section_t *pA = (const ut_kvp_lazy_section_t *)pLeft;
+    const ut_kvp_lazy_section_t *pB = (const ut_kvp_lazy_section_t *)pRight;
+    int result = memcmp(pA->pName, pB->pName, (pA->nameLength < pB->nameLength) ? pA->nameLength : pB->nameLength);
+
+    if (result != 0)
+    {
+        return result;
+    }
+    return (pA->nameLength > pB->nameLength) - (pA->nameLength < pB->nameLength);
+}
+
+static ut_kvp_status_t lazyTouch(ut_kvp_instance_internal_t *pInternal, const char *pszKey)
+{
+    ut_kvp_lazy_section_t key;
+    ut_kvp_lazy_section_t *pSection;
+
+    if (*pszKey == '/')
+    {
+        pszKey++;
+    }
+
+    /* The root reaches into every section */
+    key.pName = pszKey;
+    key.nameLength = strcspn(pszKey, "/.");
+    if (key.nameLength == 0)
+    {
+        lazyComplete(pInternal);
+        return UT_KVP_STATUS_SUCCESS;
+    }
+
+    pSection = bsearch(&key, pInternal->lazy.pSections, pInternal->lazy.sectionCount, sizeof(ut_kvp_lazy_section_t), lazyCompare);
+    if (pSection == NULL)
+    {
+        return UT_KVP_STATUS_SUCCESS;
+    }
+    if (pSection->parsed == false)
+    {
+        lazyParse(pInternal, pSection);
+    }
+    return pSection->status;
+}
+
+static ut_kvp_status_t lazyMissStatus(ut_kvp_instance_internal_t *pInternal, const char *pszKey)
+{
+    ut_kvp_status_t status = UT_KVP_STATUS_SUCCESS;
+
+    // A key in a section that failed reports it as a full open would have, not as a missing key
+    if (pInternal->lazy.failed > 0)
+    {
+        status = lazyTouch(pInternal, pszKey);
+    }
+    return (status != UT_KVP_STATUS_SUCCESS) ? status : UT_KVP_STATUS_KEY_NOT_FOUND;
+}
+
+static void lazyComplete(ut_kvp_instance_internal_t *pInternal)
+{
+    for (uint32_t i = 0; (i < pInternal->lazy.sectionCount) && (pInternal->lazy.pending > 0); i++)
+    {
+        if (pInternal->lazy.pSections[i].parsed == false)
+        {
+            lazyParse(pInternal, &pInternal->lazy.pSections[i]);
+        }
+    }
+}
+
+static void lazyParse(ut_kvp_instance_internal_t *pInternal, ut_kvp_lazy_section_t *pSection)
+{
+    ut_kvp_include_context_t context;
+    struct fy_document *srcDoc;
+    struct fy_node *node = NULL;
+    void *iter = NULL;
+    int status = -1;
+    bool expired = false;
+
+    /* Tried once, a section that fails keeps its status rather than being parsed again on every read */
+    pSection->parsed = true;
+    pSection->status = UT_KVP_STATUS_PARSING_ERROR;
+    pInternal->lazy.pending--;
+
+    srcDoc = fy_document_build_from_string(NULL, &pInternal->lazy.pText[pSection->offset], pSection->length);
+    if ((srcDoc != NULL) && (fy_document_resolve(srcDoc) == 0))
+    {
+        // The files included so far are carried over, so a watch follows the ones this section adds
+        includeContextInit(pInternal, &context, NULL);
+        context.ppFiles = pInternal->watch.ppFiles;
+        context.fileCount = pInternal->watch.fileCount;
+        context.fileCapacity = pInternal->watch.fileCount;
+        pInternal->watch.ppFiles = NULL;
+        pInternal->watch.fileCount = 0;
+
+        if (pInternal->flags & UT_KVP_FLAG_PARALLEL_INCLUDES)
+        {
+            includePrefetch(srcDoc, &context);
+        }
+        if (includeChainPush(&context, pInternal->lazy.pszSource, NULL) == 0)
+        {
+            status = expandDocument(srcDoc, 0, &context);
+            includeChainPop(&context);
+        }
+        includeShareFree(&context);
+        free(context.ppChain);
+
+        pInternal->watch.ppFiles = context.ppFiles;
+        pInternal->watch.fileCount = context.fileCount;
+        if ((status == 0) && (pInternal->watch.fd >= 0))
+        {
+            watchRegister(pInternal);
+        }
+        if (context.expired)
+        {
+            status = -1;
+            expired = true;
+        }
+    }
+
+    /* The section parses as a mapping of its one key */
+    if (status == 0)
+    {
+        node = fy_node_pair_value(fy_node_mapping_iterate(fy_document_root(srcDoc), &iter));
+        if (node != NULL)
+        {
+            node = fy_node_copy(pInternal->fy_handle, node);
+        }
+    }
+    if ((node == NULL) || (fy_node_pair_set_value(pSection->pair, node) != 0))
+    {
+        UT_LOG_ERROR("Unable to parse section [%.*s]", (int)pSection->nameLength, pSection->pName);
+        if (expired)
+        {
+            pSection->status = UT_KVP_STATUS_TIMEOUT;
+        }
+        pInternal->lazy.failed++;
+    }
+    else
+    {
+        pSection->status = UT_KVP_STATUS_SUCCESS;
+    }
+    if (srcDoc != NULL)
+    {
+        fy_document_destroy(srcDoc);
+    }
+
+    if ((pInternal->lazy.pending == 0) && (pInternal->flags & UT_KVP_FLAG_INDEX))
+    {
+        indexBuild(pInternal);
+    }
+}
+
+static void lazyFree(ut_kvp_lazy_t *pLazy)
+{
+    free(pLazy->pSections);
+    free(pLazy->pszSource);
+    memset(pLazy, 0, sizeof(ut_kvp_lazy_t));
+}
+
+static bool str_to_bool(const char *string, size_t length, const ut_kvp_image_entry_t *pEntry)
+{
+    if (pEntry != NULL)
+    {
+        return ((pEntry->flags & UT_KVP_IMAGE_FLAG_TRUE) != 0);
+    }
+
+    if ((length == 4) && (strncasecmp(string, "true", 4) == 0))
+    {
+        return true;
+    }
+    /* String is neither true or false, ensure we inform the caller*/
+    return false;
+}
+
+static unsigned long convertUIntField( const char *pField, size_t length, unsigned long maxRange, const ut_kvp_image_entry_t *pEntry )
+{
+    uint64_t uValue = 0;
+
+    (void)parseUIntField(pField, length, maxRange, pEntry, &uValue);
+
+    //UT_LOG_DEBUG("Converted value: %u", uValue);
+    return (unsigned long)uValue;
+}
+
+static uint64_t convertUInt64Field( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry )
+{
+    uint64_t u64Value = 0;
+
+    (void)parseUIntField(pField, length, UINT64_MAX, pEntry, &u64Value);
+
+    //UT_LOG_DEBUG("Converted value: %llu", u64Value);
+    return u64Value;
+}
+
+/* Checked form of the converters above, *pValue is only written when the scalar converts */
+static bool parseUIntField( const char *pField, size_t length, uint64_t maxRange, const ut_kvp_image_entry_t *pEntry, uint64_t *pValue )
+{
+    /* Images carry the value pre-parsed, anything out of range takes the text path for its diagnostics */
+    if ((pEntry != NULL) && (pEntry->flags & UT_KVP_IMAGE_FLAG_UINT) && (pEntry->uValue <= maxRange))
+    {
+        *pValue = pEntry->uValue;
+        return true;
+    }
+
+    return parseUInt64(pField, length, maxRange, pValue);
+}
+
+static bool parseUInt64( const char *pField, size_t length, uint64_t maxRange, uint64_t *pValue )
+{
+    uint64_t uValue = 0;
+    uint32_t base = 10;
+    size_t i = 0;
+
+    if ((length > 2) && (pField[0] == '0') && (pField[1] == 'x'))
+    {
+        base = 16; // Base 16 conversion
+        i = 2;
+    }
+
+    // Error checking
+    if (i == length)
+    {
+        UT_LOG_ERROR("No conversion performed!");
+        return false;
+    }
+
+    // Consume eight decimal digits per step while they last, the tail falls through to the loop below
+    while ((base == 10) && (length - i >= 8))
+    {
+        uint32_t chunk;
+
+        if (parseEightDigits(&pField[i], &chunk) == false)
+        {
+            break;
+        }
+
+        if ((chunk > maxRange) || (uValue > (maxRange - chunk) / 100000000u))
+        {
+            UT_LOG_DEBUG("Value out of range for maxRange [0x%llx,%llu].", (unsigned long long)maxRange, (unsigned long long)maxRange);
+            return false;
+        }
+        uValue = (uValue * 100000000u) + chunk;
+        i += 8;
+    }
+
+    for (; i < length; i++)
+    {
+        unsigned char c = (unsigned char)pField[i];
+        uint32_t digit;
+
+        if ((c >= '0') && (c <= '9'))
+        {
+            digit = c - '0';
+        }
+        else if ((base == 16) && ((c | 0x20) >= 'a') && ((c | 0x20) <= 'f'))
+        {
+            digit = (c | 0x20) - 'a' + 10;
+        }
+        else
+        {
+            UT_LOG_ERROR("Invalid characters in the string.");
+            return false;
+        }
+
+        if (uValue > (maxRange - digit) / base)
+        {
+            UT_LOG_DEBUG("Value out of range for maxRange [0x%llx,%llu].", (unsigned long long)maxRange, (unsigned long long)maxRange);
+            return false;
+        }
+        uValue = (uValue * base) + digit;
+    }
+
+    *pValue = uValue;
+    return true;
+}
+
+static bool parseEightDigits( const char *pDigits, uint32_t *pValue )
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    uint64_t chunk;
+
+    /* SWAR: all eight bytes are checked and converted together in one 64 bit register */
+    memcpy(&chunk, pDigits, sizeof(chunk));
+    if ((((chunk & 0xF0F0F0F0F0F0F0F0ULL) | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))) != 0x3333333333333333ULL)
+    {
+        return false;
+    }
+
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+
+    *pValue = (uint32_t)chunk;
+    return true;
+#else
+    uint32_t value = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        if ((pDigits[i] < '0') || (pDigits[i] > '9'))
+        {
+            return false;
+        }
+        value = (value * 10) + (uint32_t)(pDigits[i] - '0');
+    }
+
+    *pValue = value;
+    return true;
+#endif
+}
+
+static float convertFloatField( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry )
+{
+    float fValue = 0;
+
+    (void)parseFloatField(pField, length, pEntry, &fValue);
+    return fValue;
+}
+
+static bool parseFloatField( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry, float *pValue )
+{
+    char zValue[UT_KVP_MAX_NUMBER_SIZE];
+    char *pText = zValue;
+    float fValue;
+    char *endPtr;
+    bool valid;
+
+    if ((pEntry != NULL) && (pEntry->flags & UT_KVP_IMAGE_FLAG_DOUBLE))
+    {
+        *pValue = pEntry->fValue;
+        return true;
+    }
+
+    if (length == 0)
+    {
+        UT_LOG_ERROR("Error: Invalid floating-point string: ''\n");
+        return false;
+    }
+
+    /* strtof() needs a terminated string, the scalar is only a pointer and length; long scalars take a heap copy */
+    if (length >= sizeof(zValue))
+    {
+        pText = malloc(length + 1);
+        if (pText == NULL)
+        {
+            UT_LOG_ERROR("Memory allocation error");
+            return false;
+        }
+    }
+    memcpy(pText, pField, length);
+    pText[length] = '\0';
+
+    fValue = strtof(pText, &endPtr);
+
+    valid = (*endPtr == '\0');
+    if (valid == false)
+    {
+        UT_LOG_ERROR("Error: Invalid floating-point string: '%s'\n", pText);
+    }
+    else
+    {
+        *pValue = fValue;
+    }
+
+    if (pText != zValue)
+    {
+        free(pText);
+    }
+    return valid;
+}
+
+static double convertDoubleField( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry )
+{
+    double dValue = 0;
+
+    (void)parseDoubleField(pField, length, pEntry, &dValue);
+    return dValue;
+}
+
+static bool parseDoubleField( const char *pField, size_t length, const ut_kvp_image_entry_t *pEntry, double *pValue )
+{
+    char zValue[UT_KVP_MAX_NUMBER_SIZE];
+    char *pText = zValue;
+    double dValue;
+    char *endPtr;
+    bool valid;
+
+    if ((pEntry != NULL) && (pEntry->flags & UT_KVP_IMAGE_FLAG_DOUBLE))
+    {
+        *pValue = pEntry->dValue;
+        return true;
+    }
+
+    if (length == 0)
+    {
+        UT_LOG_ERROR("Error: Invalid floating-point string: ''\n");
+        return false;
+    }
+
+    /* strtod() needs a terminated string, the scalar is only a pointer and length; long scalars take a heap copy */
+    if (length >= sizeof(zValue))
+    {
+        pText = malloc(length + 1);
+        if (pText == NULL)
+        {
+            UT_LOG_ERROR("Memory allocation error");
+            return false;
+        }
+    }
+    memcpy(pText, pField, length);
+    pText[length] = '\0';
+
+    dValue = strtod(pText, &endPtr);
+
+    valid = (*endPtr == '\0');
+    if (valid == false)
+    {
+        UT_LOG_ERROR("Error: Invalid floating-point string: '%s'\n", pText);
+    }
+    else
+    {
+        *pValue = dValue;
+    }
+
+    if (pText != zValue)
+    {
+        free(pText);
+    }
+    return valid;
+}
+
+static ut_kvp_key_internal_t *validateKey(ut_kvp_instance_internal_t *pInternal, ut_kvp_key_t *pKey)
+{
+    ut_kvp_key_internal_t *pKeyInternal = (ut_kvp_key_internal_t *)pKey;
+
+    if (pKeyInternal == NULL)
+    {
+        UT_LOG_ERROR("Invalid Param - pKey");
+        return NULL;
+    }
+
+    if (pKeyInternal->magic != UT_KVP_KEY_MAGIC)
+    {
+        UT_LOG_ERROR("Invalid Key Handle - magic failure");
+        return NULL;
+    }
+
+    if (pKeyInternal->pInternal != snapshotOwner(pInternal))
+    {
+        UT_LOG_ERROR("Key Handle was compiled against another instance");
+        return NULL;
+    }
+
+    return pKeyInternal;
+}
+
+static struct fy_node *resolveKey(ut_kvp_instance_internal_t *pInternal, ut_kvp_key_internal_t *pKeyInternal)
+{
+    if ((pKeyInternal->resolved == true) && (pKeyInternal->generation == pInternal->generation))
+    {
+        return pKeyInternal->node;
+    }
+
+    pKeyInternal->pEntry = NULL;
+    pKeyInternal->node = findNode(pInternal, pKeyInternal->zKey);
+
+    /* Misses are cached as well, the document only changes on open/close */
+    pKeyInternal->generation = pInternal->generation;
+    pKeyInternal->resolved = true;
+
+    return pKeyInternal->node;
+}
+
+static const ut_kvp_image_entry_t *resolveImageKey(ut_kvp_instance_internal_t *pInternal, ut_kvp_key_internal_t *pKeyInternal)
+{
+    if ((pKeyInternal->resolved == true) && (pKeyInternal->generation == pInternal->generation))
+    {
+        return pKeyInternal->pEntry;
+    }
+
+    pKeyInternal->node = NULL;
+    pKeyInternal->pEntry = imageFind(&pInternal->image, pKeyInternal->zKey);
+    pKeyInternal->generation = pInternal->generation;
+    pKeyInternal->resolved = true;
+
+    return pKeyInternal->pEntry;
+}
+
+static const char *getKeyScalar(ut_kvp_instance_t *pInstance, ut_kvp_key_t *pKey, size_t *pLength, const ut_kvp_image_entry_t **ppEntry)
+{
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    ut_kvp_key_internal_t *pKeyInternal;
+    struct fy_node *node;
+
+    if (pInternal == NULL)
+    {
+        return NULL;
+    }
+
+    pKeyInternal = validateKey(pInternal, pKey);
+    if (pKeyInternal == NULL)
+    {
+        return NULL;
+    }
+
+    if (pInternal->image.pHeader != NULL)
+    {
+        ut_kvp_status_t status;
+
+        *ppEntry = resolveImageKey(pInternal, pKeyInternal);
+        return imageScalar(&pInternal->image, *ppEntry, pKeyInternal->zKey, pLength, &status);
+    }
+
+    if ( pInternal->fy_handle == NULL )
+    {
+        UT_LOG_ERROR("No Data File open");
+        return NULL;
+    }
+
+    node = resolveKey(pInternal, pKeyInternal);
+    if ( node == NULL )
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pKeyInternal->zKey);
+        return NULL;
+    }
+
+    if (fy_node_is_scalar(node) == false)
+    {
+        UT_LOG_ERROR("invalid key");
+        return NULL;
+    }
+
+    return fy_node_get_scalar(node, pLength);
+}
+
+static const char *getScalar(ut_kvp_instance_t *pInstance, const char *pszKey, size_t *pLength, const ut_kvp_image_entry_t **ppEntry)
+{
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    struct fy_node *node;
+
+    if (pInternal == NULL)
+    {
+        return NULL;
+    }
+
+    if (pszKey == NULL)
+    {
+        UT_LOG_ERROR("Invalid Param - pszKey");
+        return NULL;
+    }
+
+    if (pInternal->image.pHeader != NULL)
+    {
+        ut_kvp_status_t status;
+
+        *ppEntry = imageFind(&pInternal->image, pszKey);
+        return imageScalar(&pInternal->image, *ppEntry, pszKey, pLength, &status);
+    }
+
+    if ( pInternal->fy_handle == NULL )
+    {
+        UT_LOG_ERROR("No Data File open");
+        return NULL;
+    }
+
+    node = findNode(pInternal, pszKey);
+    if ( node == NULL )
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+        return NULL;
+    }
+
+    if (fy_node_is_scalar(node) == false)
+    {
+        UT_LOG_ERROR("invalid key");
+        return NULL;
+    }
+
+    /* Borrowed from the document, not guaranteed to be zero terminated */
+    return fy_node_get_scalar(node, pLength);
+}
+
+static ut_kvp_iterator_internal_t *validateIterator(ut_kvp_iterator_t *pIterator)
+{
+    ut_kvp_iterator_internal_t *pIteratorInternal = (ut_kvp_iterator_internal_t *)pIterator;
+
+    if (pIteratorInternal == NULL)
+    {
+        UT_LOG_ERROR("Invalid Param - pIterator");
+        return NULL;
+    }
+
+    if (pIteratorInternal->magic != UT_KVP_ITERATOR_MAGIC)
+    {
+        UT_LOG_ERROR("Invalid Iterator Handle - magic failure");
+        return NULL;
+    }
+
+    return pIteratorInternal;
+}
+
+static const char *getIteratorScalar(ut_kvp_iterator_t *pIterator, size_t *pLength, const ut_kvp_image_entry_t **ppEntry)
+{
+    const char *pString = NULL;
+
+    if (readIteratorStringView(pIterator, &pString, pLength) != UT_KVP_STATUS_SUCCESS)
+    {
+        return NULL;
+    }
+
+    /* Validated by readIteratorStringView() */
+    *ppEntry = ((ut_kvp_iterator_internal_t *)pIterator)->pChildEntry;
+    return pString;
+}
+
+static void convert_dot_to_slash(const char *key, char *output)
+{
+    if (strchr(key, '.'))
+    {
+        for (int i = 0; i <= UT_KVP_MAX_ELEMENT_SIZE; i++)
+        {
+            char key_val = key[i];
+            if (key_val == '\0')
+            {
+                break;
+            }
+            if (key_val == '.')
+            {
+                output[i] = '/';
+            }
+            else
+            {
+                output[i] = key_val;
+            }
+        }
+        output[strlen(key)] = '\0';
+    }
+    else
+    {
+        snprintf(output, UT_KVP_MAX_ELEMENT_SIZE, "%s", key);
+    }
+}
+
+static struct fy_node *findNode(ut_kvp_instance_internal_t *pInternal, const char *pszKey)
+{
+    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
+    struct fy_node *root;
+
+    // A section of a lazily opened profile is parsed when a key first reaches into it
+    if (((pInternal->lazy.pending > 0) || (pInternal->lazy.failed > 0)) &&
+        (lazyTouch(pInternal, pszKey) != UT_KVP_STATUS_SUCCESS))
+    {
+        /* Nothing is read from a section that failed, lazyMissStatus() tells the getter why */
+        return NULL;
+    }
+
+    if (pInternal->index.pEntries != NULL)
+    {
+        return indexLookup(&pInternal->index, pszKey);
+    }
+
+    root = fy_document_root(pInternal->fy_handle);
+    if (root == NULL)
+    {
+        return NULL;
+    }
+
+    convert_dot_to_slash(pszKey, zKey);
+
+    return followAlias(fy_node_by_path(root, zKey, -1, FYNWF_FOLLOW));
+}
+
+static struct fy_node *followAlias(struct fy_node *node)
+{
+    // Shared includes are referenced through aliases, every other alias was resolved at open
+    if ((node != NULL) && fy_node_is_alias(node))
+    {
+        return fy_node_resolve_alias(node);
+    }
+    return node;
+}
+
+static ut_kvp_status_t getSequence(ut_kvp_instance_t *pInstance, const char *pszKey, void *pBuffer, uint32_t maxCount, uint32_t *pCount, struct fy_node **pNode, const ut_kvp_image_t **ppImage, const ut_kvp_image_entry_t **ppEntry)
+{
+    ut_kvp_instance_internal_t *pInternal = validateInstance(pInstance);
+    struct fy_node *node;
+
+    if (pInternal == NULL)
+    {
+        return UT_KVP_STATUS_INVALID_INSTANCE;
+    }
+
+    if ((pszKey == NULL) || (pCount == NULL) || ((pBuffer == NULL) && (maxCount > 0)))
+    {
+        UT_LOG_ERROR("Invalid Param - NULL");
+        return UT_KVP_STATUS_NULL_PARAM;
+    }
+
+    *pCount = 0;
+
+    if (pInternal->image.pHeader != NULL)
+    {
+        const ut_kvp_image_entry_t *pEntry = imageFind(&pInternal->image, pszKey);
+
+        if ( pEntry == NULL )
+        {
+            UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+            return UT_KVP_STATUS_KEY_NOT_FOUND;
+        }
+
+        if (pEntry->kind != UT_KVP_IMAGE_KIND_SEQUENCE)
+        {
+            UT_LOG_ERROR("key [%s] is not a sequence", pszKey);
+            return UT_KVP_STATUS_PARSING_ERROR;
+        }
+
+        *pCount = pEntry->childCount;
+        *ppImage = &pInternal->image;
+        *ppEntry = pEntry;
+        return UT_KVP_STATUS_SUCCESS;
+    }
+
+    if ( pInternal->fy_handle == NULL )
+    {
+        UT_LOG_ERROR("No Data File open");
+        return UT_KVP_STATUS_NO_DATA;
+    }
+
+    node = findNode(pInternal, pszKey);
+    if ( node == NULL )
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+        return lazyMissStatus(pInternal, pszKey);
+    }
+
+    if (fy_node_is_sequence(node) == false)
+    {
+        UT_LOG_ERROR("key [%s] is not a sequence", pszKey);
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    *pCount = (uint32_t)fy_node_sequence_item_count(node);
+    *pNode = node;
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static ut_kvp_status_t getArray(ut_kvp_instance_t *pInstance, const char *pszKey, ut_kvp_field_type_t type, void *pValues, uint32_t maxCount, uint32_t *pCount)
+{
+    ut_kvp_status_t status;
+    ut_kvp_status_t result = UT_KVP_STATUS_SUCCESS;
+    const ut_kvp_image_t *pImage = NULL;
+    const ut_kvp_image_entry_t *pEntry = NULL;
+    struct fy_node *node = NULL;
+    struct fy_node *item;
+    void *iter = NULL;
+    uint32_t count = 0;
+    ut_kvp_instance_internal_t *pLocked;
+
+    pLocked = readLock(pInstance);
+    status = getSequence(pInstance, pszKey, pValues, maxCount, pCount, &node, &pImage, &pEntry);
+    if ((status != UT_KVP_STATUS_SUCCESS) || (maxCount == 0))
+    {
+        readUnlock(pLocked);
+        return status;
+    }
+
+    // One pass over the sequence, each element is converted in place from its scalar
+    while (count < maxCount)
+    {
+        const ut_kvp_image_entry_t *pItemEntry = NULL;
+        size_t length = 0;
+        const char *pString;
+        uint64_t uValue;
+        double dValue;
+        bool converted;
+
+        if (pEntry != NULL)
+        {
+            if (count >= pEntry->childCount)
+            {
+                break;
+            }
+            pItemEntry = imageChild(pImage, pEntry, count);
+            pString = imageValue(pImage, pItemEntry, &length);
+        }
+        else
+        {
+            if ((item = fy_node_sequence_iterate(node, &iter)) == NULL)
+            {
+                break;
+            }
+            item = followAlias(item);
+            pString = fy_node_get_scalar(item, &length);
+        }
+
+        if (pString == NULL)
+        {
+            UT_LOG_ERROR("element [%u] of [%s] is not a scalar", count, pszKey);
+            result = UT_KVP_STATUS_PARSING_ERROR;
+            length = 0;
+        }
+
+        switch (type)
+        {
+            case UT_KVP_FIELD_TYPE_UINT32:
+            {
+                uValue = 0;
+                converted = (pString != NULL) && parseUIntField(pString, length, UINT32_MAX, pItemEntry, &uValue);
+                ((uint32_t *)pValues)[count] = (uint32_t)uValue;
+            }
+            break;
+            case UT_KVP_FIELD_TYPE_UINT64:
+            {
+                uValue = 0;
+                converted = (pString != NULL) && parseUIntField(pString, length, UINT64_MAX, pItemEntry, &uValue);
+                ((uint64_t *)pValues)[count] = uValue;
+            }
+            break;
+            default:
+            {
+                dValue = 0;
+                converted = (pString != NULL) && parseDoubleField(pString, length, pItemEntry, &dValue);
+                ((double *)pValues)[count] = dValue;
+            }
+            break;
+        }
+
+        if ((pString != NULL) && (converted == false))
+        {
+            UT_LOG_ERROR("element [%u] of [%s] is not a valid number", count, pszKey);
+            result = UT_KVP_STATUS_PARSING_ERROR;
+        }
+        count++;
+    }
+    readUnlock(pLocked);
+
+    if ((result == UT_KVP_STATUS_SUCCESS) && (*pCount > maxCount))
+    {
+        UT_LOG_ERROR("buffer too small for [%s], %u of %u elements read", pszKey, maxCount, *pCount);
+        result = UT_KVP_STATUS_INVALID_PARAM;
+    }
+
+    return result;
+}
+
+/* Hex digit values plus one, so the zero default marks every other character */
+static const unsigned char gHexDigit[256] =
+{
+    ['0'] = 1,  ['1'] = 2,  ['2'] = 3,  ['3'] = 4,  ['4'] = 5,  ['5'] = 6,  ['6'] = 7,  ['7'] = 8,
+    ['8'] = 9,  ['9'] = 10, ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
+static ut_kvp_status_t decodeDataBytes(const char *pString, size_t length, unsigned char *pBuffer, uint32_t bufferSize, uint32_t *pCount)
+{
+    const unsigned char *p = (const unsigned char *)pString;
+    const unsigned char *pEnd = p + length;
+    uint32_t count = 0;
+
+    while (p < pEnd)
+    {
+        const unsigned char *pToken = p;
+        uint32_t value = 0;
+
+        // Separators are any run of spaces and commas, as strtok(", ") treated them
+        if ((*p == ' ') || (*p == ','))
+        {
+            p++;
+            continue;
+        }
+
+        if ((pEnd - p >= 4) && (p[0] == '0') && ((p[1] | 0x20) == 'x') && gHexDigit[p[2]] && gHexDigit[p[3]] &&
+            ((pEnd - p == 4) || (p[4] == ' ') || (p[4] == ',')))
+        {
+            /* Fast path for the common "0xHH" form */
+            value = ((gHexDigit[p[2]] - 1) << 4) | (gHexDigit[p[3]] - 1);
+            p += 4;
+        }
+        else
+        {
+            bool hex = ((pEnd - p > 2) && (p[0] == '0') && ((p[1] | 0x20) == 'x'));
+            bool negative = (!hex && (*p == '-'));
+            size_t prefix = hex ? 2 : (((*p == '+') || (*p == '-')) ? 1 : 0);
+
+            /* strtoul() accepted a sign on decimal values, "-0" being the only negative byte */
+            for (p += prefix; (p < pEnd) && (*p != ' ') && (*p != ','); p++)
+            {
+                uint32_t digit = hex ? (uint32_t)(gHexDigit[*p] - 1) : (uint32_t)(*p - '0');
+
+                value = (value * (hex ? 16 : 10)) + digit;
+                if ((digit > (hex ? 15u : 9u)) || (value > 255))
+                {
+                    while ((p < pEnd) && (*p != ' ') && (*p != ','))
+                    {
+                        p++;
+                    }
+                    UT_LOG_ERROR("Invalid byte value: %.*s", (int)(p - pToken), (const char *)pToken);
+                    return UT_KVP_STATUS_PARSING_ERROR;
+                }
+            }
+
+            if ((p == pToken + prefix) || (negative && (value != 0)))
+            {
+                UT_LOG_ERROR("Invalid byte value: %.*s", (int)(p - pToken), (const char *)pToken);
+                return UT_KVP_STATUS_PARSING_ERROR;
+            }
+        }
+
+        if (count < bufferSize)
+        {
+            pBuffer[count] = (unsigned char)value;
+        }
+        count++;
+    }
+
+    *pCount = count;
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static struct fy_node *findSiblingNode(ut_kvp_instance_internal_t *pInternal, const char *pszKey, ut_kvp_parent_cache_t *pCache, ut_kvp_status_t *pStatus)
+{
+    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
+    struct fy_node *node = NULL;
+    size_t length;
+    size_t parentLength = 0;
+
+    *pStatus = UT_KVP_STATUS_SUCCESS;
+
+    if ((pInternal->lazy.pending > 0) || (pInternal->lazy.failed > 0))
+    {
+        *pStatus = lazyTouch(pInternal, pszKey);
+        if (*pStatus != UT_KVP_STATUS_SUCCESS)
+        {
+            UT_LOG_ERROR("section of key = [%s] could not be parsed", pszKey);
+            return NULL;
+        }
+    }
+
+    if (pInternal->index.pEntries != NULL)
+    {
+        /* The index already resolves any key in one probe */
+        node = indexLookup(&pInternal->index, pszKey);
+    }
+    else
+    {
+        length = strlen(pszKey);
+        if (length >= sizeof(zKey))
+        {
+            UT_LOG_ERROR("Invalid Param - key too long [%s]", pszKey);
+            *pStatus = UT_KVP_STATUS_INVALID_PARAM;
+            return NULL;
+        }
+
+        for (size_t i = 0; i < length; i++)
+        {
+            zKey[i] = (pszKey[i] == '.') ? '/' : pszKey[i];
+            if (zKey[i] == '/')
+            {
+                parentLength = i;
+            }
+        }
+        zKey[length] = '\0';
+
+        // Only walk to the parent when it differs from the previous key's
+        if ((pCache->valid == false) || (pCache->length != parentLength) ||
+            (memcmp(pCache->zPath, zKey, parentLength) != 0))
+        {
+            struct fy_node *root = fy_document_root(pInternal->fy_handle);
+
+            memcpy(pCache->zPath, zKey, parentLength);
+            pCache->length = parentLength;
+            pCache->node = ((root != NULL) && (parentLength > 0)) ? followAlias(fy_node_by_path(root, zKey, parentLength, FYNWF_FOLLOW)) : root;
+            pCache->valid = true;
+        }
+
+        if (pCache->node != NULL)
+        {
+            size_t leafStart = (zKey[parentLength] == '/') ? (parentLength + 1) : 0;
+            const char *pLeaf = &zKey[leafStart];
+            size_t leafLength = length - leafStart;
+
+            // The leaf is a single component, look it up directly rather than through the path parser
+            if (fy_node_is_mapping(pCache->node))
+            {
+                node = followAlias(fy_node_mapping_lookup_by_string(pCache->node, pLeaf, leafLength));
+            }
+            else if (fy_node_is_sequence(pCache->node) && (leafLength > 0) && (strspn(pLeaf, "0123456789") == leafLength))
+            {
+                node = followAlias(fy_node_sequence_get_by_index(pCache->node, atoi(pLeaf)));
+            }
+        }
+    }
+
+    if (node == NULL)
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+        *pStatus = UT_KVP_STATUS_KEY_NOT_FOUND;
+    }
+
+    return node;
+}
+
+static ut_kvp_status_t storeField(ut_kvp_field_t *pField, struct fy_node *node)
+{
+    const char *pString;
+    size_t length;
+
+    if (fy_node_is_scalar(node) == false)
+    {
+        UT_LOG_ERROR("invalid key [%s]", pField->pszKey);
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    pString = fy_node_get_scalar(node, &length);
+    if (pString == NULL)
+    {
+        UT_LOG_ERROR("field not found: UT_KVP_STATUS_KEY_NOT_FOUND");
+        return UT_KVP_STATUS_KEY_NOT_FOUND;
+    }
+
+    return storeValue(pField, pString, length, NULL);
+}
+
+static ut_kvp_status_t storeValue(ut_kvp_field_t *pField, const char *pString, size_t length, const ut_kvp_image_entry_t *pEntry)
+{
+    uint64_t uValue;
+    float fValue;
+    double dValue;
+    bool converted = true;
+
+    switch (pField->type)
+    {
+        case UT_KVP_FIELD_TYPE_BOOL:
+        {
+            *(bool *)pField->pValue = str_to_bool(pString, length, pEntry);
+        }
+        break;
+        case UT_KVP_FIELD_TYPE_UINT8:
+        {
+            converted = parseUIntField(pString, length, UINT8_MAX, pEntry, &uValue);
+            if (converted == true)
+            {
+                *(uint8_t *)pField->pValue = (uint8_t)uValue;
+            }
+        }
+        break;
+        case UT_KVP_FIELD_TYPE_UINT16:
+        {
+            converted = parseUIntField(pString, length, UINT16_MAX, pEntry, &uValue);
+            if (converted == true)
+            {
+                *(uint16_t *)pField->pValue = (uint16_t)uValue;
+            }
+        }
+        break;
+        case UT_KVP_FIELD_TYPE_UINT32:
+        {
+            converted = parseUIntField(pString, length, UINT32_MAX, pEntry, &uValue);
+            if (converted == true)
+            {
+                *(uint32_t *)pField->pValue = (uint32_t)uValue;
+            }
+        }
+        break;
+        case UT_KVP_FIELD_TYPE_UINT64:
+        {
+            converted = parseUIntField(pString, length, UINT64_MAX, pEntry, &uValue);
+            if (converted == true)
+            {
+                *(uint64_t *)pField->pValue = uValue;
+            }
+        }
+        break;
+        case UT_KVP_FIELD_TYPE_FLOAT:
+        {
+            converted = parseFloatField(pString, length, pEntry, &fValue);
+            if (converted == true)
+            {
+                *(float *)pField->pValue = fValue;
+            }
+        }
+        break;
+        case UT_KVP_FIELD_TYPE_DOUBLE:
+        {
+            converted = parseDoubleField(pString, length, pEntry, &dValue);
+            if (converted == true)
+            {
+                *(double *)pField->pValue = dValue;
+            }
+        }
+        break;
+        case UT_KVP_FIELD_TYPE_STRING:
+        {
+            if (pField->uStringSize == 0)
+            {
+                UT_LOG_ERROR("Invalid Param - uStringSize");
+                return UT_KVP_STATUS_INVALID_PARAM;
+            }
+            if (length >= pField->uStringSize)
+            {
+                length = pField->uStringSize - 1;
+            }
+            memcpy(pField->pValue, pString, length);
+            ((char *)pField->pValue)[length] = '\0';
+        }
+        break;
+        default:
+        {
+            UT_LOG_ERROR("Invalid Param - type [%d]", pField->type);
+            return UT_KVP_STATUS_INVALID_PARAM;
+        }
+    }
+
+    if (converted == false)
+    {
+        UT_LOG_ERROR("invalid value for key [%s]", pField->pszKey);
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static void *arenaAlloc(ut_kvp_arena_t *pArena, size_t size)
+{
+    ut_kvp_arena_block_t *pBlock = pArena->pBlocks;
+    size_t blockSize;
+    uintptr_t start;
+
+    if (pBlock != NULL)
+    {
+        start = ((uintptr_t)(pBlock->pData + pBlock->used) + UT_KVP_ARENA_ALIGNMENT - 1) & ~(uintptr_t)(UT_KVP_ARENA_ALIGNMENT - 1);
+        if (start + size <= (uintptr_t)(pBlock->pData + pBlock->size))
+        {
+            pBlock->used = (start + size) - (uintptr_t)pBlock->pData;
+            return (void *)start;
+        }
+    }
+
+    // Start a new block, large requests get a block of their own
+    blockSize = (pArena->nextBlockSize == 0) ? UT_KVP_ARENA_BLOCK_SIZE : pArena->nextBlockSize;
+    if (blockSize < size + UT_KVP_ARENA_ALIGNMENT)
+    {
+        blockSize = size + UT_KVP_ARENA_ALIGNMENT;
+    }
+
+    pBlock = malloc(sizeof(ut_kvp_arena_block_t) + blockSize);
+    if (pBlock == NULL)
+    {
+        return NULL;
+    }
+    pBlock->pData = (unsigned char *)(pBlock + 1);
+    pBlock->size = blockSize;
+    pBlock->used = 0;
+    pBlock->pNext = pArena->pBlocks;
+    pArena->pBlocks = pBlock;
+
+    if (blockSize * 2 <= UT_KVP_ARENA_MAX_BLOCK_SIZE)
+    {
+        pArena->nextBlockSize = blockSize * 2;
+    }
+    else
+    {
+        pArena->nextBlockSize = UT_KVP_ARENA_MAX_BLOCK_SIZE;
+    }
+
+    start = ((uintptr_t)pBlock->pData + UT_KVP_ARENA_ALIGNMENT - 1) & ~(uintptr_t)(UT_KVP_ARENA_ALIGNMENT - 1);
+    pBlock->used = (start + size) - (uintptr_t)pBlock->pData;
+
+    return (void *)start;
+}
+
+static void arenaFree(ut_kvp_arena_t *pArena)
+{
+    ut_kvp_arena_block_t *pBlock = pArena->pBlocks;
+
+    while (pBlock != NULL)
+    {
+        ut_kvp_arena_block_t *pNext = pBlock->pNext;
+        free(pBlock);
+        pBlock = pNext;
+    }
+    memset(pArena, 0, sizeof(ut_kvp_arena_t));
+}
+
+static void indexBuild(ut_kvp_instance_internal_t *pInternal)
+{
+    ut_kvp_index_t *pIndex = &pInternal->index;
+    struct fy_node *root;
+    size_t pathSize = UT_KVP_MAX_ELEMENT_SIZE;
+    char *pPath;
+
+    /* The arena holds nothing but index tables, a rebuild releases the previous ones. A document shared
+       with a clone keeps its tables in pShared, only this instance's own arena is released */
+    indexFree(pIndex);
+    arenaFree(&pInternal->arena);
+    pIndex->pArena = &pInternal->arena;
+
+    root = fy_document_root(pInternal->fy_handle);
+    if (root == NULL)
+    {
+        return;
+    }
+
+    pPath = malloc(pathSize);
+    if (pPath == NULL)
+    {
+        UT_LOG_ERROR("Memory allocation error, index not built");
+        return;
+    }
+
+    if (indexAddNode(pIndex, root, &pPath, &pathSize, 0) != 0)
+    {
+        /* Lookups fall back to walking the document */
+        UT_LOG_ERROR("Unable to build index, falling back to path lookups");
+        indexFree(pIndex);
+    }
+
+    free(pPath);
+}
+
+static void indexFree(ut_kvp_index_t *pIndex)
+{
+    /* Slots and paths stay in the arena until the instance's next open or close */
+    memset(pIndex, 0, sizeof(ut_kvp_index_t));
+}
+
+static int indexAddNode(ut_kvp_index_t *pIndex, struct fy_node *node, char **ppPath, size_t *pPathSize, size_t pathLength)
+{
+    void *iter = NULL;
+    const char *pName;
+    char zPosition[16];
+    size_t nameLength;
+    size_t newLength;
+    uint32_t position = 0;
+
+    if (indexInsert(pIndex, *ppPath, pathLength, node) != 0)
+    {
+        return -1;
+    }
+
+    if (!fy_node_is_mapping(node) && !fy_node_is_sequence(node))
+    {
+        return 0;
+    }
+
+    while (1)
+    {
+        struct fy_node *child;
+
+        if (fy_node_is_mapping(node))
+        {
+            struct fy_node_pair *pair = fy_node_mapping_iterate(node, &iter);
+            if (pair == NULL)
+            {
+                break;
+            }
+            child = followAlias(fy_node_pair_value(pair));
+            pName = fy_node_get_scalar(fy_node_pair_key(pair), &nameLength);
+            if ((pName == NULL) || (child == NULL))
+            {
+                /* Complex keys can't be addressed by path */
+                continue;
+            }
+        }
+        else
+        {
+            child = fy_node_sequence_iterate(node, &iter);
+            if (child == NULL)
+            {
+                break;
+            }
+            child = followAlias(child);
+            nameLength = snprintf(zPosition, sizeof(zPosition), "%u", position++);
+            pName = zPosition;
+        }
+
+        newLength = (pathLength > 0) ? (pathLength + 1 + nameLength) : nameLength;
+        if (newLength >= *pPathSize)
+        {
+            char *pNewPath = realloc(*ppPath, newLength * 2);
+            if (pNewPath == NULL)
+            {
+                return -1;
+            }
+            *ppPath = pNewPath;
+            *pPathSize = newLength * 2;
+        }
+
+        if (pathLength > 0)
+        {
+            (*ppPath)[pathLength] = '/';
+        }
+        memcpy(&(*ppPath)[newLength - nameLength], pName, nameLength);
+
+        if (indexAddNode(pIndex, child, ppPath, pPathSize, newLength) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int indexInsert(ut_kvp_index_t *pIndex, const char *pPath, size_t pathLength, struct fy_node *node)
+{
+    ut_kvp_index_entry_t *pEntry;
+    uint32_t hash = 2166136261u;    /* FNV-1a */
+    uint32_t mask;
+    char *pKey;
+
+    for (size_t i = 0; i < pathLength; i++)
+    {
+        hash ^= (unsigned char)pPath[i];
+        hash *= 16777619u;
+    }
+
+    // Keep the load factor at or below one half
+    if ((pIndex->count + 1) * 2 > pIndex->capacity)
+    {
+        uint32_t newCapacity = (pIndex->capacity == 0) ? UT_KVP_INDEX_INITIAL_CAPACITY : pIndex->capacity * 2;
+        ut_kvp_index_entry_t *pNewEntries = arenaAlloc(pIndex->pArena, newCapacity * sizeof(ut_kvp_index_entry_t));
+
+        if (pNewEntries == NULL)
+        {
+            return -1;
+        }
+        memset(pNewEntries, 0, newCapacity * sizeof(ut_kvp_index_entry_t));
+
+        for (uint32_t i = 0; i < pIndex->capacity; i++)
+        {
+            ut_kvp_index_entry_t *pOld = &pIndex->pEntries[i];
+            uint32_t slot;
+
+            if (pOld->node == NULL)
+            {
+                continue;
+            }
+            slot = pOld->hash & (newCapacity - 1);
+            while (pNewEntries[slot].node != NULL)
+            {
+                slot = (slot + 1) & (newCapacity - 1);
+            }
+            pNewEntries[slot] = *pOld;
+        }
+
+        /* The outgrown table is left in the arena, at most doubling the memory held */
+        pIndex->pEntries = pNewEntries;
+        pIndex->capacity = newCapacity;
+    }
+
+    mask = pIndex->capacity - 1;
+    pEntry = &pIndex->pEntries[hash & mask];
+    while (pEntry->node != NULL)
+    {
+        if ((pEntry->hash == hash) && (pEntry->keyLength == pathLength) &&
+            (memcmp(pEntry->pKey, pPath, pathLength) == 0))
+        {
+            /* Duplicate path, the first node wins as it does for a document walk */
+            return 0;
+        }
+        pEntry = &pIndex->pEntries[(pEntry - pIndex->pEntries + 1) & mask];
+    }
+
+    pKey = arenaAlloc(pIndex->pArena, (pathLength > 0) ? pathLength : 1);
+    if (pKey == NULL)
+    {
+        return -1;
+    }
+    memcpy(pKey, pPath, pathLength);
+
+    pEntry->hash = hash;
+    pEntry->keyLength = pathLength;
+    pEntry->pKey = pKey;
+    pEntry->node = node;
+    pIndex->count++;
+
+    return 0;
+}
+
+static struct fy_node *indexLookup(ut_kvp_index_t *pIndex, const char *pszKey)
+{
+    ut_kvp_index_entry_t *pEntry;
+    uint32_t hash = 2166136261u;    /* FNV-1a, matching indexInsert() */
+    uint32_t mask = pIndex->capacity - 1;
+    size_t length = 0;
+
+    /* Paths are stored relative to the root */
+    if (*pszKey == '/')
+    {
+        pszKey++;
+    }
+
+    // Hash the key in its slash form, so dotted keys need no conversion
+    for (const char *p = pszKey; *p != '\0'; p++, length++)
+    {
+        hash ^= (unsigned char)((*p == '.') ? '/' : *p);
+        hash *= 16777619u;
+    }
+
+    pEntry = &pIndex->pEntries[hash & mask];
+    while (pEntry->node != NULL)
+    {
+        if ((pEntry->hash == hash) && (pEntry->keyLength == length))
+        {
+            const char *pStored = pEntry->pKey;
+            size_t i;
+
+            for (i = 0; i < length; i++)
+            {
+                if (pStored[i] != ((pszKey[i] == '.') ? '/' : pszKey[i]))
+                {
+                    break;
+                }
+            }
+            if (i == length)
+            {
+                return pEntry->node;
+            }
+        }
+        pEntry = &pIndex->pEntries[(pEntry - pIndex->pEntries + 1) & mask];
+    }
+
+    return NULL;
+}
+
+static const char *imageValue(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry, size_t *pLength)
+{
+    if ((pEntry == NULL) || (pEntry->kind != UT_KVP_IMAGE_KIND_SCALAR))
+    {
+        return NULL;
+    }
+
+    /* Zero terminated in the pool, valid until the instance is closed */
+    *pLength = pEntry->valueLength;
+    return &pImage->pPool[pEntry->valueOffset];
+}
+
+static const char *imageScalar(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry, const char *pszKey, size_t *pLength, ut_kvp_status_t *pStatus)
+{
+    const char *pString;
+
+    if (pEntry == NULL)
+    {
+        UT_LOG_ERROR("node not found for key = [%s] : UT_KVP_STATUS_KEY_NOT_FOUND", pszKey);
+        *pStatus = UT_KVP_STATUS_KEY_NOT_FOUND;
+        return NULL;
+    }
+
+    pString = imageValue(pImage, pEntry, pLength);
+    if (pString == NULL)
+    {
+        UT_LOG_ERROR("invalid key");
+        *pStatus = UT_KVP_STATUS_PARSING_ERROR;
+        return NULL;
+    }
+
+    *pStatus = UT_KVP_STATUS_SUCCESS;
+    return pString;
+}
+
+static int imageCompare(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry, const char *pszKey)
+{
+    const unsigned char *pPath = (const unsigned char *)&pImage->pPool[pEntry->pathOffset];
+    uint32_t i;
+
+    for (i = 0; i < pEntry->pathLength; i++)
+    {
+        unsigned char c = (unsigned char)((pszKey[i] == '.') ? '/' : pszKey[i]);
+
+        if (c == '\0')
+        {
+            return 1;
+        }
+        if (pPath[i] != c)
+        {
+            return (pPath[i] < c) ? -1 : 1;
+        }
+    }
+
+    return (pszKey[i] == '\0') ? 0 : -1;
+}
+
+static const ut_kvp_image_entry_t *imageFind(const ut_kvp_image_t *pImage, const char *pszKey)
+{
+    uint32_t low = 0;
+    uint32_t high = pImage->pHeader->entryCount;
+
+    /* Paths are stored relative to the root */
+    if (*pszKey == '/')
+    {
+        pszKey++;
+    }
+
+    // Lower bound over the sorted paths, dotted keys compare as their slash form
+    while (low < high)
+    {
+        uint32_t middle = low + ((high - low) / 2);
+
+        if (imageCompare(pImage, &pImage->pEntries[middle], pszKey) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    /* Equal paths are kept in document order, so the first one wins as it does for a document walk */
+    for (; (low < pImage->pHeader->entryCount) && (imageCompare(pImage, &pImage->pEntries[low], pszKey) == 0); low++)
+    {
+        if (pImage->pEntries[low].kind != UT_KVP_IMAGE_KIND_NULL)
+        {
+            return &pImage->pEntries[low];
+        }
+    }
+
+    return NULL;
+}
+
+static const ut_kvp_image_entry_t *imageChild(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry, uint32_t position)
+{
+    return &pImage->pEntries[pImage->pChildren[pEntry->firstChild + position]];
+}
+
+static ut_kvp_status_t imageValidate(ut_kvp_image_t *pImage, const void *pData, size_t size)
+{
+    const ut_kvp_image_header_t *pHeader = (const ut_kvp_image_header_t *)pData;
+    const char *pBase = (const char *)pData;
+
+    if ((pHeader->magic != UT_KVP_IMAGE_MAGIC) || (pHeader->byteOrder != UT_KVP_IMAGE_BYTE_ORDER))
+    {
+        UT_LOG_ERROR("Image magic or byte order mismatch");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    if ((pHeader->version != UT_KVP_IMAGE_VERSION) || (pHeader->entrySize != sizeof(ut_kvp_image_entry_t)))
+    {
+        UT_LOG_ERROR("Unsupported image version [%u]", pHeader->version);
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    // Every section must lie inside the file, with the entry table aligned for its 64 bit members
+    if ((pHeader->imageSize != size) || (pHeader->entryCount == 0) || (pHeader->poolSize == 0) ||
+        ((pHeader->entriesOffset % UT_KVP_IMAGE_ALIGNMENT) != 0) ||
+        (((uint64_t)pHeader->entriesOffset + ((uint64_t)pHeader->entryCount * sizeof(ut_kvp_image_entry_t))) > size) ||
+        ((pHeader->childrenOffset % sizeof(uint32_t)) != 0) ||
+        (((uint64_t)pHeader->childrenOffset + ((uint64_t)pHeader->childCount * sizeof(uint32_t))) > size) ||
+        (((uint64_t)pHeader->poolOffset + pHeader->poolSize) > size) ||
+        (pBase[pHeader->poolOffset + pHeader->poolSize - 1] != '\0'))
+    {
+        UT_LOG_ERROR("Image sections out of range");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    pImage->pHeader = pHeader;
+    pImage->pEntries = (const ut_kvp_image_entry_t *)&pBase[pHeader->entriesOffset];
+    pImage->pChildren = (const uint32_t *)&pBase[pHeader->childrenOffset];
+    pImage->pPool = &pBase[pHeader->poolOffset];
+
+    /* A linear pass over fixed size records, nothing is parsed */
+    for (uint32_t i = 0; i < pHeader->entryCount; i++)
+    {
+        const ut_kvp_image_entry_t *pEntry = &pImage->pEntries[i];
+
+        if ((pEntry->kind > UT_KVP_IMAGE_KIND_SEQUENCE) ||
+            (((uint64_t)pEntry->pathOffset + pEntry->pathLength) >= pHeader->poolSize) ||
+            (((uint64_t)pEntry->nameOffset + pEntry->nameLength) >= pHeader->poolSize) ||
+            (((uint64_t)pEntry->valueOffset + pEntry->valueLength) >= pHeader->poolSize) ||
+            (pImage->pPool[pEntry->valueOffset + pEntry->valueLength] != '\0') ||
+            (((uint64_t)pEntry->firstChild + pEntry->childCount) > pHeader->childCount))
+        {
+            UT_LOG_ERROR("Image entry [%u] out of range", i);
+            memset(pImage, 0, sizeof(ut_kvp_image_t));
+            return UT_KVP_STATUS_PARSING_ERROR;
+        }
+    }
+
+    for (uint32_t i = 0; i < pHeader->childCount; i++)
+    {
+        if (pImage->pChildren[i] >= pHeader->entryCount)
+        {
+            UT_LOG_ERROR("Image child [%u] out of range", i);
+            memset(pImage, 0, sizeof(ut_kvp_image_t));
+            return UT_KVP_STATUS_PARSING_ERROR;
+        }
+    }
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static int imagePoolAppend(ut_kvp_image_builder_t *pBuilder, const char *pString, size_t length, uint32_t *pOffset)
+{
+    // Offsets are 32 bit, and every string is stored zero terminated
+    if (pBuilder->poolUsed + length + 1 > UINT32_MAX)
+    {
+        UT_LOG_ERROR("Profile too large for an image");
+        return -1;
+    }
+
+    if (pBuilder->poolUsed + length + 1 > pBuilder->poolSize)
+    {
+        size_t newSize = (pBuilder->poolSize == 0) ? 4096 : pBuilder->poolSize;
+        char *pNewPool;
+
+        while (pBuilder->poolUsed + length + 1 > newSize)
+        {
+            newSize *= 2;
+        }
+        pNewPool = realloc(pBuilder->pPool, newSize);
+        if (pNewPool == NULL)
+        {
+            return -1;
+        }
+        pBuilder->pPool = pNewPool;
+        pBuilder->poolSize = newSize;
+    }
+
+    if (length > 0)
+    {
+        memcpy(&pBuilder->pPool[pBuilder->poolUsed], pString, length);
+    }
+    pBuilder->pPool[pBuilder->poolUsed + length] = '\0';
+    *pOffset = (uint32_t)pBuilder->poolUsed;
+    pBuilder->poolUsed += length + 1;
+
+    return 0;
+}
+
+static void imagePreparse(ut_kvp_image_entry_t *pEntry, const char *pValue, size_t length)
+{
+    size_t digits = ((length > 2) && (pValue[0] == '0') && (pValue[1] == 'x')) ? strspn(&pValue[2], "0123456789abcdefABCDEF") + 2 : strspn(pValue, "0123456789");
+    char *endPtr;
+
+    if (str_to_bool(pValue, length, NULL) == true)
+    {
+        pEntry->flags |= UT_KVP_IMAGE_FLAG_TRUE;
+    }
+
+    /* Only values the getters would accept are stored, the rest take the text path and report there */
+    if ((length > 0) && (digits == length) && (parseUInt64(pValue, length, UINT64_MAX, &pEntry->uValue) == true))
+    {
+        pEntry->flags |= UT_KVP_IMAGE_FLAG_UINT;
+    }
+
+    if ((length > 0) && (length < UT_KVP_MAX_NUMBER_SIZE))
+    {
+        pEntry->dValue = strtod(pValue, &endPtr);
+        if (*endPtr == '\0')
+        {
+            pEntry->fValue = strtof(pValue, &endPtr);
+            pEntry->flags |= UT_KVP_IMAGE_FLAG_DOUBLE;
+        }
+        else
+        {
+            pEntry->dValue = 0;
+        }
+    }
+}
+
+static int imageAddNode(ut_kvp_image_builder_t *pBuilder, struct fy_node *node, char **ppPath, size_t *pPathSize, size_t pathLength, uint32_t *pIndex)
+{
+    uint32_t index = pBuilder->entryCount;
+    uint32_t pathOffset;
+    uint32_t firstChild;
+    uint32_t filled = 0;
+    void *iter = NULL;
+    char zPosition[16];
+    int count;
+
+    if (pBuilder->entryCount == pBuilder->entryCapacity)
+    {
+        uint32_t newCapacity = (pBuilder->entryCapacity == 0) ? UT_KVP_INDEX_INITIAL_CAPACITY : pBuilder->entryCapacity * 2;
+        ut_kvp_image_entry_t *pNewEntries = realloc(pBuilder->pEntries, newCapacity * sizeof(ut_kvp_image_entry_t));
+
+        if (pNewEntries == NULL)
+        {
+            return -1;
+        }
+        pBuilder->pEntries = pNewEntries;
+        pBuilder->entryCapacity = newCapacity;
+    }
+
+    if (imagePoolAppend(pBuilder, *ppPath, pathLength, &pathOffset) != 0)
+    {
+        return -1;
+    }
+
+    memset(&pBuilder->pEntries[index], 0, sizeof(ut_kvp_image_entry_t));
+    pBuilder->pEntries[index].pathOffset = pathOffset;
+    pBuilder->pEntries[index].pathLength = (uint32_t)pathLength;
+    pBuilder->entryCount++;
+    *pIndex = index;
+
+    if (node == NULL)
+    {
+        /* A mapping key without a value, kept so iterators still visit it */
+        pBuilder->pEntries[index].kind = UT_KVP_IMAGE_KIND_NULL;
+        return 0;
+    }
+
+    if (fy_node_is_scalar(node))
+    {
+        size_t valueLength = 0;
+        const char *pValue = fy_node_get_scalar(node, &valueLength);
+        uint32_t valueOffset;
+
+        if (pValue == NULL)
+        {
+            valueLength = 0;
+        }
+        if (imagePoolAppend(pBuilder, pValue, valueLength, &valueOffset) != 0)
+        {
+            return -1;
+        }
+        pBuilder->pEntries[index].kind = UT_KVP_IMAGE_KIND_SCALAR;
+        pBuilder->pEntries[index].valueOffset = valueOffset;
+        pBuilder->pEntries[index].valueLength = (uint32_t)valueLength;
+        imagePreparse(&pBuilder->pEntries[index], &pBuilder->pPool[valueOffset], valueLength);
+        return 0;
+    }
+
+    if (!fy_node_is_mapping(node) && !fy_node_is_sequence(node))
+    {
+        return 0;
+    }
+
+    // Reserve the children together, so each container's list is contiguous in the table
+    count = fy_node_is_mapping(node) ? fy_node_mapping_item_count(node) : fy_node_sequence_item_count(node);
+    if (count < 0)
+    {
+        count = 0;
+    }
+    if (pBuilder->childCount + (uint32_t)count > pBuilder->childCapacity)
+    {
+        uint32_t newCapacity = (pBuilder->childCapacity == 0) ? UT_KVP_INDEX_INITIAL_CAPACITY : pBuilder->childCapacity;
+        uint32_t *pNewChildren;
+
+        while (pBuilder->childCount + (uint32_t)count > newCapacity)
+        {
+            newCapacity *= 2;
+        }
+        pNewChildren = realloc(pBuilder->pChildren, newCapacity * sizeof(uint32_t));
+        if (pNewChildren == NULL)
+        {
+            return -1;
+        }
+        pBuilder->pChildren = pNewChildren;
+        pBuilder->childCapacity = newCapacity;
+    }
+    firstChild = pBuilder->childCount;
+    pBuilder->childCount += (uint32_t)count;
+    pBuilder->pEntries[index].kind = fy_node_is_mapping(node) ? UT_KVP_IMAGE_KIND_MAPPING : UT_KVP_IMAGE_KIND_SEQUENCE;
+    pBuilder->pEntries[index].firstChild = firstChild;
+
+    while (filled < (uint32_t)count)
+    {
+        struct fy_node *child;
+        const char *pName;
+        size_t nameLength;
+        size_t newLength;
+        uint32_t childIndex;
+
+        if (fy_node_is_mapping(node))
+        {
+            struct fy_node_pair *pair = fy_node_mapping_iterate(node, &iter);
+            if (pair == NULL)
+            {
+                break;
+            }
+            child = followAlias(fy_node_pair_value(pair));
+            pName = fy_node_get_scalar(fy_node_pair_key(pair), &nameLength);
+            if (pName == NULL)
+            {
+                /* Complex keys can't be addressed by path */
+                continue;
+            }
+        }
+        else
+        {
+            child = fy_node_sequence_iterate(node, &iter);
+            if (child == NULL)
+            {
+                break;
+            }
+            child = followAlias(child);
+            nameLength = snprintf(zPosition, sizeof(zPosition), "%u", filled);
+            pName = zPosition;
+        }
+
+        newLength = (pathLength > 0) ? (pathLength + 1 + nameLength) : nameLength;
+        if (newLength >= *pPathSize)
+        {
+            char *pNewPath = realloc(*ppPath, newLength * 2);
+            if (pNewPath == NULL)
+            {
+                return -1;
+            }
+            *ppPath = pNewPath;
+            *pPathSize = newLength * 2;
+        }
+
+        if (pathLength > 0)
+        {
+            (*ppPath)[pathLength] = '/';
+        }
+        memcpy(&(*ppPath)[newLength - nameLength], pName, nameLength);
+
+        if (imageAddNode(pBuilder, child, ppPath, pPathSize, newLength, &childIndex) != 0)
+        {
+            return -1;
+        }
+
+        if (fy_node_is_mapping(node))
+        {
+            /* The key is the tail of the child's path */
+            pBuilder->pEntries[childIndex].flags |= UT_KVP_IMAGE_FLAG_NAMED;
+            pBuilder->pEntries[childIndex].nameOffset = pBuilder->pEntries[childIndex].pathOffset + (uint32_t)(newLength - nameLength);
+            pBuilder->pEntries[childIndex].nameLength = (uint32_t)nameLength;
+        }
+        pBuilder->pChildren[firstChild + filled] = childIndex;
+        filled++;
+    }
+
+    /* Skipped complex keys leave unused slots at the end of the list */
+    pBuilder->pEntries[index].childCount = filled;
+
+    return 0;
+}
+
+static int imageSortCompare(const void *pLeft, const void *pRight)
+{
+    const ut_kvp_image_sort_t *pA = (const ut_kvp_image_sort_t *)pLeft;
+    const ut_kvp_image_sort_t *pB = (const ut_kvp_image_sort_t *)pRight;
+    uint32_t length = (pA->length < pB->length) ? pA->length : pB->length;
+    int result = memcmp(pA->pPath, pB->pPath, length);
+
+    if (result != 0)
+    {
+        return result;
+    }
+    if (pA->length != pB->length)
+    {
+        return (pA->length < pB->length) ? -1 : 1;
+    }
+
+    /* Equal paths keep document order */
+    return (pA->index < pB->index) ? -1 : (pA->index > pB->index);
+}
+
+static ut_kvp_status_t imageSerialise(ut_kvp_image_builder_t *pBuilder, char **ppData, size_t *pSize)
+{
+    ut_kvp_image_header_t header;
+    ut_kvp_image_sort_t *pSort;
+    uint32_t *pRank;
+    uint64_t imageSize;
+    char *pData;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = UT_KVP_IMAGE_MAGIC;
+    header.version = UT_KVP_IMAGE_VERSION;
+    header.byteOrder = UT_KVP_IMAGE_BYTE_ORDER;
+    header.entrySize = sizeof(ut_kvp_image_entry_t);
+    header.entryCount = pBuilder->entryCount;
+    header.childCount = pBuilder->childCount;
+    header.poolSize = (uint32_t)pBuilder->poolUsed;
+    header.entriesOffset = (sizeof(header) + UT_KVP_IMAGE_ALIGNMENT - 1) & ~(UT_KVP_IMAGE_ALIGNMENT - 1);
+    header.childrenOffset = header.entriesOffset + (header.entryCount * sizeof(ut_kvp_image_entry_t));
+
+    imageSize = (uint64_t)header.childrenOffset + ((uint64_t)header.childCount * sizeof(uint32_t)) + pBuilder->poolUsed;
+    if (((uint64_t)header.entryCount * sizeof(ut_kvp_image_entry_t) > UINT32_MAX) || (imageSize > UINT32_MAX))
+    {
+        UT_LOG_ERROR("Profile too large for an image");
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+    header.poolOffset = header.childrenOffset + (header.childCount * sizeof(uint32_t));
+    header.imageSize = (uint32_t)imageSize;
+
+    pSort = malloc(pBuilder->entryCount * sizeof(ut_kvp_image_sort_t));
+    pRank = malloc(pBuilder->entryCount * sizeof(uint32_t));
+    pData = calloc(1, (size_t)imageSize);
+    if ((pSort == NULL) || (pRank == NULL) || (pData == NULL))
+    {
+        UT_LOG_ERROR("Memory allocation error");
+        free(pSort);
+        free(pRank);
+        free(pData);
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+
+    // Sort the entries by path, then renumber the children table to match
+    for (uint32_t i = 0; i < pBuilder->entryCount; i++)
+    {
+        pSort[i].pPath = &pBuilder->pPool[pBuilder->pEntries[i].pathOffset];
+        pSort[i].length = pBuilder->pEntries[i].pathLength;
+        pSort[i].index = i;
+    }
+    qsort(pSort, pBuilder->entryCount, sizeof(ut_kvp_image_sort_t), imageSortCompare);
+
+    memcpy(pData, &header, sizeof(header));
+    for (uint32_t i = 0; i < pBuilder->entryCount; i++)
+    {
+        memcpy(&pData[header.entriesOffset + (i * sizeof(ut_kvp_image_entry_t))], &pBuilder->pEntries[pSort[i].index], sizeof(ut_kvp_image_entry_t));
+        pRank[pSort[i].index] = i;
+    }
+    for (uint32_t i = 0; i < pBuilder->childCount; i++)
+    {
+        uint32_t rank = pRank[pBuilder->pChildren[i]];
+
+        memcpy(&pData[header.childrenOffset + (i * sizeof(uint32_t))], &rank, sizeof(uint32_t));
+    }
+    memcpy(&pData[header.poolOffset], pBuilder->pPool, pBuilder->poolUsed);
+
+    free(pSort);
+    free(pRank);
+
+    *ppData = pData;
+    *pSize = (size_t)imageSize;
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static ut_kvp_status_t imageWrite(const char *pszFileName, const void *pData, size_t size)
+{
+    char zTempName[PATH_MAX];
+    FILE *pFile;
+    size_t written;
+
+    // Written alongside and renamed, so a process mapping the previous image never sees a partial one
+    if (snprintf(zTempName, sizeof(zTempName), "%s.tmp", pszFileName) >= (int)sizeof(zTempName))
+    {
+        UT_LOG_ERROR("Invalid Param - fileName too long");
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+
+    pFile = fopen(zTempName, "wb");
+    if (pFile == NULL)
+    {
+        UT_LOG_ERROR("[%s] cannot be created", zTempName);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
+    }
+
+    written = fwrite(pData, 1, size, pFile);
+    if ((fclose(pFile) != 0) || (written != size) || (rename(zTempName, pszFileName) != 0))
+    {
+        UT_LOG_ERROR("[%s] cannot be written", pszFileName);
+        unlink(zTempName);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
+    }
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static void imageBuilderFree(ut_kvp_image_builder_t *pBuilder)
+{
+    free(pBuilder->pEntries);
+    free(pBuilder->pChildren);
+    free(pBuilder->pPool);
+    memset(pBuilder, 0, sizeof(ut_kvp_image_builder_t));
+}
+
+// Callback function for libcurl to write downloaded data into a MemoryStruct
+static size_t write_memory_callback(void *contents, size_t size, size_t nmemb, void *userp)
+{
+    size_t realsize = size * nmemb;
+    ut_kvp_download_memory_internal_t *downloadMemory = (ut_kvp_download_memory_internal_t *)userp;
+
+    char *ptr = realloc(downloadMemory->memory, downloadMemory->size + realsize + 1);
+    if (ptr == NULL)
+    {
+        // Out of memory
+        UT_LOG_ERROR("Not enough memory (realloc returned NULL)\n");
+        return 0;
+    }
+
+    downloadMemory->memory = ptr;
+    memcpy(&(downloadMemory->memory[downloadMemory->size]), contents, realsize);
+    downloadMemory->size += realsize;
+    downloadMemory->memory[downloadMemory->size] = 0;
+
+    return realsize;
+}
+
+static int expandDocument(struct fy_document *doc, int depth, ut_kvp_include_context_t *pContext)
+{
+    struct fy_node *root = fy_document_root(doc);
+    struct fy_node *expanded = root;
+
+    if (root == NULL)
+    {
+        UT_LOG_ERROR("Error : Document is empty.\n");
+        return -1;
+    }
+
+    if (expandNode(&expanded, doc, depth, pContext) != 0)
+    {
+        return -1;
+    }
+
+    // An !include tag on the root replaces the whole document
+    if (expanded != root)
+    {
+        return fy_document_set_root(doc, expanded);
+    }
+    return 0;
+}
+
+static int expandNode(struct fy_node **pNode, struct fy_document *doc, int depth, ut_kvp_include_context_t *pContext)
+{
+    if (depth >= pContext->maxDepth)
+    {
+        UT_LOG_ERROR("Error : Maximum include depth exceeded.\n");
+        pContext->leftOut++;
+        return -1;
+    }
+
+    // A node that is itself an !include is handed back replaced, the caller disposes of the original
+    if (isIncludeTag(*pNode))
+    {
+        struct fy_node *included = includeShared(fy_node_get_scalar0(*pNode), depth, doc, pContext);
+
+        if (included == NULL)
+        {
+            return -1;
+        }
+        *pNode = included;
+        return 0;
+    }
+
+    expandIncludes(*pNode, doc, depth, pContext);
+    return 0;
+}
+
+static void expandIncludes(struct fy_node *node, struct fy_document *doc, int depth, ut_kvp_include_context_t *pContext)
+{
+    ut_kvp_include_edit_t *pEdits = NULL;
+    uint32_t editCount = 0;
+    uint32_t editCapacity = 0;
+    void *iter = NULL;
+
+    // Only containers that hold an include are edited, and only once their walk is complete
+    if (fy_node_is_mapping(node))
+    {
+        struct fy_node_pair *pair;
+
+        while ((pair = fy_node_mapping_iterate(node, &iter)) != NULL)
+        {
+            struct fy_node *key = fy_node_pair_key(pair);
+            struct fy_node *value = fy_node_pair_value(pair);
+            const char *pKey;
+            size_t keyLength = 0;
+
+            if ((key == NULL) || (value == NULL))
+            {
+                continue;
+            }
+
+            // Handle include keys like "include_0", "include", etc.
+            pKey = fy_node_get_scalar(key, &keyLength);
+            if ((pKey != NULL) && fy_node_is_scalar(value) && find_pattern_from_buffer(pKey, keyLength, "include", strlen("include")))
+            {
+                struct fy_node *included;
+
+                /* Merged into this mapping, so nothing inside may refer to a shared subtree */
+                pContext->shareSuspended++;
+                included = process_include(fy_node_get_scalar0(value), depth, doc, pContext);
+                pContext->shareSuspended--;
+
+                /* A failed include leaves the key as it is */
+                if (included != NULL)
+                {
+                    addIncludeEdit(&pEdits, &editCount, &editCapacity, pair, included);
+                }
+                continue;
+            }
+
+            if (isIncludeTag(value))
+            {
+                struct fy_node *included = includeShared(fy_node_get_scalar0(value), depth, doc, pContext);
+
+                if (included != NULL)
+                {
+                    fy_node_pair_set_value(pair, included);
+                }
+                else
+                {
+                    /* A failed include drops the key */
+                    addIncludeEdit(&pEdits, &editCount, &editCapacity, pair, NULL);
+                }
+                continue;
+            }
+
+            expandIncludes(value, doc, depth, pContext);
+        }
+
+        if (editCount > 0)
+        {
+            applyIncludeEdits(node, pEdits, editCount);
+        }
+    }
+    else if (fy_node_is_sequence(node))
+    {
+        struct fy_node *entry;
+
+        while ((entry = fy_node_sequence_iterate(node, &iter)) != NULL)
+        {
+            if (isIncludeTag(entry))
+            {
+                /* A failed include drops the entry */
+                addIncludeEdit(&pEdits, &editCount, &editCapacity, entry, includeShared(fy_node_get_scalar0(entry), depth, doc, pContext));
+                continue;
+            }
+
+            // If entry is a mapping with "include": ...
+            if (fy_node_is_mapping(entry))
+            {
+                struct fy_node *incl = fy_node_mapping_lookup_by_string(entry, "include", 7);
+
+                if ((incl != NULL) && fy_node_is_scalar(incl))
+                {
+                    struct fy_node *included = includeShared(fy_node_get_scalar0(incl), depth, doc, pContext);
+
+                    if (included != NULL)
+                    {
+                        addIncludeEdit(&pEdits, &editCount, &editCapacity, entry, included);
+                        continue;
+                    }
+                }
+            }
+
+            expandIncludes(entry, doc, depth, pContext);
+        }
+
+        for (uint32_t i = 0; i < editCount; i++)
+        {
+            struct fy_node *removed = (struct fy_node *)pEdits[i].pChild;
+
+            if ((pEdits[i].replacement != NULL) && (fy_node_sequence_insert_before(node, removed, pEdits[i].replacement) != 0))
+            {
+                UT_LOG_ERROR("Error inserting node into sequence");
+                fy_node_free(pEdits[i].replacement);
+            }
+            fy_node_free(fy_node_sequence_remove(node, removed));
+        }
+    }
+
+    free(pEdits);
+}
+
+static struct fy_node *includeShared(const char *filename, int depth, struct fy_document *doc, ut_kvp_include_context_t *pContext)
+{
+    ut_kvp_include_share_t *pShare;
+    struct fy_node *included;
+    uint32_t leftOut;
+
+    if ((pContext->share == false) || (pContext->shareSuspended != 0) || (filename == NULL))
+    {
+        return process_include(filename, depth, doc, pContext);
+    }
+
+    // Later sites alias the subtree built at the first, which precedes them in document order. Only a
+    // site at the same depth would expand it the same, and only if nothing was cut from it
+    for (uint32_t i = 0; i < pContext->sharedCount; i++)
+    {
+        pShare = &pContext->pShared[i];
+        if ((strcmp(pShare->pszName, filename) == 0) && (depth == pShare->depth) && pShare->complete)
+        {
+            included = fy_node_create_alias_copy(doc, pShare->zAnchor, strlen(pShare->zAnchor));
+            if (included != NULL)
+            {
+                return included;
+            }
+            break;
+        }
+    }
+
+    leftOut = pContext->leftOut;
+    included = process_include(filename, depth, doc, pContext);
+    if (included == NULL)
+    {
+        return NULL;
+    }
+
+    if (pContext->sharedCount == pContext->sharedCapacity)
+    {
+        uint32_t newCapacity = (pContext->sharedCapacity == 0) ? 8 : (pContext->sharedCapacity * 2);
+        ut_kvp_include_share_t *pNewShared = realloc(pContext->pShared, newCapacity * sizeof(ut_kvp_include_share_t));
+
+        if (pNewShared == NULL)
+        {
+            /* This site keeps its own copy, later ones make theirs */
+            return included;
+        }
+        pContext->pShared = pNewShared;
+        pContext->sharedCapacity = newCapacity;
+    }
+
+    pShare = &pContext->pShared[pContext->sharedCount];
+    snprintf(pShare->zAnchor, sizeof(pShare->zAnchor), "ut_kvp_include_%u", pContext->sharedCount);
+    pShare->pszName = strdup(filename);
+    pShare->depth = depth;
+    pShare->complete = (pContext->leftOut == leftOut);
+    if ((pShare->pszName == NULL) || (fy_node_set_anchor_copy(included, pShare->zAnchor, strlen(pShare->zAnchor)) != 0))
+    {
+        free(pShare->pszName);
+        return included;
+    }
+    pContext->sharedCount++;
+
+    return included;
+}
+
+static void includeShareFree(ut_kvp_include_context_t *pContext)
+{
+    for (uint32_t i = 0; i < pContext->sharedCount; i++)
+    {
+        free(pContext->pShared[i].pszName);
+    }
+    free(pContext->pShared);
+    pContext->pShared = NULL;
+    pContext->sharedCount = 0;
+    pContext->sharedCapacity = 0;
+}
+
+static bool isIncludeTag(struct fy_node *node)
+{
+    size_t tagLength = 0;
+    const char *pTag = fy_node_get_tag(node, &tagLength);
+
+    return ((pTag != NULL) && (strncmp(pTag, "!include", tagLength) == 0) && fy_node_is_scalar(node));
+}
+
+static void addIncludeEdit(ut_kvp_include_edit_t **ppEdits, uint32_t *pCount, uint32_t *pCapacity, void *pChild, struct fy_node *replacement)
+{
+    if (*pCount == *pCapacity)
+    {
+        uint32_t newCapacity = (*pCapacity == 0) ? 4 : (*pCapacity * 2);
+        ut_kvp_include_edit_t *pNewEdits = realloc(*ppEdits, newCapacity * sizeof(ut_kvp_include_edit_t));
+
+        if (pNewEdits == NULL)
+        {
+            /* The child stays as it was parsed */
+            UT_LOG_ERROR("Memory allocation error, include not applied");
+            fy_node_free(replacement);
+            return;
+        }
+        *ppEdits = pNewEdits;
+        *pCapacity = newCapacity;
+    }
+
+    (*ppEdits)[*pCount].pChild = pChild;
+    (*ppEdits)[*pCount].replacement = replacement;
+    (*pCount)++;
+}
+
+static void applyIncludeEdits(struct fy_node *node, ut_kvp_include_edit_t *pEdits, uint32_t editCount)
+{
+    struct fy_document *doc = fy_node_document(node);
+    ut_kvp_include_move_t *pMoves;
+    struct fy_node_pair *pair;
+    int pairCount = fy_node_mapping_item_count(node);
+    int count = 0;
+    uint32_t edit = 0;
+    bool moving = false;
+    void *iter = NULL;
+
+    pMoves = malloc(((pairCount > 0) ? pairCount : 1) * sizeof(ut_kvp_include_move_t));
+    if (pMoves == NULL)
+    {
+        UT_LOG_ERROR("Memory allocation error, includes not applied");
+        for (uint32_t i = 0; i < editCount; i++)
+        {
+            fy_node_free(pEdits[i].replacement);
+        }
+        return;
+    }
+
+    while ((count < pairCount) && ((pair = fy_node_mapping_iterate(node, &iter)) != NULL))
+    {
+        pMoves[count++].pair = pair;
+    }
+
+    // From the first merged include on every pair is taken out, so the included keys land where the include key stood
+    for (int i = 0; i < count; i++)
+    {
+        ut_kvp_include_move_t *pMove = &pMoves[i];
+        struct fy_node *key = fy_node_pair_key(pMove->pair);
+        struct fy_node *value;
+        bool edited = ((edit < editCount) && (pEdits[edit].pChild == pMove->pair));
+
+        pMove->key = NULL;
+        pMove->value = NULL;
+
+        if (edited)
+        {
+            pMove->value = pEdits[edit++].replacement;
+            moving = moving || (pMove->value != NULL);
+        }
+        else if (moving)
+        {
+            pMove->key = fy_node_copy(doc, key);
+            if (pMove->key == NULL)
+            {
+                UT_LOG_ERROR("Node copy failed, key left in place");
+                continue;
+            }
+        }
+        else
+        {
+            continue;
+        }
+
+        // Frees the pair and its key, only the value comes back
+        value = fy_node_mapping_remove_by_key(node, key);
+        if (edited)
+        {
+            fy_node_free(value);
+        }
+        else
+        {
+            pMove->value = value;
+        }
+    }
+
+    // Put back in document order, a key the include already supplied keeps the included value
+    for (int i = 0; i < count; i++)
+    {
+        if (pMoves[i].key != NULL)
+        {
+            if (fy_node_mapping_append(node, pMoves[i].key, pMoves[i].value) != 0)
+            {
+                UT_LOG_ERROR("Error appending node to mapping");
+                fy_node_free(pMoves[i].key);
+                fy_node_free(pMoves[i].value);
+            }
+        }
+        else if (pMoves[i].value != NULL)
+        {
+            merge_nodes(node, pMoves[i].value);
+            fy_node_free(pMoves[i].value);
+        }
+    }
+
+    free(pMoves);
+}
+
+static void merge_nodes(struct fy_node *mainNode, struct fy_node *includeNode)
+{
+
+    if (mainNode == NULL)
+    {
+        UT_LOG_ERROR("Main node is invalid");
+        return;
+    }
+
+    if (includeNode == NULL)
+    {
+        UT_LOG_ERROR("Included node is invalid");
+        return;
+    }
+
+    if (fy_node_is_scalar(mainNode))
+    {
+        fy_node_create_scalar_copy(fy_node_document(mainNode), fy_node_get_scalar(includeNode, NULL), fy_node_get_scalar_length(includeNode));
+    }
+    else if (fy_node_is_mapping(mainNode) && fy_node_is_mapping(includeNode))
+    {
+        if (fy_node_insert(mainNode, includeNode) != 0)
+        {
+            UT_LOG_ERROR("Node merge failed");
+        }
+    }
+    else
+    {
+        UT_LOG_ERROR("Warning: Cannot merge nodes of incompatible types\n");
+    }
+}
+
+static struct fy_node* process_include(const char *filename, int depth, struct fy_document *doc, ut_kvp_include_context_t *pContext)
+{
+    ut_kvp_include_target_t target;
+    struct fy_node *root;
+    struct fy_node *expanded;
+    int status;
+
+    if (depth >= pContext->maxDepth)
+    {
+        UT_LOG_ERROR( "Error: Maximum include depth exceeded.\n");
+        pContext->leftOut++;
+        return NULL;
+    }
+
+    if (!includeBudgetLeft(pContext, NULL))
+    {
+        return NULL;
+    }
+
+    // A file already being expanded further out would include itself forever, stop at the first repeat
+    if (includeChainPush(pContext, filename, &target) != 0)
+    {
+        return NULL;
+    }
+
+    // The parsed tree comes from the cache, its own includes are expanded once copied
+    root = includeCacheCopy(filename, &target, doc, pContext);
+    if (root == NULL)
+    {
+        includeChainPop(pContext);
+        return NULL;
+    }
+
+    expanded = root;
+    status = expandNode(&expanded, doc, depth + 1, pContext);
+    includeChainPop(pContext);
+    if (status != 0)
+    {
+        fy_node_free(root);
+        return NULL;
+    }
+
+    if (expanded != root)
+    {
+        fy_node_free(root);
+    }
+    return expanded;
+}
+
+static int includeChainPush(ut_kvp_include_context_t *pContext, const char *filename, ut_kvp_include_target_t *pTarget)
+{
+    ut_kvp_include_target_t profile;
+    char *pszCopy;
+
+    /* The profile itself is only checked, an include keeps what it resolved to for the copy */
+    if (pTarget == NULL)
+    {
+        pTarget = &profile;
+    }
+    pTarget->pMember = NULL;
+    pTarget->pszKey = NULL;
+    pTarget->isFile = false;
+
+    if (filename == NULL)
+    {
+        UT_LOG_ERROR("Error: Include has no name.\n");
+        return -1;
+    }
+
+    // Bundle members are known by name alone, anything else by canonical path or URL
+    if (pContext->pBundle != NULL)
+    {
+        pTarget->pMember = bundleFind(pContext->pBundle, filename);
+    }
+    if (pTarget->pMember != NULL)
+    {
+        pszCopy = strndup(pTarget->pMember->pName, pTarget->pMember->nameLength);
+    }
+    else
+    {
+        pTarget->pszKey = includeCacheKey(filename, pTarget->zPath, &pTarget->fileStat, &pTarget->isFile);
+        if (pTarget->pszKey == NULL)
+        {
+            return -1;
+        }
+        pszCopy = strdup(pTarget->pszKey);
+        if ((pszCopy != NULL) && pTarget->isFile)
+        {
+            includeFileRecord(pContext, pszCopy);
+        }
+    }
+    if (pszCopy == NULL)
+    {
+        UT_LOG_ERROR("Memory allocation error, include not applied");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < pContext->chainLength; i++)
+    {
+        if (strcmp(pContext->ppChain[i], pszCopy) == 0)
+        {
+            UT_LOG_ERROR("Error: Include cycle, '%s' includes itself.\n", filename);
+            pContext->leftOut++;
+            free(pszCopy);
+            return -1;
+        }
+    }
+
+    if (pContext->chainLength == pContext->chainCapacity)
+    {
+        uint32_t newCapacity = (pContext->chainCapacity == 0) ? 8 : (pContext->chainCapacity * 2);
+        char **ppNewChain = realloc(pContext->ppChain, newCapacity * sizeof(char *));
+
+        if (ppNewChain == NULL)
+        {
+            UT_LOG_ERROR("Memory allocation error, include not applied");
+            free(pszCopy);
+            return -1;
+        }
+        pContext->ppChain = ppNewChain;
+        pContext->chainCapacity = newCapacity;
+    }
+    pContext->ppChain[pContext->chainLength++] = pszCopy;
+
+    return 0;
+}
+
+static ut_kvp_status_t watchStart(ut_kvp_instance_internal_t *pInternal, int *pFd)
+{
+    if (pInternal->watch.hasSource == false)
+    {
+        UT_LOG_ERROR("Profile not opened from a file, nothing to watch");
+        return UT_KVP_STATUS_NO_DATA;
+    }
+
+    if (pInternal->watch.fd < 0)
+    {
+        pInternal->watch.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (pInternal->watch.fd < 0)
+        {
+            UT_LOG_ERROR("Unable to create inotify instance");
+            return UT_KVP_STATUS_FILE_OPEN_ERROR;
+        }
+    }
+
+    if (watchRegister(pInternal) != 0)
+    {
+        watchStop(&pInternal->watch);
+        return UT_KVP_STATUS_FILE_OPEN_ERROR;
+    }
+
+    if (pFd != NULL)
+    {
+        *pFd = pInternal->watch.fd;
+    }
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static ut_kvp_status_t reloadChanged(ut_kvp_instance_internal_t *pInternal, bool *pReloaded)
+{
+    ut_kvp_status_t status;
+    char *pszSource;
+
+    if (pInternal->watch.fd < 0)
+    {
+        UT_LOG_ERROR("Profile not watched");
+        return UT_KVP_STATUS_NO_DATA;
+    }
+
+    if (!watchDrain(pInternal))
+    {
+        return UT_KVP_STATUS_SUCCESS;
+    }
+
+    /* The file list is replaced by the reload */
+    pszSource = strdup(pInternal->watch.ppFiles[0]);
+    if (pszSource == NULL)
+    {
+        UT_LOG_ERROR("Memory allocation error, profile not reloaded");
+        return UT_KVP_STATUS_PARSING_ERROR;
+    }
+
+    if (pInternal->flags & UT_KVP_FLAG_CONCURRENT)
+    {
+        ut_kvp_publish_request_t request = { .op = UT_KVP_PUBLISH_RELOAD, .pszFile = pszSource };
+
+        status = publishLocked(pInternal, &request);
+        free(pszSource);
+        if (status != UT_KVP_STATUS_SUCCESS)
+        {
+            return status;
+        }
+    }
+    else
+    {
+        // Built aside and swapped in complete, a profile that no longer parses leaves the current one in place
+        status = adoptDocument(pInternal, fy_document_build_from_file(NULL, pszSource), pszSource, NULL);
+        free(pszSource);
+        if (status != UT_KVP_STATUS_SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    if (pReloaded != NULL)
+    {
+        *pReloaded = true;
+    }
+
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+static int watchRegister(ut_kvp_instance_internal_t *pInternal)
+{
+    ut_kvp_watch_t *pWatch = &pInternal->watch;
+    ut_kvp_watch_dir_t *pDirs = NULL;
+    uint32_t dirCount = 0;
+    int result = 0;
+
+    if (pWatch->fileCount > 0)
+    {
+        pDirs = calloc(pWatch->fileCount, sizeof(ut_kvp_watch_dir_t));
+        if (pDirs == NULL)
+        {
+            UT_LOG_ERROR("Memory allocation error, profile not watched");
+            return -1;
+        }
+    }
+
+    // Directories are watched rather than files, so editors that save by renaming over the file are seen
+    for (uint32_t i = 0; i < pWatch->fileCount; i++)
+    {
+        const char *pSlash = strrchr(pWatch->ppFiles[i], '/');
+        size_t dirLength = (pSlash == NULL) ? 0 : (size_t)(pSlash - pWatch->ppFiles[i]);
+        char *pszDir;
+        bool known = false;
+
+        pszDir = (dirLength == 0) ? strdup("/") : strndup(pWatch->ppFiles[i], dirLength);
+        if (pszDir == NULL)
+        {
+            result = -1;
+            break;
+        }
+        for (uint32_t j = 0; (j < dirCount) && !known; j++)
+        {
+            known = (strcmp(pDirs[j].pszDir, pszDir) == 0);
+        }
+        if (known)
+        {
+            free(pszDir);
+            continue;
+        }
+
+        /* Adding a directory already watched hands back its existing descriptor */
+        pDirs[dirCount].wd = inotify_add_watch(pWatch->fd, pszDir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE);
+        if (pDirs[dirCount].wd < 0)
+        {
+            UT_LOG_ERROR("[%s] cannot be watched", pszDir);
+            free(pszDir);
+            result = -1;
+            continue;
+        }
+        pDirs[dirCount].pszDir = pszDir;
+        dirCount++;
+    }
+
+    // Directories the profile no longer includes from stop being watched
+    for (uint32_t i = 0; i < pWatch->dirCount; i++)
+    {
+        bool kept = false;
+
+        for (uint32_t j = 0; (j < dirCount) && !kept; j++)
+        {
+            kept = (pDirs[j].wd == pWatch->pDirs[i].wd);
+        }
+        if (!kept)
+        {
+            inotify_rm_watch(pWatch->fd, pWatch->pDirs[i].wd);
+        }
+        free(pWatch->pDirs[i].pszDir);
+    }
+    free(pWatch->pDirs);
+    pWatch->pDirs = pDirs;
+    pWatch->dirCount = dirCount;
+
+    return result;
+}
+
+static bool watchDrain(ut_kvp_instance_internal_t *pInternal)
+{
+    ut_kvp_watch_t *pWatch = &pInternal->watch;
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    char zPath[PATH_MAX];
+    bool changed = false;
+    bool overflow = false;
+    ssize_t length;
+
+    while ((length = read(pWatch->fd, buffer, sizeof(buffer))) > 0)
+    {
+        for (char *pNext = buffer; pNext < buffer + length; )
+        {
+            const struct inotify_event *pEvent = (const struct inotify_event *)pNext;
+            const char *pszDir = NULL;
+
+            pNext += sizeof(struct inotify_event) + pEvent->len;
+
+            if (pEvent->mask & IN_Q_OVERFLOW)
+            {
+                overflow = true;
+                continue;
+            }
+            for (uint32_t i = 0; (i < pWatch->dirCount) && (pszDir == NULL); i++)
+            {
+                if (pWatch->pDirs[i].wd == pEvent->wd)
+                {
+                    pszDir = pWatch->pDirs[i].pszDir;
+                }
+            }
+            if ((pszDir == NULL) || (pEvent->len == 0))
+            {
+                continue;
+            }
+
+            snprintf(zPath, sizeof(zPath), "%s/%s", (strcmp(pszDir, "/") == 0) ? "" : pszDir, pEvent->name);
+            for (uint32_t i = 0; i < pWatch->fileCount; i++)
+            {
+                // The cached parse goes, so the reload parses this file again and nothing else
+                if (strcmp(pWatch->ppFiles[i], zPath) == 0)
+                {
+                    includeCacheDrop(zPath);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    /* Events were lost, any of the files may have changed */
+    if (overflow)
+    {
+        for (uint32_t i = 0; i < pWatch->fileCount; i++)
+        {
+            includeCacheDrop(pWatch->ppFiles[i]);
+        }
+        changed = true;
+    }
+
+    return changed;
+}
+
+static void watchStop(ut_kvp_watch_t *pWatch)
+{
+    for (uint32_t i = 0; i < pWatch->dirCount; i++)
+    {
+        free(pWatch->pDirs[i].pszDir);
+    }
+    free(pWatch->pDirs);
+    pWatch->pDirs = NULL;
+    pWatch->dirCount = 0;
+
+    if (pWatch->fd >= 0)
+    {
+        close(pWatch->fd);
+        pWatch->fd = -1;
+    }
+}
+
+static void watchFilesFree(char **ppFiles, uint32_t fileCount)
+{
+    for (uint32_t i = 0; i < fileCount; i++)
+    {
+        free(ppFiles[i]);
+    }
+    free(ppFiles);
+}
+
+static void includeFileRecord(ut_kvp_include_context_t *pContext, const char *pszPath)
+{
+    char *pszCopy;
+
+    for (uint32_t i = 0; i < pContext->fileCount; i++)
+    {
+        if (strcmp(pContext->ppFiles[i], pszPath) == 0)
+        {
+            return;
+        }
+    }
+
+    if (pContext->fileCount == pContext->fileCapacity)
+    {
+        uint32_t newCapacity = (pContext->fileCapacity == 0) ? 8 : (pContext->fileCapacity * 2);
+        char **ppNewFiles = realloc(pContext->ppFiles, newCapacity * sizeof(char *));
+
+        if (ppNewFiles == NULL)
+        {
+            /* Only a watch misses out */
+            return;
+        }
+        pContext->ppFiles = ppNewFiles;
+        pContext->fileCapacity = newCapacity;
+    }
+
+    pszCopy = strdup(pszPath);
+    if (pszCopy != NULL)
+    {
+        pContext->ppFiles[pContext->fileCount++] = pszCopy;
+    }
+}
+
+static void includeChainPop(ut_kvp_include_context_t *pContext)
+{
+    if (pContext->chainLength > 0)
+    {
+        free(pContext->ppChain[--pContext->chainLength]);
+    }
+}
+
+static struct fy_document *includeLoadUrl(const char *url, ut_kvp_include_context_t *pContext, ut_kvp_url_validators_t *pValidators, bool *pNotModified)
+{
+    ut_kvp_download_memory_internal_t mChunk;
+    ut_kvp_url_validators_t cached;
+    ut_kvp_url_validators_t received;
+    struct curl_slist *pHeaders = NULL;
+    char zDirectory[PATH_MAX];
+    char zCachePath[PATH_MAX];
+    char zHeader[UT_KVP_URL_VALIDATOR_SIZE + 32];
+    char *pCachedBody = NULL;
+    size_t cachedSize = 0;
+    uint32_t remainingMs;
+    uint32_t connectMs;
+    uint32_t transferMs;
+    bool offline;
+    bool held;
+
+    /* Validators passed in belong to a parsed copy the caller holds, a 304 keeps using it */
+    *pNotModified = false;
+    held = (pValidators->zETag[0] != '\0') || (pValidators->zLastModified[0] != '\0');
+
+    pthread_mutex_lock(&gUrlCache.lock);
+    strcpy(zDirectory, gUrlCache.zDirectory);
+    offline = gUrlCache.offline;
+    pthread_mutex_unlock(&gUrlCache.lock);
+
+    memset(&cached, 0, sizeof(cached));
+    memset(&received, 0, sizeof(received));
+    if (zDirectory[0] != '\0')
+    {
+        urlCachePath(zDirectory, url, zCachePath);
+        if (held == false)
+        {
+            pCachedBody = urlCacheRead(zCachePath, url, &cached, &cachedSize);
+        }
+    }
+    if (held)
+    {
+        cached = *pValidators;
+    }
+
+    // Offline, the cached copy is the only one there is
+    if (offline)
+    {
+        if (held)
+        {
+            *pNotModified = true;
+            return NULL;
+        }
+        if (pCachedBody == NULL)
+        {
+            UT_LOG_ERROR("Error: '%s' is not cached and the network is not used offline\n", url);
+            return NULL;
+        }
+        *pValidators = cached;
+        return urlBuildDocument(pCachedBody, cachedSize);
+    }
+
+    // Each fetch is bounded by its own timeouts, and by what is left of the budget of the open
+    if (!includeBudgetLeft(pContext, &remainingMs))
+    {
+        free(pCachedBody);
+        return NULL;
+    }
+    connectMs = pContext->connectTimeoutMs;
+    transferMs = pContext->transferTimeoutMs;
+    if ((remainingMs != 0) && ((connectMs == 0) || (connectMs > remainingMs)))
+    {
+        connectMs = remainingMs;
+    }
+    if ((remainingMs != 0) && ((transferMs == 0) || (transferMs > remainingMs)))
+    {
+        transferMs = remainingMs;
+    }
+
+    mChunk.memory = malloc(1);
+    mChunk.size = 0;
+
+    if (!mChunk.memory)
+    {
+        UT_LOG_ERROR( "Error: Not enough memory to store curl response\n");
+        free(pCachedBody);
+        return NULL;
+    }
+
+    pthread_once(&gCurlInitOnce, curlGlobalInit);
+
+    CURL *curl = curlAcquire();
+    if (!curl)
+    {
+        UT_LOG_ERROR( "Error: Could not initialize curl\n");
+        free(mChunk.memory);
+        free(pCachedBody);
+        return NULL;
+    }
+
+    // A cached copy is revalidated rather than downloaded again
+    if (held || (pCachedBody != NULL))
+    {
+        if (cached.zETag[0] != '\0')
+        {
+            snprintf(zHeader, sizeof(zHeader), "If-None-Match: %s", cached.zETag);
+            pHeaders = curl_slist_append(pHeaders, zHeader);
+        }
+        if (cached.zLastModified[0] != '\0')
+        {
+            snprintf(zHeader, sizeof(zHeader), "If-Modified-Since: %s", cached.zLastModified);
+            pHeaders = curl_slist_append(pHeaders, zHeader);
+        }
+    }
+
+    CURLcode res;
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    if (gpCurlShare != NULL)
+    {
+        /* Lookups and TLS sessions are shared, connections stay with the handle that opened them */
+        curl_easy_setopt(curl, CURLOPT_SHARE, gpCurlShare);
+    }
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, (long)connectMs);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)transferMs);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, pHeaders);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, url_header_callback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void *)&received);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_memory_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&mChunk);
+    res = curl_easy_perform(curl);
+    curl_slist_free_all(pHeaders);
+    if (res != CURLE_OK)
+    {
+        UT_LOG_ERROR( "Error: curl_easy_perform() failed: %s\n", curl_easy_strerror(res));
+        free(mChunk.memory);
+        free(pCachedBody);
+        curlRelease(curl);
+        if (res == CURLE_OPERATION_TIMEDOUT)
+        {
+            /* Marks the open as out of time when it was the budget that ran out */
+            includeBudgetLeft(pContext, NULL);
+        }
+        return NULL;
+    }
+
+    long response_code;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    curlRelease(curl);
+
+    if ((response_code == 304) && held)
+    {
+        free(mChunk.memory);
+        *pNotModified = true;
+        return NULL;
+    }
+    if ((response_code == 304) && (pCachedBody != NULL))
+    {
+        free(mChunk.memory);
+        *pValidators = cached;
+        return urlBuildDocument(pCachedBody, cachedSize);
+    }
+    free(pCachedBody);
+
+    if (response_code != 200)
+    {
+        UT_LOG_ERROR( "Error: HTTP request failed with code %ld\n", response_code);
+        free(mChunk.memory);
+        return NULL;
+    }
+
+    if (zDirectory[0] != '\0')
+    {
+        urlCacheWrite(zDirectory, zCachePath, url, &received, mChunk.memory, mChunk.size);
+    }
+
+    *pValidators = received;
+    return urlBuildDocument(mChunk.memory, mChunk.size);
+}
+
+static struct fy_document *urlBuildDocument(char *pBody, size_t size)
+{
+    // fy_document_build_from_malloc_string():  The string is expected to have been allocated by malloc(3) and when the document is destroyed it will be automatically freed.
+    struct fy_document *srcDoc = fy_document_build_from_malloc_string(NULL, pBody, size);
+    if (srcDoc == NULL)
+    {
+        UT_LOG_ERROR("Error: Cannot parse included content\n");
+        free(pBody);
+    }
+
+    return srcDoc;
+}
+
+static size_t url_header_callback(char *buffer, size_t size, size_t nitems, void *userdata)
+{
+    ut_kvp_url_validators_t *pValidators = (ut_kvp_url_validators_t *)userdata;
+    size_t length = size * nitems;
+    char *pTarget = NULL;
+    size_t nameLength = 0;
+
+    if ((length > 5) && (strncasecmp(buffer, "ETag:", 5) == 0))
+    {
+        pTarget = pValidators->zETag;
+        nameLength = 5;
+    }
+    else if ((length > 14) && (strncasecmp(buffer, "Last-Modified:", 14) == 0))
+    {
+        pTarget = pValidators->zLastModified;
+        nameLength = 14;
+    }
+
+    if (pTarget != NULL)
+    {
+        const char *pValue = buffer + nameLength;
+        size_t valueLength = length - nameLength;
+
+        // Header lines arrive with their line ending and are not terminated
+        while ((valueLength > 0) && ((*pValue == ' ') || (*pValue == '\t')))
+        {
+            pValue++;
+            valueLength--;
+        }
+        while ((valueLength > 0) && ((pValue[valueLength - 1] == '\r') || (pValue[valueLength - 1] == '\n') || (pValue[valueLength - 1] == ' ')))
+        {
+            valueLength--;
+        }
+        if (valueLength < UT_KVP_URL_VALIDATOR_SIZE)
+        {
+            memcpy(pTarget, pValue, valueLength);
+            pTarget[valueLength] = '\0';
+        }
+    }
+
+    return length;
+}
+
+static void urlCachePath(const char *pszDirectory, const char *url, char *pszPath)
+{
+    uint64_t hash = 14695981039346656037ULL;   /* FNV-1a */
+
+    for (const char *p = url; *p != '\0'; p++)
+    {
+        hash ^= (unsigned char)*p;
+        hash *= 1099511628211ULL;
+    }
+
+    snprintf(pszPath, PATH_MAX, "%s/%016llx.yaml", pszDirectory, (unsigned long long)hash);
+}
+
+static char *urlCacheRead(const char *pszPath, const char *url, ut_kvp_url_validators_t *pValidators, size_t *pSize)
+{
+    char zLine[UT_KVP_URL_VALIDATOR_SIZE + 32];
+    char *pBody = NULL;
+    long start;
+    long end;
+    FILE *file = fopen(pszPath, "rb");
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    // Header lines: magic, URL, ETag, Last-Modified, then the body as it was received
+    if ((fgets(zLine, sizeof(zLine), file) == NULL) || (strcmp(zLine, UT_KVP_URL_CACHE_MAGIC "\n") != 0))
+    {
+        fclose(file);
+        return NULL;
+    }
+    pBody = malloc(strlen(url) + 2);
+    if ((pBody == NULL) || (fgets(pBody, strlen(url) + 2, file) == NULL) ||
+        (strncmp(pBody, url, strlen(url)) != 0) || (pBody[strlen(url)] != '\n'))
+    {
+        /* Another URL with the same hash */
+        free(pBody);
+        fclose(file);
+        return NULL;
+    }
+    free(pBody);
+
+    if ((fgets(pValidators->zETag, UT_KVP_URL_VALIDATOR_SIZE, file) == NULL) ||
+        (fgets(pValidators->zLastModified, UT_KVP_URL_VALIDATOR_SIZE, file) == NULL))
+    {
+        fclose(file);
+        return NULL;
+    }
+    pValidators->zETag[strcspn(pValidators->zETag, "\n")] = '\0';
+    pValidators->zLastModified[strcspn(pValidators->zLastModified, "\n")] = '\0';
+
+    start = ftell(file);
+    if ((start < 0) || (fseek(file, 0, SEEK_END) != 0) || ((end = ftell(file)) < start) || (fseek(file, start, SEEK_SET) != 0))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    pBody = malloc((end - start) + 1);
+    if ((pBody == NULL) || (fread(pBody, 1, end - start, file) != (size_t)(end - start)))
+    {
+        free(pBody);
+        fclose(file);
+        return NULL;
+    }
+    pBody[end - start] = '\0';
+    *pSize = end - start;
+
+    fclose(file);
+    return pBody;
+}
+
+static void urlCacheWrite(const char *pszDirectory, const char *pszPath, const char *url, const ut_kvp_url_validators_t *pValidators, const char *pBody, size_t size)
+{
+    char zTemp[PATH_MAX];
+    bool written;
+    FILE *file;
+    int fd;
+
+    // Written aside and renamed into place, so readers never see a partial entry
+    if (snprintf(zTemp, sizeof(zTemp), "%s/.ut_kvp_XXXXXX", pszDirectory) >= (int)sizeof(zTemp))
+    {
+        return;
+    }
+    fd = mkstemp(zTemp);
+    if (fd < 0)
+    {
+        UT_LOG_ERROR("Error: Cannot write to URL cache '%s'\n", pszDirectory);
+        return;
+    }
+
+    file = fdopen(fd, "wb");
+    if (file == NULL)
+    {
+        close(fd);
+        unlink(zTemp);
+        return;
+    }
+
+    fprintf(file, "%s\n%s\n%s\n%s\n", UT_KVP_URL_CACHE_MAGIC, url, pValidators->zETag, pValidators->zLastModified);
+    written = (fwrite(pBody, 1, size, file) == size);
+    if ((fclose(file) != 0) || !written || (rename(zTemp, pszPath) != 0))
+    {
+        UT_LOG_ERROR("Error: Cannot write to URL cache '%s'\n", pszDirectory);
+        unlink(zTemp);
+    }
+}
+
+static struct fy_node *includeCacheCopy(const char *filename, const ut_kvp_include_target_t *pTarget, struct fy_document *doc, ut_kvp_include_context_t *pContext)
+{
+    ut_kvp_include_cache_entry_t *pEntry;
+    struct fy_document *srcDoc;
+    struct fy_node *copy;
+    ut_kvp_url_validators_t validators;
+    const char *pszKey = pTarget->pszKey;
+    bool isFile = pTarget->isFile;
+    bool notModified;
+
+    // Bundle members refer into a mapping owned by the instance, so they bypass the process-wide cache
+    if (pTarget->pMember != NULL)
+    {
+        srcDoc = fy_document_build_from_string(NULL, pTarget->pMember->pData, pTarget->pMember->size);
+        if (srcDoc == NULL)
+        {
+            UT_LOG_ERROR("Error: Cannot parse include file '%s' in bundle.\n", filename);
+            return NULL;
+        }
+        copy = NULL;
+        if (fy_document_root(srcDoc) != NULL)
+        {
+            copy = fy_node_copy(doc, fy_document_root(srcDoc));
+        }
+        else
+        {
+            UT_LOG_ERROR("Error : Document is empty.\n");
+        }
+        fy_document_destroy(srcDoc);
+        return copy;
+    }
+
+    memset(&validators, 0, sizeof(validators));
+    pthread_mutex_lock(&gIncludeCache.lock);
+    pEntry = includeCacheFind(pszKey, isFile ? &pTarget->fileStat : NULL);
+    if ((pEntry != NULL) && includeCacheCurrent(pEntry, pContext, &validators))
+    {
+        gIncludeCache.hits++;
+        copy = fy_node_copy(doc, fy_document_root(pEntry->pDocument));
+        pthread_mutex_unlock(&gIncludeCache.lock);
+        return copy;
+    }
+    gIncludeCache.misses++;
+    pthread_mutex_unlock(&gIncludeCache.lock);
+
+    // Parsed without the lock held, so a slow fetch doesn't stall other instances
+    srcDoc = includeParse(filename, isFile, pContext, &validators, &notModified);
+    if (notModified)
+    {
+        pthread_mutex_lock(&gIncludeCache.lock);
+        pEntry = includeCacheFind(pszKey, NULL);
+        if (pEntry != NULL)
+        {
+            pEntry->openSerial = pContext->openSerial;
+            copy = fy_node_copy(doc, fy_document_root(pEntry->pDocument));
+        }
+        pthread_mutex_unlock(&gIncludeCache.lock);
+        if (pEntry != NULL)
+        {
+            return copy;
+        }
+
+        /* Evicted while it was revalidated, so downloaded again */
+        memset(&validators, 0, sizeof(validators));
+        srcDoc = includeParse(filename, isFile, pContext, &validators, &notModified);
+    }
+    if (srcDoc == NULL)
+    {
+        return NULL;
+    }
+
+    return includeCacheStore(pszKey, isFile, &pTarget->fileStat, &validators, pContext->openSerial, srcDoc, doc);
+}
+
+static const char *includeCacheKey(const char *filename, char *pszPath, struct stat *pFileStat, bool *pIsFile)
+{
+    *pIsFile = (strncmp(filename, "http:", 5) != 0) && (strncmp(filename, "https:", 6) != 0);
+    if (*pIsFile == false)
+    {
+        return filename;
+    }
+
+    // Local files are keyed by canonical path, so every spelling of a path shares an entry
+    if ((stat(filename, pFileStat) != 0) || (realpath(filename, pszPath) == NULL))
+    {
+        UT_LOG_ERROR("Error: Cannot open include file '%s'.\n", filename);
+        return NULL;
+    }
+    return pszPath;
+}
+
+static struct fy_document *includeParse(const char *filename, bool isFile, ut_kvp_include_context_t *pContext, ut_kvp_url_validators_t *pValidators, bool *pNotModified)
+{
+    struct fy_document *srcDoc;
+
+    *pNotModified = false;
+    if (isFile)
+    {
+        srcDoc = fy_document_build_from_file(NULL, filename);
+        if (srcDoc == NULL)
+        {
+            UT_LOG_ERROR("Error: Cannot parse include file '%s'.\n", filename);
+            return NULL;
+        }
+    }
+    else
+    {
+        srcDoc = includeLoadUrl(filename, pContext, pValidators, pNotModified);
+        if (srcDoc == NULL)
         {
-            UT_LOG_ERROR("Invalid byte value: %s", token);
-            free(input_copy);
-            free(output_bytes); // Free the output buffer as well
             return NULL;
         }
+    }
+
+    if (fy_document_root(srcDoc) == NULL)
+    {
+        UT_LOG_ERROR("Error : Document is empty.\n");
+        fy_document_destroy(srcDoc);
+        return NULL;
+    }
+
+    return srcDoc;
+}
 
-        // Check if we need to expand the output buffer
-        if (byte_count >= buffer_size)
+static struct fy_node *includeCacheStore(const char *pszKey, bool isFile, const struct stat *pFileStat, const ut_kvp_url_validators_t *pValidators, uint64_t openSerial, struct fy_document *srcDoc, struct fy_document *doc)
+{
+    ut_kvp_include_cache_entry_t *pEntry;
+    struct fy_node *copy = NULL;
+
+    pEntry = malloc(sizeof(ut_kvp_include_cache_entry_t));
+    if ((pEntry == NULL) || ((pEntry->pszKey = strdup(pszKey)) == NULL))
+    {
+        /* Still usable, just not kept for the next reference */
+        free(pEntry);
+        if (doc != NULL)
         {
-            buffer_size *= 2; // Double the buffer size
-            output_bytes = (unsigned char *)realloc(output_bytes, buffer_size);
-            if (!output_bytes)
-            {
-                UT_LOG_ERROR("Memory reallocation error.\n");
-                free(input_copy);
-                return NULL;
-            }
+            copy = fy_node_copy(doc, fy_document_root(srcDoc));
         }
+        fy_document_destroy(srcDoc);
+        return copy;
+    }
+    pEntry->isFile = isFile;
+    if (isFile)
+    {
+        pEntry->mtime = pFileStat->st_mtim;
+        pEntry->size = pFileStat->st_size;
+    }
+    pEntry->validators = *pValidators;
+    pEntry->openSerial = openSerial;
+    pEntry->pDocument = srcDoc;
 
-        output_bytes[byte_count++] = (unsigned char)value;
-        token = strtok(NULL, ", ");
+    pthread_mutex_lock(&gIncludeCache.lock);
+    includeCacheInsert(pEntry);
+    if (doc != NULL)
+    {
+        copy = fy_node_copy(doc, fy_document_root(srcDoc));
     }
+    pthread_mutex_unlock(&gIncludeCache.lock);
 
-    free(input_copy);
-    *size = byte_count;
-    return output_bytes;
+    return copy;
 }
 
-/** Static Functions */
-static ut_kvp_instance_internal_t *validateInstance(ut_kvp_instance_t *pInstance)
+static ut_kvp_include_cache_entry_t *includeCacheFind(const char *pszKey, const struct stat *pFileStat)
 {
-    ut_kvp_instance_internal_t *pInternal = (ut_kvp_instance_internal_t *)pInstance;
+    ut_kvp_include_cache_entry_t **ppLink = &gIncludeCache.pEntries;
 
-    if (pInstance == NULL)
+    while (*ppLink != NULL)
     {
-        UT_LOG_ERROR("Invalid Handle");
-        return NULL;
-    }
+        ut_kvp_include_cache_entry_t *pEntry = *ppLink;
 
-    if (pInternal->magic != UT_KVP_MAGIC)
-    {
-        UT_LOG_ERROR("Invalid Handle - magic failure");
-        return NULL;
+        if (strcmp(pEntry->pszKey, pszKey) != 0)
+        {
+            ppLink = &pEntry->pNext;
+            continue;
+        }
+
+        *ppLink = pEntry->pNext;
+        if ((pFileStat != NULL) &&
+            ((pEntry->size != pFileStat->st_size) ||
+             (pEntry->mtime.tv_sec != pFileStat->st_mtim.tv_sec) ||
+             (pEntry->mtime.tv_nsec != pFileStat->st_mtim.tv_nsec)))
+        {
+            /* The file has changed since it was parsed */
+            includeCacheFreeEntry(pEntry);
+            gIncludeCache.count--;
+            return NULL;
+        }
+
+        // Move to the front, the tail is the least recently used
+        pEntry->pNext = gIncludeCache.pEntries;
+        gIncludeCache.pEntries = pEntry;
+        return pEntry;
     }
 
-    return pInternal;
+    return NULL;
 }
 
-static bool str_to_bool(const char *string)
+static bool includeCacheCurrent(const ut_kvp_include_cache_entry_t *pEntry, const ut_kvp_include_context_t *pContext, ut_kvp_url_validators_t *pValidators)
 {
-    if (strcasecmp(string, "true") == 0)
+    // A file was checked against its stat when found, a URL is asked about again once per open
+    if (pEntry->isFile || (pEntry->openSerial == pContext->openSerial))
     {
         return true;
     }
-    /* String is neither true or false, ensure we inform the caller*/
+
+    /* Sent back to the server, which answers 304 while the parsed copy is still current */
+    *pValidators = pEntry->validators;
     return false;
 }
 
-static void convert_dot_to_slash(const char *key, char *output)
+static void includeCacheDrop(const char *pszKey)
 {
-    if (strchr(key, '.'))
+    ut_kvp_include_cache_entry_t **ppLink;
+
+    pthread_mutex_lock(&gIncludeCache.lock);
+    for (ppLink = &gIncludeCache.pEntries; *ppLink != NULL; ppLink = &(*ppLink)->pNext)
     {
-        for (int i = 0; i <= UT_KVP_MAX_ELEMENT_SIZE; i++)
+        ut_kvp_include_cache_entry_t *pEntry = *ppLink;
+
+        if (strcmp(pEntry->pszKey, pszKey) == 0)
         {
-            char key_val = key[i];
-            if (key_val == '\0')
-            {
-                break;
-            }
-            if (key_val == '.')
-            {
-                output[i] = '/';
-            }
-            else
-            {
-                output[i] = key_val;
-            }
+            *ppLink = pEntry->pNext;
+            includeCacheFreeEntry(pEntry);
+            gIncludeCache.count--;
+            break;
         }
-        output[strlen(key)] = '\0';
-    }
-    else
-    {
-        snprintf(output, UT_KVP_MAX_ELEMENT_SIZE, "%s", key);
     }
+    pthread_mutex_unlock(&gIncludeCache.lock);
 }
 
-// Callback function for libcurl to write downloaded data into a MemoryStruct
-static size_t write_memory_callback(void *contents, size_t size, size_t nmemb, void *userp)
+static void includeCacheInsert(ut_kvp_include_cache_entry_t *pEntry)
 {
-    size_t realsize = size * nmemb;
-    ut_kvp_download_memory_internal_t *downloadMemory = (ut_kvp_download_memory_internal_t *)userp;
+    ut_kvp_include_cache_entry_t **ppLink = &gIncludeCache.pEntries;
+    uint32_t position = 0;
 
-    char *ptr = realloc(downloadMemory->memory, downloadMemory->size + realsize + 1);
-    if (ptr == NULL)
+    // Another instance may have parsed the same include meanwhile, the newest parse wins
+    while (*ppLink != NULL)
     {
-        // Out of memory
-        UT_LOG_ERROR("Not enough memory (realloc returned NULL)\n");
-        return 0;
+        ut_kvp_include_cache_entry_t *pOld = *ppLink;
+
+        if (strcmp(pOld->pszKey, pEntry->pszKey) == 0)
+        {
+            *ppLink = pOld->pNext;
+            includeCacheFreeEntry(pOld);
+            gIncludeCache.count--;
+            continue;
+        }
+        ppLink = &pOld->pNext;
     }
 
-    downloadMemory->memory = ptr;
-    memcpy(&(downloadMemory->memory[downloadMemory->size]), contents, realsize);
-    downloadMemory->size += realsize;
-    downloadMemory->memory[downloadMemory->size] = 0;
+    pEntry->pNext = gIncludeCache.pEntries;
+    gIncludeCache.pEntries = pEntry;
+    gIncludeCache.count++;
 
-    return realsize;
+    // Drop the least recently used entries beyond the limit
+    ppLink = &gIncludeCache.pEntries;
+    while (*ppLink != NULL)
+    {
+        if (position++ >= UT_KVP_INCLUDE_CACHE_MAX_ENTRIES)
+        {
+            ut_kvp_include_cache_entry_t *pOld = *ppLink;
+
+            *ppLink = pOld->pNext;
+            includeCacheFreeEntry(pOld);
+            gIncludeCache.count--;
+            continue;
+        }
+        ppLink = &(*ppLink)->pNext;
+    }
 }
 
-static struct fy_node* process_node_copy(struct fy_node *srcNode, struct fy_document *dstDoc, int depth)
+static void includeCacheFreeEntry(ut_kvp_include_cache_entry_t *pEntry)
 {
-    if (srcNode == NULL || dstDoc == NULL)
-    {
-        UT_LOG_ERROR("Error : Invalid input, src_node or dst_doc is NULL.\n");
-        return NULL;
-    }
+    fy_document_destroy(pEntry->pDocument);
+    free(pEntry->pszKey);
+    free(pEntry);
+}
 
-    if (depth >= UT_KVP_MAX_INCLUDE_DEPTH)
+static void includePrefetch(struct fy_document *doc, ut_kvp_include_context_t *pContext)
+{
+    ut_kvp_prefetch_t prefetch;
+    pthread_t threads[UT_KVP_INCLUDE_WORKERS];
+    uint32_t started = 0;
+    uint32_t queued;
+
+    memset(&prefetch, 0, sizeof(prefetch));
+    prefetch.pContext = pContext;
+    pthread_mutex_init(&prefetch.lock, NULL);
+    pthread_cond_init(&prefetch.wake, NULL);
+
+    includeCollect(fy_document_root(doc), &prefetch, 0);
+    queued = prefetch.count;
+    if ((queued > 0) && includeBudgetLeft(pContext, NULL))
     {
-        UT_LOG_ERROR("Error : Maximum include depth exceeded.\n");
-        return NULL;
-    }
+        // Workers may fetch URLs at the same time, libcurl must be initialised before that
+        pthread_once(&gCurlInitOnce, curlGlobalInit);
 
-    // Handle !include tag on scalar
-    size_t tag_len = 0;
-    const char *tag = fy_node_get_tag(srcNode, &tag_len);
-    if (tag && strncmp(tag, "!include", tag_len) == 0 && fy_node_is_scalar(srcNode))
-    {
-        const char *filepath = fy_node_get_scalar(srcNode, NULL);
-        if (filepath)
+        /* Read before the first worker starts, workers queue nested includes under the lock */
+        for (uint32_t i = 0; (i < UT_KVP_INCLUDE_WORKERS) && (i < queued); i++)
         {
-            struct fy_node *included = process_include(filepath, depth, dstDoc);
-            if (included)
+            if (pthread_create(&threads[started], NULL, includePrefetchWorker, &prefetch) == 0)
             {
-                return process_node_copy(included, dstDoc, depth + 1);
+                started++;
             }
         }
-        return NULL;
+
+        if (started == 0)
+        {
+            /* No threads to be had, the cache is still warmed one include at a time */
+            includePrefetchWorker(&prefetch);
+        }
+
+        for (uint32_t i = 0; i < started; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
     }
 
-    // Handle scalar node
-    if (fy_node_is_scalar(srcNode))
+    for (uint32_t i = 0; i < prefetch.count; i++)
     {
-        return fy_node_copy(dstDoc, srcNode);
+        free(prefetch.pJobs[i].pszName);
     }
+    free(prefetch.pJobs);
+    pthread_cond_destroy(&prefetch.wake);
+    pthread_mutex_destroy(&prefetch.lock);
+}
+
+static void *includePrefetchWorker(void *pArg)
+{
+    ut_kvp_prefetch_t *pPrefetch = pArg;
 
-    // Handle sequence node
-    if (fy_node_is_sequence(srcNode))
+    pthread_mutex_lock(&pPrefetch->lock);
+    while (1)
     {
-        struct fy_node *new_seq = fy_node_create_sequence(dstDoc);
-        if (new_seq == NULL)
+        ut_kvp_prefetch_job_t job;
+        ut_kvp_include_context_t context;
+        ut_kvp_include_cache_entry_t *pEntry;
+        struct fy_document *srcDoc;
+        struct stat fileStat;
+        ut_kvp_url_validators_t validators;
+        char zPath[PATH_MAX];
+        const char *pszKey;
+        bool notModified;
+        bool isFile;
+
+        // Idle until there is a job, or until no job is left and none can be added
+        while ((pPrefetch->next == pPrefetch->count) && (pPrefetch->busy > 0))
         {
-            return NULL;
+            pthread_cond_wait(&pPrefetch->wake, &pPrefetch->lock);
         }
-
-        void *iter = NULL;
-        struct fy_node *entry;
-        while ((entry = fy_node_sequence_iterate(srcNode, &iter)) != NULL)
+        if (pPrefetch->next == pPrefetch->count)
         {
-            struct fy_node *copied_entry = NULL;
+            break;
+        }
+        job = pPrefetch->pJobs[pPrefetch->next++];
+        pPrefetch->busy++;
+        context = *pPrefetch->pContext;
+        pthread_mutex_unlock(&pPrefetch->lock);
 
-            // If entry is a mapping with "include": ...
-            if (fy_node_is_mapping(entry))
+        pszKey = NULL;
+        if (includeBudgetLeft(&context, NULL))
+        {
+            pszKey = includeCacheKey(job.pszName, zPath, &fileStat, &isFile);
+        }
+        srcDoc = NULL;
+        memset(&validators, 0, sizeof(validators));
+        if (pszKey != NULL)
+        {
+            pthread_mutex_lock(&gIncludeCache.lock);
+            pEntry = includeCacheFind(pszKey, isFile ? &fileStat : NULL);
+            if ((pEntry != NULL) && includeCacheCurrent(pEntry, &context, &validators))
             {
-                struct fy_node *incl = fy_node_mapping_lookup_by_string(entry, "include", 7);
-                if (incl && fy_node_is_scalar(incl))
+                /* Already parsed, but what it includes may not be */
+                if (job.depth + 1 < context.maxDepth)
                 {
-                    const char *filepath = fy_node_get_scalar(incl, NULL);
-                    if (filepath)
-                    {
-                        struct fy_node *included = process_include(filepath, depth, dstDoc);
-                        if (included)
-                            copied_entry = process_node_copy(included, dstDoc, depth + 1);
-                    }
+                    pthread_mutex_lock(&pPrefetch->lock);
+                    includeCollect(fy_document_root(pEntry->pDocument), pPrefetch, job.depth + 1);
+                    pthread_mutex_unlock(&pPrefetch->lock);
                 }
             }
+            else
+            {
+                pEntry = NULL;
+                gIncludeCache.misses++;
+            }
+            pthread_mutex_unlock(&gIncludeCache.lock);
 
-            if (copied_entry == NULL)
+            if (pEntry == NULL)
             {
-                copied_entry = process_node_copy(entry, dstDoc, depth);
+                srcDoc = includeParse(job.pszName, isFile, &context, &validators, &notModified);
             }
 
-            if (copied_entry)
+            // Still current, the walk copies it for this open without asking again
+            if ((pEntry == NULL) && notModified)
             {
-                if (fy_node_sequence_append(new_seq, copied_entry) != 0)
+                pthread_mutex_lock(&gIncludeCache.lock);
+                pEntry = includeCacheFind(pszKey, NULL);
+                if (pEntry != NULL)
                 {
-                    UT_LOG_ERROR("Error appending node to sequence");
+                    pEntry->openSerial = context.openSerial;
+                    if (job.depth + 1 < context.maxDepth)
+                    {
+                        pthread_mutex_lock(&pPrefetch->lock);
+                        includeCollect(fy_document_root(pEntry->pDocument), pPrefetch, job.depth + 1);
+                        pthread_mutex_unlock(&pPrefetch->lock);
+                    }
                 }
+                pthread_mutex_unlock(&gIncludeCache.lock);
             }
         }
-        return new_seq;
-    }
 
-    // Handle mapping node
-    if (fy_node_is_mapping(srcNode))
-    {
-        //struct fy_document *includeDoc = NULL;
-        struct fy_node *new_map = fy_node_create_mapping(dstDoc);
-        if (new_map == NULL)
+        // Nested includes are queued before the parse is handed to the cache, which may evict it
+        pthread_mutex_lock(&pPrefetch->lock);
+        if ((srcDoc != NULL) && (job.depth + 1 < context.maxDepth))
         {
-            return NULL;
+            includeCollect(fy_document_root(srcDoc), pPrefetch, job.depth + 1);
+        }
+        if (context.expired)
+        {
+            pPrefetch->pContext->expired = true;
+        }
+        pPrefetch->busy--;
+        pthread_cond_broadcast(&pPrefetch->wake);
+        pthread_mutex_unlock(&pPrefetch->lock);
+
+        if (srcDoc != NULL)
+        {
+            includeCacheStore(pszKey, isFile, &fileStat, &validators, context.openSerial, srcDoc, NULL);
         }
 
-        void *iter = NULL;
+        pthread_mutex_lock(&pPrefetch->lock);
+    }
+    pthread_mutex_unlock(&pPrefetch->lock);
+
+    return NULL;
+}
+
+static void includeCollect(struct fy_node *node, ut_kvp_prefetch_t *pPrefetch, int depth)
+{
+    void *iter = NULL;
+
+    if (node == NULL)
+    {
+        return;
+    }
+
+    // The same references expandIncludes() acts on
+    if (isIncludeTag(node))
+    {
+        includeQueue(pPrefetch, fy_node_get_scalar0(node), depth);
+    }
+    else if (fy_node_is_mapping(node))
+    {
         struct fy_node_pair *pair;
 
-        while ((pair = fy_node_mapping_iterate(srcNode, &iter)) != NULL)
+        while ((pair = fy_node_mapping_iterate(node, &iter)) != NULL)
         {
-            struct fy_node *key_node = fy_node_pair_key(pair);
-            struct fy_node *val_node = fy_node_pair_value(pair);
-            if (!key_node || !val_node)
-                continue;
+            struct fy_node *value = fy_node_pair_value(pair);
+            const char *pKey;
+            size_t keyLength = 0;
 
-            size_t key_len;
-            const char *key_str = fy_node_get_scalar(key_node, &key_len);
-
-            // Handle include keys like "include_0", "include", etc.
-            if (key_str && fy_node_get_scalar(val_node, NULL) && find_pattern_from_buffer(key_str, key_len, "include", strlen("include")))
+            if (value == NULL)
             {
-                const char *filepath = fy_node_get_scalar(val_node, NULL);
-                if (filepath)
-                {
-                    struct fy_node *included = process_include(filepath, depth, dstDoc);
-                    if (included)
-                    {
-                        // If the included node is a mapping, merge it into the new_map
-                        merge_nodes(new_map, included);
-                        continue;
-                    }
-                }
+                continue;
             }
 
-            // Regular case: recursive copy
-            struct fy_node *copied_key = fy_node_copy(dstDoc, key_node);
-            struct fy_node *copied_val = process_node_copy(val_node, dstDoc, depth);
-
-            if (copied_key && copied_val)
+            pKey = fy_node_get_scalar(fy_node_pair_key(pair), &keyLength);
+            if ((pKey != NULL) && fy_node_is_scalar(value) && find_pattern_from_buffer(pKey, keyLength, "include", strlen("include")))
             {
-                if (fy_node_mapping_append(new_map, copied_key, copied_val) != 0)
-                {
-                    UT_LOG_ERROR("Error appending node to mapping");
-                }
+                includeQueue(pPrefetch, fy_node_get_scalar0(value), depth);
+                continue;
             }
+            includeCollect(value, pPrefetch, depth);
         }
-        return new_map;
     }
+    else if (fy_node_is_sequence(node))
+    {
+        struct fy_node *entry;
 
-    return NULL;
+        while ((entry = fy_node_sequence_iterate(node, &iter)) != NULL)
+        {
+            includeCollect(entry, pPrefetch, depth);
+        }
+    }
 }
 
-static void merge_nodes(struct fy_node *mainNode, struct fy_node *includeNode)
+static void includeQueue(ut_kvp_prefetch_t *pPrefetch, const char *pszName, int depth)
 {
-
-    if (mainNode == NULL)
+    if ((pszName == NULL) || (depth >= pPrefetch->pContext->maxDepth))
     {
-        UT_LOG_ERROR("Main node is invalid");
         return;
     }
 
-    if (includeNode == NULL)
+    /* Already in memory, nothing to fetch */
+    if ((pPrefetch->pContext->pBundle != NULL) && (bundleFind(pPrefetch->pContext->pBundle, pszName) != NULL))
     {
-        UT_LOG_ERROR("Included node is invalid");
         return;
     }
 
-    if (fy_node_is_scalar(mainNode))
+    for (uint32_t i = 0; i < pPrefetch->count; i++)
     {
-        fy_node_create_scalar_copy(fy_node_document(mainNode), fy_node_get_scalar(includeNode, NULL), fy_node_get_scalar_length(includeNode));
+        if (strcmp(pPrefetch->pJobs[i].pszName, pszName) == 0)
+        {
+            return;
+        }
     }
-    else if (fy_node_is_mapping(mainNode) && fy_node_is_mapping(includeNode))
+
+    if (pPrefetch->count == pPrefetch->capacity)
     {
-        if (fy_node_insert(mainNode, includeNode) != 0)
+        uint32_t newCapacity = (pPrefetch->capacity == 0) ? 16 : pPrefetch->capacity * 2;
+        ut_kvp_prefetch_job_t *pNewJobs = realloc(pPrefetch->pJobs, newCapacity * sizeof(ut_kvp_prefetch_job_t));
+
+        if (pNewJobs == NULL)
         {
-            UT_LOG_ERROR("Node merge failed");
+            /* Left to the sequential expansion */
+            return;
         }
+        pPrefetch->pJobs = pNewJobs;
+        pPrefetch->capacity = newCapacity;
     }
-    else
+
+    pPrefetch->pJobs[pPrefetch->count].pszName = strdup(pszName);
+    if (pPrefetch->pJobs[pPrefetch->count].pszName == NULL)
     {
-        UT_LOG_ERROR("Warning: Cannot merge nodes of incompatible types\n");
+        return;
     }
+    pPrefetch->pJobs[pPrefetch->count].depth = depth;
+    pPrefetch->count++;
 }
 
-static struct fy_node* process_include(const char *filename, int depth, struct fy_document *doc)
+static bool includeBudgetLeft(ut_kvp_include_context_t *pContext, uint32_t *pRemainingMs)
 {
-    ut_kvp_download_memory_internal_t mChunk;
+    uint64_t now;
 
-    if (depth >= UT_KVP_MAX_INCLUDE_DEPTH)
+    if (pRemainingMs != NULL)
     {
-        UT_LOG_ERROR( "Error: Maximum include depth exceeded.\n");
-        return NULL;
+        *pRemainingMs = 0;
     }
 
-   if (strncmp(filename, "http:", 5) == 0 || strncmp(filename, "https:", 6) == 0) 
-   {
-        // URL include
-        mChunk.memory = malloc(1);
-        mChunk.size = 0;
+    if (pContext->expired)
+    {
+        return false;
+    }
 
-        if (!mChunk.memory)
-        {
-            UT_LOG_ERROR( "Error: Not enough memory to store curl response\n");
-            return NULL;
-        }
+    if (pContext->deadlineMs == 0)
+    {
+        return true;
+    }
 
-        CURL *curl = curl_easy_init();
-        if (!curl)
-        {
-            UT_LOG_ERROR( "Error: Could not initialize curl\n");
-            free(mChunk.memory);
-            return NULL;
-        }
+    now = monotonicMs();
+    if (now >= pContext->deadlineMs)
+    {
+        UT_LOG_ERROR("Error: Include time budget exhausted\n");
+        pContext->expired = true;
+        return false;
+    }
 
-        CURLcode res;
-        curl_easy_setopt(curl, CURLOPT_URL, filename);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_memory_callback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&mChunk);
-        res = curl_easy_perform(curl);
-        if (res != CURLE_OK)
-        {
-            UT_LOG_ERROR( "Error: curl_easy_perform() failed: %s\n", curl_easy_strerror(res));
-            free(mChunk.memory);
-            curl_easy_cleanup(curl);
-            return NULL;
-        }
+    if (pRemainingMs != NULL)
+    {
+        *pRemainingMs = (uint32_t)(pContext->deadlineMs - now);
+    }
+    return true;
+}
 
-        long response_code;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
-        if (response_code != 200)
-        {
-            UT_LOG_ERROR( "Error: HTTP request failed with code %ld\n", response_code);
-            free(mChunk.memory);
-            curl_easy_cleanup(curl);
-            return NULL;
-        }
+static uint64_t monotonicMs(void)
+{
+    struct timespec now;
 
-        struct fy_document *srcDoc = fy_document_build_from_malloc_string(NULL, mChunk.memory, mChunk.size);
-        if (srcDoc == NULL)
-        {
-            UT_LOG_ERROR("Error: Cannot parse included content\n");
-            free(mChunk.memory);
-            curl_easy_cleanup(curl);
-            return NULL;
-        }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000u) + ((uint64_t)now.tv_nsec / 1000000u);
+}
 
-        struct fy_node *root = process_node_copy(fy_document_root(srcDoc), doc, depth + 1);
+static void curlGlobalInit(void)
+{
+    curl_global_init(CURL_GLOBAL_DEFAULT);
 
-        // UT_LOG_DEBUG("%s memory chunk = \n%s\n", __FUNCTION__, mChunk.memory);
+    for (int i = 0; i < CURL_LOCK_DATA_LAST; i++)
+    {
+        pthread_mutex_init(&gCurlShareLocks[i], NULL);
+    }
 
-        // free(mChunk.memory); // fy_document_build_from_malloc_string():  The string is expected to have been allocated by malloc(3) and when the document is destroyed it will be automatically freed.
-        curl_easy_cleanup(curl);
-        fy_document_destroy(srcDoc);
-        return root;
+    // Kept for the life of the process. Connections are not shared, a connection cache shared between
+    // threads is not safe in libcurl, each pooled handle keeps its own instead
+    gpCurlShare = curl_share_init();
+    if (gpCurlShare == NULL)
+    {
+        UT_LOG_ERROR("Error: Could not initialize curl share, DNS and TLS sessions will not be shared\n");
+        return;
     }
-    else
+    curl_share_setopt(gpCurlShare, CURLSHOPT_LOCKFUNC, curlShareLock);
+    curl_share_setopt(gpCurlShare, CURLSHOPT_UNLOCKFUNC, curlShareUnlock);
+    curl_share_setopt(gpCurlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(gpCurlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+static CURL *curlAcquire(void)
+{
+    CURL *curl = NULL;
+
+    // The most recently used handle first, it is the likeliest to hold an open connection
+    pthread_mutex_lock(&gCurlPool.lock);
+    if (gCurlPool.count > 0)
     {
-        // Local file include
-        FILE *file = fopen(filename, "r");
-        if (!file)
-        {
-            UT_LOG_ERROR("Error: Cannot open include file '%s'.\n", filename);
-            return NULL;
-        }
+        curl = gCurlPool.pHandles[--gCurlPool.count];
+    }
+    pthread_mutex_unlock(&gCurlPool.lock);
 
-        // struct fy_document *doc;
-        struct fy_document *srcDoc = fy_document_build_from_file(NULL, filename);
-        if (srcDoc == NULL)
-        {
-            UT_LOG_ERROR("Error: Cannot parse include file '%s'.\n", filename);
-            fclose(file);
-            return NULL;
-        }
+    if (curl == NULL)
+    {
+        return curl_easy_init();
+    }
 
-        struct fy_node *root;
-        root = process_node_copy(fy_document_root(srcDoc), doc, depth + 1);
-        fclose(file);
-        fy_document_destroy(srcDoc);
-        return root;
+    /* Options go back to their defaults, the connections and caches of the handle are kept */
+    curl_easy_reset(curl);
+    return curl;
+}
+
+static void curlRelease(CURL *curl)
+{
+    // One handle per prefetch worker is kept, any beyond that are closed
+    pthread_mutex_lock(&gCurlPool.lock);
+    if (gCurlPool.count < UT_KVP_INCLUDE_WORKERS)
+    {
+        gCurlPool.pHandles[gCurlPool.count++] = curl;
+        curl = NULL;
+    }
+    pthread_mutex_unlock(&gCurlPool.lock);
+
+    if (curl != NULL)
+    {
+        curl_easy_cleanup(curl);
     }
 }
 
+static void curlShareLock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+    pthread_mutex_lock(&gCurlShareLocks[data]);
+}
+
+static void curlShareUnlock(CURL *handle, curl_lock_data data, void *userptr)
+{
+    pthread_mutex_unlock(&gCurlShareLocks[data]);
+}
+
 // This function is useful for searching for specific byte sequences in binary data or text files.
 static const void *find_pattern_from_buffer(const void *buffer, size_t bufferLength,
                                             const void *pattern, size_t patternLength)
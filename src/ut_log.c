@@ -70,7 +70,7 @@ void UT_log(const char *function, int line, const char * format, ...)
     FILE        *fp = NULL;
     va_list     list;
     time_t      now;
-    struct tm   *tmp;
+    struct tm   tmNow;
     char        singleLineBuffer[UT_LOG_MAX_LINE_SIZE+1]={0};
     size_t      lineSize;
 
@@ -90,8 +90,8 @@ void UT_log(const char *function, int line, const char * format, ...)
         return;
     }
 
-    tmp = localtime(&now);
-    strftime(time_now, sizeof(time_now), "%Y-%m-%d-%X", tmp);
+    localtime_r(&now, &tmNow);
+    strftime(time_now, sizeof(time_now), "%Y-%m-%d-%X", &tmNow);
 #if 0
     snprintf( singleLineBuffer, UT_LOG_MAX_LINE_SIZE, "\n%s, %s,%6d : ", time_now, function, line );
 #else
@@ -117,7 +117,7 @@ void UT_logPrefix(const char *file, int line, const char *prefix, const char * f
     FILE        *fp = NULL;
     va_list     list;
     time_t      now;
-    struct tm   *tmp;
+    struct tm   tmNow;
     char        singleLineBuffer[UT_LOG_MAX_LINE_SIZE+1]={0};
     size_t      lineSize;
 
@@ -137,8 +137,9 @@ void UT_logPrefix(const char *file, int line, const char *prefix, const char * f
         return;
     }
 
-    tmp = localtime(&now);
-    strftime(time_now, sizeof(time_now), "%Y-%m-%d-%X", tmp);
+    /* Reentrant, lines may be logged from several threads at once */
+    localtime_r(&now, &tmNow);
+    strftime(time_now, sizeof(time_now), "%Y-%m-%d-%X", &tmNow);
 #if 1
     snprintf( singleLineBuffer, UT_LOG_MAX_LINE_SIZE, "\n%s, %*s, %s,%6d : ", time_now, 16, prefix, basename((char *)file), line );
 #else
@@ -17,9 +17,44 @@
  * limitations under the License.
  */
 
+/* Standard Libraries */
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
 /* Module Includes */
 #include "ut_test_common.h"
 
+#define HTTP_SERVER_MAX_CONNECTIONS (64)
+
+struct test_ut_http_server_s
+{
+    int listenFd;
+    unsigned short port;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    unsigned int connections;
+    unsigned int requests;
+    unsigned int notModified;
+    unsigned int delayMs;
+    int clientFds[HTTP_SERVER_MAX_CONNECTIONS];
+    pthread_t clientThreads[HTTP_SERVER_MAX_CONNECTIONS];
+};
+
+// Struct to store what a connection thread needs
+typedef struct
+{
+    test_ut_http_server_t *pServer;
+    int fd;
+} http_client_t;
+
+static void *http_server_accept(void *pArg);
+static void *http_server_client(void *pArg);
+
 int read_file_into_memory(const char* filename, test_ut_memory_t* pInstance)
 {
     FILE *file = fopen(filename, "r");
@@ -106,4 +141,267 @@ void print_input_output(char* kvpData, const char* filename)
         // Print the emitted KVP string
         printf("\n%s\n", kvpData);
     }
-}
\ No newline at end of file
+}
+
+test_ut_http_server_t *http_server_start(void)
+{
+    test_ut_http_server_t *pServer = calloc(1, sizeof(test_ut_http_server_t));
+    struct sockaddr_in address;
+    socklen_t length = sizeof(address);
+    int reuse = 1;
+
+    if (pServer == NULL)
+    {
+        return NULL;
+    }
+
+    pServer->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (pServer->listenFd < 0)
+    {
+        UT_LOG_ERROR("socket");
+        free(pServer);
+        return NULL;
+    }
+    setsockopt(pServer->listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    if ((bind(pServer->listenFd, (struct sockaddr *)&address, sizeof(address)) != 0) ||
+        (listen(pServer->listenFd, 16) != 0) ||
+        (getsockname(pServer->listenFd, (struct sockaddr *)&address, &length) != 0))
+    {
+        UT_LOG_ERROR("bind/listen");
+        close(pServer->listenFd);
+        free(pServer);
+        return NULL;
+    }
+    pServer->port = ntohs(address.sin_port);
+
+    for (int i = 0; i < HTTP_SERVER_MAX_CONNECTIONS; i++)
+    {
+        pServer->clientFds[i] = -1;
+    }
+    pthread_mutex_init(&pServer->lock, NULL);
+
+    if (pthread_create(&pServer->thread, NULL, http_server_accept, pServer) != 0)
+    {
+        UT_LOG_ERROR("pthread_create");
+        pthread_mutex_destroy(&pServer->lock);
+        close(pServer->listenFd);
+        free(pServer);
+        return NULL;
+    }
+
+    return pServer;
+}
+
+unsigned short http_server_port(test_ut_http_server_t *pServer)
+{
+    return pServer->port;
+}
+
+unsigned int http_server_connections(test_ut_http_server_t *pServer)
+{
+    unsigned int count;
+
+    pthread_mutex_lock(&pServer->lock);
+    count = pServer->connections;
+    pthread_mutex_unlock(&pServer->lock);
+    return count;
+}
+
+unsigned int http_server_requests(test_ut_http_server_t *pServer)
+{
+    unsigned int count;
+
+    pthread_mutex_lock(&pServer->lock);
+    count = pServer->requests;
+    pthread_mutex_unlock(&pServer->lock);
+    return count;
+}
+
+unsigned int http_server_not_modified(test_ut_http_server_t *pServer)
+{
+    unsigned int count;
+
+    pthread_mutex_lock(&pServer->lock);
+    count = pServer->notModified;
+    pthread_mutex_unlock(&pServer->lock);
+    return count;
+}
+
+void http_server_set_delay(test_ut_http_server_t *pServer, unsigned int delayMs)
+{
+    pthread_mutex_lock(&pServer->lock);
+    pServer->delayMs = delayMs;
+    pthread_mutex_unlock(&pServer->lock);
+}
+
+void http_server_stop(test_ut_http_server_t *pServer)
+{
+    unsigned int count;
+
+    if (pServer == NULL)
+    {
+        return;
+    }
+
+    // Wakes the accept thread, then every connection thread blocked in recv()
+    shutdown(pServer->listenFd, SHUT_RDWR);
+    pthread_join(pServer->thread, NULL);
+
+    pthread_mutex_lock(&pServer->lock);
+    count = pServer->connections;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        shutdown(pServer->clientFds[i], SHUT_RDWR);
+    }
+    pthread_mutex_unlock(&pServer->lock);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        pthread_join(pServer->clientThreads[i], NULL);
+        close(pServer->clientFds[i]);
+    }
+
+    close(pServer->listenFd);
+    pthread_mutex_destroy(&pServer->lock);
+    free(pServer);
+}
+
+static void *http_server_accept(void *pArg)
+{
+    test_ut_http_server_t *pServer = pArg;
+
+    while (1)
+    {
+        http_client_t *pClient;
+        int fd = accept(pServer->listenFd, NULL, NULL);
+
+        if (fd < 0)
+        {
+            break;
+        }
+
+        pthread_mutex_lock(&pServer->lock);
+        if (pServer->connections == HTTP_SERVER_MAX_CONNECTIONS)
+        {
+            pthread_mutex_unlock(&pServer->lock);
+            close(fd);
+            continue;
+        }
+
+        pClient = malloc(sizeof(http_client_t));
+        if (pClient == NULL)
+        {
+            pthread_mutex_unlock(&pServer->lock);
+            close(fd);
+            continue;
+        }
+        pClient->pServer = pServer;
+        pClient->fd = fd;
+
+        pServer->clientFds[pServer->connections] = fd;
+        if (pthread_create(&pServer->clientThreads[pServer->connections], NULL, http_server_client, pClient) != 0)
+        {
+            pthread_mutex_unlock(&pServer->lock);
+            free(pClient);
+            close(fd);
+            continue;
+        }
+        pServer->connections++;
+        pthread_mutex_unlock(&pServer->lock);
+    }
+
+    return NULL;
+}
+
+static void *http_server_client(void *pArg)
+{
+    http_client_t *pClient = pArg;
+    test_ut_http_server_t *pServer = pClient->pServer;
+    int fd = pClient->fd;
+    char request[4096];
+    size_t used = 0;
+
+    free(pClient);
+
+    // Requests are answered in turn until the client closes the connection
+    while (1)
+    {
+        char *pEnd = NULL;
+        char name[256];
+        char etag[300];
+        char body[512];
+        char response[1024];
+        int length;
+        ssize_t received;
+        bool notModified;
+        unsigned int delayMs;
+
+        request[used] = '\0';
+        while ((pEnd = strstr(request, "\r\n\r\n")) == NULL)
+        {
+            if (used == sizeof(request) - 1)
+            {
+                return NULL;
+            }
+            received = recv(fd, &request[used], sizeof(request) - 1 - used, 0);
+            if (received <= 0)
+            {
+                return NULL;
+            }
+            used += received;
+            request[used] = '\0';
+        }
+
+        notModified = false;
+        if ((sscanf(request, "GET /%255[^. ].yaml HTTP/1.1", name) == 1))
+        {
+            // The document never changes, so its name serves as its ETag
+            snprintf(etag, sizeof(etag), "If-None-Match: \"%s\"\r\n", name);
+            if (strstr(request, etag) != NULL)
+            {
+                notModified = true;
+                length = snprintf(response, sizeof(response), "HTTP/1.1 304 Not Modified\r\nETag: \"%s\"\r\n\r\n", name);
+            }
+            else
+            {
+                snprintf(body, sizeof(body), "%s:\n  value: true\n", name);
+                length = snprintf(response, sizeof(response), "HTTP/1.1 200 OK\r\nContent-Type: text/yaml\r\nETag: \"%s\"\r\nContent-Length: %zu\r\n\r\n%s", name, strlen(body), body);
+            }
+        }
+        else
+        {
+            length = snprintf(response, sizeof(response), "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+        }
+
+        pthread_mutex_lock(&pServer->lock);
+        pServer->requests++;
+        if (notModified)
+        {
+            pServer->notModified++;
+        }
+        delayMs = pServer->delayMs;
+        pthread_mutex_unlock(&pServer->lock);
+
+        if (delayMs > 0)
+        {
+            usleep(delayMs * 1000);
+        }
+
+        if (send(fd, response, length, MSG_NOSIGNAL) != length)
+        {
+            return NULL;
+        }
+
+        // Keep anything pipelined after this request
+        pEnd += 4;
+        used -= (pEnd - request);
+        memmove(request, pEnd, used);
+    }
+
+    return NULL;
+}
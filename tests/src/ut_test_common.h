@@ -50,6 +50,50 @@ typedef struct
  */
 int read_file_into_memory(const char* filename, test_ut_memory_t* pInstance);
 
+/**! Handle to a local HTTP stand-in server, see `http_server_start()`. */
+typedef struct test_ut_http_server_s test_ut_http_server_t;
+
+/**
+ * @brief Starts a keep-alive HTTP/1.1 server on a free loopback port.
+ *
+ * A request for `/<name>.yaml` is answered with the document `<name>: { value: true }` and the
+ * ETag `"<name>"`, or with 304 when it carries that ETag in If-None-Match. Anything else is answered
+ * with 404. Each connection is served on its own thread until the client closes it.
+ *
+ * @return test_ut_http_server_t* Handle to the server, or NULL on failure.
+ */
+test_ut_http_server_t *http_server_start(void);
+
+/**
+ * @brief Gets the port a server is listening on.
+ */
+unsigned short http_server_port(test_ut_http_server_t *pServer);
+
+/**
+ * @brief Gets the number of connections a server has accepted.
+ */
+unsigned int http_server_connections(test_ut_http_server_t *pServer);
+
+/**
+ * @brief Gets the number of requests a server has answered.
+ */
+unsigned int http_server_requests(test_ut_http_server_t *pServer);
+
+/**
+ * @brief Gets the number of requests a server has answered with 304 Not Modified.
+ */
+unsigned int http_server_not_modified(test_ut_http_server_t *pServer);
+
+/**
+ * @brief Makes a server wait before sending each response, to stand in for a slow or hung one.
+ */
+void http_server_set_delay(test_ut_http_server_t *pServer, unsigned int delayMs);
+
+/**
+ * @brief Stops a server and frees it, connections still open are closed.
+ */
+void http_server_stop(test_ut_http_server_t *pServer);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
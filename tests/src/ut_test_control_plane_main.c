@@ -21,11 +21,17 @@
 
 extern void register_cp_function(void);
 extern void register_kvp_functions(void);
+#ifdef UT_KVP_PERF
+extern void register_kvp_perf_functions(void);
+#endif
 
 int main(int argc, char** argv)
 {
   UT_init(argc, argv);
   register_cp_function();
   register_kvp_functions();
+#ifdef UT_KVP_PERF
+  register_kvp_perf_functions();
+#endif
   UT_run_tests();
 }
\ No newline at end of file
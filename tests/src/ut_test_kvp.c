@@ -22,6 +22,10 @@
 #include <string.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <time.h>
 
 /* Module Includes */
 #include <ut.h>
@@ -42,6 +46,11 @@
 #define KVP_VALID_TEST_SEQUENCE_INCLUDE_YAML "assets/include/sequence-include.yaml"
 #define KVP_VALID_TEST_RESOLVE_YAML_TAGS_YAML "assets/yaml_tags.yaml"
 #define KVP_VALID_TEST_RESOLVE_YAML_TAGS_IN_SEQUENCE_YAML "assets/yaml_tags_in_sequence.yaml"
+#define KVP_VALID_TEST_INCLUDE_BUNDLE "assets/yaml_tags_bundle.tar"
+#define KVP_TEST_IMAGE_TEMPLATE "/tmp/ut_kvp_image_XXXXXX"
+#define KVP_TEST_INCLUDE_TEMPLATE "/tmp/ut_kvp_include_XXXXXX"
+#define KVP_TEST_URL_CACHE_TEMPLATE "/tmp/ut_kvp_urls_XXXXXX"
+#define KVP_TEST_WATCH_TEMPLATE "/tmp/ut_kvp_watch_XXXXXX"
 
 static ut_kvp_instance_t *gpMainTestInstance = NULL;
 static UT_test_suite_t *gpKVPSuite = NULL;
@@ -56,13 +65,17 @@ static UT_test_suite_t *gpKVPSuite9 = NULL;
 static UT_test_suite_t *gpKVPSuite10 = NULL;
 static UT_test_suite_t *gpKVPSuite11 = NULL;
 static UT_test_suite_t *gpKVPSuite12 = NULL;
+static UT_test_suite_t *gpKVPSuite13 = NULL;
 
 static int test_ut_kvp_createGlobalYAMLInstance(void);
 static int test_ut_kvp_createGlobalJSONInstance(void);
+static int test_ut_kvp_createGlobalYAMLIndexedInstance(void);
 static int test_ut_kvp_createGlobalYAMLInstanceForMallocedData(void);
 static int test_ut_kvp_createGlobalJSONInstanceForMallocedData(void);
 static int test_ut_kvp_createGlobalKVPInstanceForMallocedData(void);
 static int test_ut_kvp_freeGlobalInstance(void);
+static ut_kvp_status_t test_ut_kvp_openString( ut_kvp_instance_t *pInstance, const char *pszProfile );
+static bool test_ut_kvp_isMapped( const char *pszFile );
 
 static test_ut_memory_t gKVPData;
 
@@ -90,12 +103,20 @@ void test_ut_kvp_open( void )
 {
     ut_kvp_instance_t *pInstance = NULL;
     ut_kvp_status_t status;
+    uint64_t notInstance[64] = { 0 };
+    char zProfile[] = "check: 1\n";
 
     /* Negative Test */
     UT_LOG_STEP("ut_kvp_open( NULL, NULL )");
     status = ut_kvp_open( NULL, NULL);
     UT_ASSERT( status == UT_KVP_STATUS_INVALID_INSTANCE );
 
+    UT_LOG_STEP("ut_kvp_open( not an instance ) - Negative");
+    status = ut_kvp_open( (ut_kvp_instance_t *)notInstance, KVP_VALID_TEST_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_INVALID_INSTANCE );
+    status = ut_kvp_openMemory( (ut_kvp_instance_t *)notInstance, zProfile, sizeof(zProfile) - 1 );
+    UT_ASSERT( status == UT_KVP_STATUS_INVALID_INSTANCE );
+
     /* Positive Test */
     UT_LOG_STEP("ut_kvp_createInstance");
     pInstance = ut_kvp_createInstance();
@@ -411,6 +432,329 @@ void test_ut_kvp_string(void)
 
 }
 
+void test_ut_kvp_stringView(void)
+{
+    const char *checkField = "the beef is dead";
+    const char *pString = NULL;
+    size_t length = 0;
+    ut_kvp_status_t status;
+
+    UT_LOG_STEP("ut_kvp_getStringView() - Check for INVALID_PARAM");
+    status = ut_kvp_getStringView(NULL, "decodeTest/checkStringDeadBeef", &pString, &length);
+    UT_ASSERT(status == UT_KVP_STATUS_INVALID_INSTANCE );
+
+    status = ut_kvp_getStringView(gpMainTestInstance, NULL, &pString, &length);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM );
+
+    status = ut_kvp_getStringView(gpMainTestInstance, "decodeTest/checkStringDeadBeef", NULL, &length);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM );
+
+    status = ut_kvp_getStringView(gpMainTestInstance, "decodeTest/checkStringDeadBeef", &pString, NULL);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM );
+
+    UT_LOG_STEP("ut_kvp_getStringView() - Check for UT_KVP_STATUS_KEY_NOT_FOUND");
+    status = ut_kvp_getStringView(gpMainTestInstance, "shouldNotWork/checkStringDeadBeef", &pString, &length);
+    UT_ASSERT(status == UT_KVP_STATUS_KEY_NOT_FOUND );
+    UT_ASSERT(pString == NULL );
+    UT_ASSERT(length == 0 );
+
+    UT_LOG_STEP("ut_kvp_getStringView() - Check for UT_KVP_STATUS_PARSING_ERROR");
+    status = ut_kvp_getStringView(gpMainTestInstance, "decodeTest", &pString, &length);
+    UT_ASSERT(status == UT_KVP_STATUS_PARSING_ERROR );
+
+    UT_LOG_STEP("ut_kvp_getStringView() - Check for UT_KVP_STATUS_SUCCESS");
+    status = ut_kvp_getStringView(gpMainTestInstance, "decodeTest/checkStringDeadBeefNoQuotes", &pString, &length);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(length == strlen(checkField) );
+    UT_ASSERT(strncmp(pString, checkField, length) == 0 );
+
+    status = ut_kvp_getStringView(gpMainTestInstance, "decodeTest.checkStringDeadBeef2", &pString, &length);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(length == strlen("the beef is also dead") );
+    UT_ASSERT(strncmp(pString, "the beef is also dead", length) == 0 );
+}
+
+void test_ut_kvp_getFields(void)
+{
+    uint8_t u8Value = 0;
+    uint16_t u16Value = 0;
+    uint32_t u32Value = 0;
+    uint64_t u64Value = 0;
+    bool bValue = false;
+    double dValue = 0;
+    uint32_t listValue = 0;
+    uint32_t missingValue = 0x1234;
+    char zString[UT_KVP_MAX_ELEMENT_SIZE];
+    char zShort[5];
+    ut_kvp_status_t status;
+    ut_kvp_field_t fields[] =
+    {
+        { "decodeTest/checkUint8IsDeHex", UT_KVP_FIELD_TYPE_UINT8, &u8Value, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkUint16IsDeadDec", UT_KVP_FIELD_TYPE_UINT16, &u16Value, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest.checkUint32IsDeadBeefHex", UT_KVP_FIELD_TYPE_UINT32, &u32Value, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkUint64IsDeadBeefDec", UT_KVP_FIELD_TYPE_UINT64, &u64Value, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkBoolTRUE", UT_KVP_FIELD_TYPE_BOOL, &bValue, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkDoubleScientific", UT_KVP_FIELD_TYPE_DOUBLE, &dValue, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkStringDeadBeef", UT_KVP_FIELD_TYPE_STRING, zString, sizeof(zString), UT_KVP_STATUS_MAX },
+        { "decodeTest/checkStringDeadBeef", UT_KVP_FIELD_TYPE_STRING, zShort, sizeof(zShort), UT_KVP_STATUS_MAX },
+        { "decodeTest/checkUint32List/2", UT_KVP_FIELD_TYPE_UINT32, &listValue, 0, UT_KVP_STATUS_MAX },
+    };
+
+    UT_LOG_STEP("ut_kvp_getFields() - Check for invalid parameters");
+    status = ut_kvp_getFields(NULL, fields, sizeof(fields)/sizeof(fields[0]));
+    UT_ASSERT(status == UT_KVP_STATUS_INVALID_INSTANCE );
+
+    status = ut_kvp_getFields(gpMainTestInstance, NULL, 1);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM );
+
+    UT_LOG_STEP("ut_kvp_getFields() - Check for UT_KVP_STATUS_SUCCESS");
+    status = ut_kvp_getFields(gpMainTestInstance, fields, sizeof(fields)/sizeof(fields[0]));
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS );
+    for (size_t i = 0; i < sizeof(fields)/sizeof(fields[0]); i++)
+    {
+        UT_ASSERT(fields[i].status == UT_KVP_STATUS_SUCCESS );
+    }
+    UT_ASSERT(u8Value == 0xde );
+    UT_ASSERT(u16Value == 0xdead );
+    UT_ASSERT(u32Value == 0xdeadbeef );
+    UT_ASSERT(u64Value == 0xdeadbeefdeadbeef );
+    UT_ASSERT(bValue == true );
+    UT_ASSERT(dValue == -4.2e8 );
+    UT_ASSERT_STRING_EQUAL(zString, "the beef is dead" );
+    UT_ASSERT_STRING_EQUAL(zShort, "the " );
+    UT_ASSERT(listValue == 1080 );
+
+    UT_LOG_STEP("ut_kvp_getFields() - Check per field failures");
+    fields[1].pszKey = "decodeTest/shouldNotWork";
+    fields[1].pValue = &missingValue;
+    fields[2].pszKey = "decodeTest";
+    fields[3].type = UT_KVP_FIELD_TYPE_MAX;
+    status = ut_kvp_getFields(gpMainTestInstance, fields, sizeof(fields)/sizeof(fields[0]));
+    UT_ASSERT(status == UT_KVP_STATUS_KEY_NOT_FOUND );
+    UT_ASSERT(fields[0].status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(fields[1].status == UT_KVP_STATUS_KEY_NOT_FOUND );
+    UT_ASSERT(fields[2].status == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT(fields[3].status == UT_KVP_STATUS_INVALID_PARAM );
+    UT_ASSERT(fields[4].status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(missingValue == 0x1234 );
+
+    UT_LOG_STEP("ut_kvp_getFields() - Check values that fail to convert are left untouched");
+    fields[1].pszKey = "decodeTest/checkUint16IsDeadHex";
+    fields[1].type = UT_KVP_FIELD_TYPE_UINT8;
+    fields[1].pValue = &u8Value;
+    fields[2].pszKey = "decodeTest/checkDoubleInvalid";
+    fields[2].type = UT_KVP_FIELD_TYPE_DOUBLE;
+    fields[2].pValue = &dValue;
+    fields[3].type = UT_KVP_FIELD_TYPE_UINT64;
+    u8Value = 0x12;
+    dValue = 1.5;
+    status = ut_kvp_getFields(gpMainTestInstance, &fields[1], 3);
+    UT_ASSERT(status == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT(fields[1].status == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT(fields[2].status == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT(fields[3].status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(u8Value == 0x12 );
+    UT_ASSERT(dValue == 1.5 );
+    UT_ASSERT(u64Value == 0xdeadbeefdeadbeef );
+}
+
+void test_ut_kvp_iterator(void)
+{
+    const uint32_t checkList[] = { 720, 800, 1080 };
+    const char *checkStrings[] = { "stringA", "stringB", "stringC" };
+    ut_kvp_iterator_t *pIterator;
+    const char *pString;
+    const char *pName;
+    size_t length;
+    uint32_t count;
+
+    UT_LOG_STEP("ut_kvp_iteratorBegin() - Negative");
+    UT_ASSERT( ut_kvp_iteratorBegin(NULL, "decodeTest/checkUint32List") == NULL );
+    UT_ASSERT( ut_kvp_iteratorBegin(gpMainTestInstance, NULL) == NULL );
+    UT_ASSERT( ut_kvp_iteratorBegin(gpMainTestInstance, "decodeTest/shouldNotWork") == NULL );
+    UT_ASSERT( ut_kvp_iteratorBegin(gpMainTestInstance, "decodeTest/checkFloat") == NULL );
+    UT_ASSERT( ut_kvp_iteratorNext(NULL) == false );
+
+    UT_LOG_STEP("ut_kvp_iterator - uint32 sequence");
+    pIterator = ut_kvp_iteratorBegin(gpMainTestInstance, "decodeTest/checkUint32List");
+    UT_ASSERT( pIterator != NULL );
+    UT_ASSERT( ut_kvp_iteratorGetStringView(pIterator, &pString, &length) == UT_KVP_STATUS_NO_DATA );
+    count = 0;
+    while (ut_kvp_iteratorNext(pIterator) == true)
+    {
+        UT_ASSERT( ut_kvp_iteratorGetIndex(pIterator) == count );
+        UT_ASSERT( ut_kvp_iteratorGetName(pIterator, &length) == NULL );
+        UT_ASSERT( count < 3 );
+        if ( count < 3 )
+        {
+            UT_ASSERT( ut_kvp_iteratorGetUInt32(pIterator) == checkList[count] );
+        }
+        count++;
+    }
+    UT_ASSERT( count == 3 );
+    UT_ASSERT( ut_kvp_iteratorNext(pIterator) == false );
+    ut_kvp_iteratorEnd(pIterator);
+
+    UT_LOG_STEP("ut_kvp_iterator - string sequence");
+    pIterator = ut_kvp_iteratorBegin(gpMainTestInstance, "decodeTest.checkStringList");
+    UT_ASSERT( pIterator != NULL );
+    count = 0;
+    while ((ut_kvp_iteratorNext(pIterator) == true) && (count < 3))
+    {
+        UT_ASSERT( ut_kvp_iteratorGetStringView(pIterator, &pString, &length) == UT_KVP_STATUS_SUCCESS );
+        UT_ASSERT( length == strlen(checkStrings[count]) );
+        UT_ASSERT( strncmp(pString, checkStrings[count], length) == 0 );
+        count++;
+    }
+    UT_ASSERT( count == 3 );
+    ut_kvp_iteratorEnd(pIterator);
+
+    UT_LOG_STEP("ut_kvp_iterator - mapping");
+    pIterator = ut_kvp_iteratorBegin(gpMainTestInstance, "decodeTest");
+    UT_ASSERT( pIterator != NULL );
+    count = 0;
+    while (ut_kvp_iteratorNext(pIterator) == true)
+    {
+        char zKey[UT_KVP_MAX_ELEMENT_SIZE];
+
+        pName = ut_kvp_iteratorGetName(pIterator, &length);
+        UT_ASSERT( pName != NULL );
+        if ((pName != NULL) && (length + sizeof("decodeTest/") < sizeof(zKey)))
+        {
+            snprintf(zKey, sizeof(zKey), "decodeTest/%.*s", (int)length, pName);
+            UT_ASSERT( ut_kvp_fieldPresent(gpMainTestInstance, zKey) == true );
+            if (strcmp(zKey, "decodeTest/checkUint16IsDeadHex") == 0)
+            {
+                UT_ASSERT( ut_kvp_iteratorGetUInt16(pIterator) == 0xdead );
+            }
+            if (strcmp(zKey, "decodeTest/checkBoolTRUE") == 0)
+            {
+                UT_ASSERT( ut_kvp_iteratorGetBool(pIterator) == true );
+            }
+            if (strcmp(zKey, "decodeTest/checkStringList") == 0)
+            {
+                UT_ASSERT( ut_kvp_iteratorGetStringView(pIterator, &pString, &length) == UT_KVP_STATUS_PARSING_ERROR );
+            }
+        }
+        count++;
+    }
+    UT_ASSERT( count > 3 );
+    ut_kvp_iteratorEnd(pIterator);
+}
+
+void test_ut_kvp_iterator_reopen( void )
+{
+    ut_kvp_instance_t *pInstance;
+    ut_kvp_iterator_t *pIterator;
+    ut_kvp_status_t status;
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+
+    pIterator = ut_kvp_iteratorBegin( pInstance, "decodeTest/checkUint32List" );
+    UT_ASSERT( pIterator != NULL );
+    UT_ASSERT( ut_kvp_iteratorNext( pIterator ) == true );
+    UT_ASSERT( ut_kvp_iteratorGetUInt32( pIterator ) == 720 );
+
+    /* Re-opening invalidates the iterator, it must not touch the old document */
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_iteratorGetUInt32( pIterator ) == 0 );
+    UT_ASSERT( ut_kvp_iteratorNext( pIterator ) == false );
+    ut_kvp_iteratorEnd( pIterator );
+
+    ut_kvp_destroyInstance( pInstance );
+}
+
+void test_ut_kvp_arrays(void)
+{
+    uint32_t u32Values[3];
+    uint32_t u32Short[2];
+    uint64_t u64Values[3];
+    double dValues[2];
+    const char *pStrings[3];
+    size_t lengths[3];
+    uint32_t count;
+    ut_kvp_status_t status;
+
+    UT_LOG_STEP("ut_kvp_getUInt32Array() - Negative");
+    status = ut_kvp_getUInt32Array(NULL, "decodeTest/checkUint32List", u32Values, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_INVALID_INSTANCE );
+    status = ut_kvp_getUInt32Array(gpMainTestInstance, "decodeTest/checkUint32List", NULL, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM );
+    status = ut_kvp_getUInt32Array(gpMainTestInstance, "decodeTest/checkUint32List", u32Values, 3, NULL);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM );
+    status = ut_kvp_getUInt32Array(gpMainTestInstance, "decodeTest/shouldNotWork", u32Values, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_KEY_NOT_FOUND );
+    status = ut_kvp_getUInt32Array(gpMainTestInstance, "decodeTest/checkFloat", u32Values, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_PARSING_ERROR );
+
+    UT_LOG_STEP("ut_kvp_getUInt32Array() - Count query");
+    status = ut_kvp_getUInt32Array(gpMainTestInstance, "decodeTest/checkUint32List", NULL, 0, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(count == 3 );
+
+    UT_LOG_STEP("ut_kvp_getUInt32Array() - Positive");
+    status = ut_kvp_getUInt32Array(gpMainTestInstance, "decodeTest.checkUint32List", u32Values, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(count == 3 );
+    UT_ASSERT(u32Values[0] == 720 );
+    UT_ASSERT(u32Values[1] == 800 );
+    UT_ASSERT(u32Values[2] == 1080 );
+
+    UT_LOG_STEP("ut_kvp_getUInt32Array() - Buffer too small");
+    status = ut_kvp_getUInt32Array(gpMainTestInstance, "decodeTest/checkUint32List", u32Short, 2, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_INVALID_PARAM );
+    UT_ASSERT(count == 3 );
+    UT_ASSERT(u32Short[0] == 720 );
+    UT_ASSERT(u32Short[1] == 800 );
+
+    UT_LOG_STEP("ut_kvp_getUInt64Array() - Positive");
+    status = ut_kvp_getUInt64Array(gpMainTestInstance, "decodeTest/checkUint64List", u64Values, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(count == 3 );
+    UT_ASSERT(u64Values[0] == 0xdeadbeefdeadbeef );
+    UT_ASSERT(u64Values[1] == 0xdeadbeefdeadbeef );
+    UT_ASSERT(u64Values[2] == 0 );
+
+    UT_LOG_STEP("ut_kvp_getDoubleArray() - Positive");
+    status = ut_kvp_getDoubleArray(gpMainTestInstance, "decodeTest/checkDoubleList", dValues, 2, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(count == 2 );
+    UT_ASSERT(dValues[0] == 5.1 );
+    UT_ASSERT(dValues[1] == -4.2e8 );
+
+    UT_LOG_STEP("ut_kvp_getUInt32Array() - Elements out of range");
+    u32Values[0] = 1;
+    u32Values[1] = 1;
+    status = ut_kvp_getUInt32Array(gpMainTestInstance, "decodeTest/checkUint64List", u32Values, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT(count == 3 );
+    UT_ASSERT(u32Values[0] == 0 );
+    UT_ASSERT(u32Values[1] == 0 );
+    UT_ASSERT(u32Values[2] == 0 );
+
+    UT_LOG_STEP("ut_kvp_getDoubleArray() - Elements that are not numbers");
+    dValues[0] = 1.5;
+    status = ut_kvp_getDoubleArray(gpMainTestInstance, "decodeTest/checkStringList", dValues, 2, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT(count == 3 );
+    UT_ASSERT(dValues[0] == 0 );
+
+    UT_LOG_STEP("ut_kvp_getStringArray() - Positive");
+    status = ut_kvp_getStringArray(gpMainTestInstance, "decodeTest/checkStringList", pStrings, NULL, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM );
+    status = ut_kvp_getStringArray(gpMainTestInstance, "decodeTest/checkStringList", pStrings, lengths, 3, &count);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT(count == 3 );
+    UT_ASSERT((lengths[0] == 7) && (strncmp(pStrings[0], "stringA", 7) == 0) );
+    UT_ASSERT((lengths[1] == 7) && (strncmp(pStrings[1], "stringB", 7) == 0) );
+    UT_ASSERT((lengths[2] == 7) && (strncmp(pStrings[2], "stringC", 7) == 0) );
+}
+
 void test_ut_kvp_dataByte( void )
 {
     int bytes_count = 0;
@@ -428,208 +772,1853 @@ void test_ut_kvp_dataByte( void )
     UT_ASSERT(output_bytes == NULL );
     UT_ASSERT(bytes_count == 0);
 
-    UT_LOG_STEP("ut_kvp_getDataBytes() - Check for NULL_PARAM - Third Argument");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesSpace", NULL);
-    UT_ASSERT(output_bytes == NULL );
-    UT_ASSERT(bytes_count == 0);
+    UT_LOG_STEP("ut_kvp_getDataBytes() - Check for NULL_PARAM - Third Argument");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesSpace", NULL);
+    UT_ASSERT(output_bytes == NULL );
+    UT_ASSERT(bytes_count == 0);
+
+    /* Check for KEY_NOT_FOUND */
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for output_bytes = NULL and bytes_count = 0, when key is not found");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "shouldNotWork/checkStringDeadBeef", &bytes_count);
+    UT_ASSERT(output_bytes == NULL );
+    UT_ASSERT(bytes_count == 0);
+
+    /* Positive tests */
+     if (read_file_into_memory(KVP_VALID_TEST_YAML_FILE, &kvpdata) == 0)
+    {
+        printf("\nYAML file is = \n%s\n", kvpdata.buffer);
+    }
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesSpace", &bytes_count);
+    UT_ASSERT(output_bytes != NULL);
+    UT_ASSERT(bytes_count != 0);
+    UT_LOG("Parsed %d bytes:\n", bytes_count);
+    for (int i = 0; i < bytes_count; i++)
+    {
+        printf("0x%02x ", output_bytes[i]);
+    }
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesComma", &bytes_count);
+    UT_ASSERT(output_bytes != NULL);
+    UT_ASSERT(bytes_count != 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    for (int i = 0; i < bytes_count; i++)
+    {
+        printf("0x%02x ", output_bytes[i]);
+    }
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for output_bytes = NULL and bytes_count = 0");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesIncorrect", &bytes_count);
+    UT_ASSERT(output_bytes == NULL);
+    UT_ASSERT(bytes_count == 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkByteCommaSpaces", &bytes_count);
+    UT_ASSERT(output_bytes != NULL);
+    UT_ASSERT(bytes_count != 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    for (int i = 0; i < bytes_count; i++)
+    {
+        printf("0x%02x ", output_bytes[i]);
+    }
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesDecimalSpace", &bytes_count);
+    UT_ASSERT(output_bytes != NULL);
+    UT_ASSERT(bytes_count != 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    for (int i = 0; i < bytes_count; i++)
+    {
+        printf("0x%02x ", output_bytes[i]);
+    }
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesDecimalComma", &bytes_count);
+    UT_ASSERT(output_bytes != NULL);
+    UT_ASSERT(bytes_count != 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    for (int i = 0; i < bytes_count; i++)
+    {
+        printf("0x%02x ", output_bytes[i]);
+    }
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesDecimalCommaSpace", &bytes_count);
+    UT_ASSERT(output_bytes != NULL);
+    UT_ASSERT(bytes_count != 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    for (int i = 0; i < bytes_count; i++)
+    {
+        printf("0x%02x ", output_bytes[i]);
+    }
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkByteSpaceSpaceCommaSpace", &bytes_count);
+    UT_ASSERT(output_bytes != NULL);
+    UT_ASSERT(bytes_count != 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    for (int i = 0; i < bytes_count; i++)
+    {
+        printf("0x%02x ", output_bytes[i]);
+    }
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for output_bytes = NULL and bytes_count = 0");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkByteInvalid", &bytes_count);
+    UT_ASSERT(output_bytes == NULL);
+    UT_ASSERT(bytes_count == 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    free(output_bytes);
+    output_bytes = NULL;
+
+    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
+    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytePrefix", &bytes_count);
+    UT_ASSERT(output_bytes != NULL);
+    UT_ASSERT(bytes_count != 0);
+    UT_LOG("Parsed %zu bytes:\n", bytes_count);
+    for (int i = 0; i < bytes_count; i++)
+    {
+        printf("0x%02x ", output_bytes[i]);
+    }
+    UT_LOG("\n");
+    free(output_bytes);
+    output_bytes = NULL;
+}
+
+void test_ut_kvp_getFloatField( void )
+{
+    float result;
+    float checkFloat = 5.1;
+
+    UT_LOG_STEP("ut_kvp_getFloatField() ");
+    result = ut_kvp_getFloatField(gpMainTestInstance, "decodeTest.checkFloat");
+    UT_ASSERT(result == checkFloat );
+
+    UT_LOG_STEP("ut_kvp_getFloatField() ");
+    result = ut_kvp_getFloatField(gpMainTestInstance, "decodeTest/checkFloat");
+    UT_ASSERT(result == checkFloat);
+}
+
+void test_ut_kvp_getDoubleField( void )
+{
+    double result;
+    double checkDoublePi = 3.14159265358979323846;
+    double checkDoubleScientific = -4.2e8;
+    double checkDoubleInvalid = 0;
+
+    UT_LOG_STEP("ut_kvp_getDoubleField() ");
+    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest.checkDoublePi");
+    UT_ASSERT(result == checkDoublePi );
+
+    UT_LOG_STEP("ut_kvp_getDoubleField() ");
+    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest/checkDoublePi");
+    UT_ASSERT(result == checkDoublePi);
+
+    UT_LOG_STEP("ut_kvp_getDoubleField() ");
+    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest.checkDoubleScientific");
+    UT_ASSERT(result == checkDoubleScientific );
+
+    UT_LOG_STEP("ut_kvp_getDoubleField() ");
+    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest/checkDoubleScientific");
+    UT_ASSERT(result == checkDoubleScientific);
+
+    UT_LOG_STEP("ut_kvp_getDoubleField() ");
+    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest.checkDoubleInvalid");
+    UT_ASSERT(result == checkDoubleInvalid );
+
+    UT_LOG_STEP("ut_kvp_getDoubleField() ");
+    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest/checkDoubleInvalid");
+    UT_ASSERT(result == checkDoubleInvalid);
+}
+
+void test_ut_kvp_longNumbers( void )
+{
+    ut_kvp_instance_t *pInstance;
+    double checkDoublePi = 3.14159265358979323846264338327950288419716939937510582097494459230781640628620899;
+    float checkFloatPi = 3.14159265358979323846264338327950288419716939937510582097494459230781640628620899f;
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+    if ( pInstance == NULL )
+    {
+        return;
+    }
+
+    UT_ASSERT( test_ut_kvp_openString( pInstance,
+        "pi: 3.14159265358979323846264338327950288419716939937510582097494459230781640628620899\n"
+        "bad: 3.14159265358979323846264338327950288419716939937510582097494459230781640628620899x\n" ) == UT_KVP_STATUS_SUCCESS );
+
+    UT_LOG_STEP("ut_kvp_getDoubleField() - Scalars longer than the number buffer still convert");
+    UT_ASSERT( ut_kvp_getDoubleField( pInstance, "pi" ) == checkDoublePi );
+
+    UT_LOG_STEP("ut_kvp_getFloatField() - Scalars longer than the number buffer still convert");
+    UT_ASSERT( ut_kvp_getFloatField( pInstance, "pi" ) == checkFloatPi );
+
+    UT_LOG_STEP("ut_kvp_getDoubleField() - Long scalars with trailing junk are still rejected");
+    UT_ASSERT( ut_kvp_getDoubleField( pInstance, "bad" ) == 0 );
+
+    ut_kvp_destroyInstance( pInstance );
+}
+
+void test_ut_kvp_fieldPresent()
+{
+    bool result;
+
+    /* Negative Tests */
+    result = ut_kvp_fieldPresent( gpMainTestInstance, "shouldNotWork/checkBoolTRUE" );
+    UT_ASSERT( result == false );
+
+    result = ut_kvp_fieldPresent( gpMainTestInstance, "shouldNotWork" );
+    UT_ASSERT( result == false );
+
+    /* Positive Tests */
+    result = ut_kvp_fieldPresent( gpMainTestInstance, "decodeTest/checkBoolTRUE" );
+    UT_ASSERT( result == true );
+
+    result = ut_kvp_fieldPresent( gpMainTestInstance, "decodeTest" );
+    UT_ASSERT( result == true );
+
+}
+
+void test_ut_kvp_keyHandle( void )
+{
+    ut_kvp_key_t *pKey;
+    ut_kvp_key_t *pStringKey;
+    ut_kvp_key_t *pMissingKey;
+    ut_kvp_instance_t *pOtherInstance;
+    char result_kvp[UT_KVP_MAX_ELEMENT_SIZE]={0xff};
+    ut_kvp_status_t status;
+
+    /* Negative Tests */
+    UT_LOG_STEP("ut_kvp_compileKey() - negative");
+    pKey = ut_kvp_compileKey( NULL, "decodeTest/checkUint32IsDeadBeefHex" );
+    UT_ASSERT( pKey == NULL );
+
+    pKey = ut_kvp_compileKey( gpMainTestInstance, NULL );
+    UT_ASSERT( pKey == NULL );
+
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( gpMainTestInstance, NULL ) == 0 );
+
+    /* Positive Tests */
+    UT_LOG_STEP("ut_kvp_compileKey() - positive");
+    pKey = ut_kvp_compileKey( gpMainTestInstance, "decodeTest.checkUint32IsDeadBeefHex" );
+    UT_ASSERT( pKey != NULL );
+
+    /* Repeat reads are served from the cached node */
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( gpMainTestInstance, pKey ) == 0xdeadbeef );
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( gpMainTestInstance, pKey ) == 0xdeadbeef );
+    UT_ASSERT( ut_kvp_getUInt16ByHandle( gpMainTestInstance, pKey ) == 0 );
+    UT_ASSERT( ut_kvp_getUInt64ByHandle( gpMainTestInstance, pKey ) == 0xdeadbeef );
+    ut_kvp_freeKey( pKey );
+
+    pKey = ut_kvp_compileKey( gpMainTestInstance, "decodeTest/checkBoolTRuE" );
+    UT_ASSERT( ut_kvp_getBoolByHandle( gpMainTestInstance, pKey ) == true );
+    ut_kvp_freeKey( pKey );
+
+    pKey = ut_kvp_compileKey( gpMainTestInstance, "decodeTest/checkDoublePi" );
+    UT_ASSERT( ut_kvp_getDoubleByHandle( gpMainTestInstance, pKey ) == ut_kvp_getDoubleField( gpMainTestInstance, "decodeTest/checkDoublePi" ) );
+    ut_kvp_freeKey( pKey );
+
+    pKey = ut_kvp_compileKey( gpMainTestInstance, "decodeTest/checkFloat" );
+    UT_ASSERT( ut_kvp_getFloatByHandle( gpMainTestInstance, pKey ) == ut_kvp_getFloatField( gpMainTestInstance, "decodeTest/checkFloat" ) );
+    ut_kvp_freeKey( pKey );
+
+    pStringKey = ut_kvp_compileKey( gpMainTestInstance, "decodeTest/checkStringList/1" );
+    status = ut_kvp_getStringByHandle( gpMainTestInstance, pStringKey, result_kvp, UT_KVP_MAX_ELEMENT_SIZE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( result_kvp, "stringB" );
+
+    pMissingKey = ut_kvp_compileKey( gpMainTestInstance, "shouldNotWork/checkStringDeadBeef" );
+    UT_ASSERT( pMissingKey != NULL );
+    status = ut_kvp_getStringByHandle( gpMainTestInstance, pMissingKey, result_kvp, UT_KVP_MAX_ELEMENT_SIZE );
+    UT_ASSERT( status == UT_KVP_STATUS_KEY_NOT_FOUND );
+    UT_ASSERT( ut_kvp_getUInt8ByHandle( gpMainTestInstance, pMissingKey ) == 0 );
+    ut_kvp_freeKey( pMissingKey );
+
+    /* A handle is bound to the instance it was compiled against */
+    pOtherInstance = ut_kvp_createInstance();
+    status = ut_kvp_getStringByHandle( pOtherInstance, pStringKey, result_kvp, UT_KVP_MAX_ELEMENT_SIZE );
+    UT_ASSERT( status == UT_KVP_STATUS_INVALID_PARAM );
+    ut_kvp_destroyInstance( pOtherInstance );
+
+    ut_kvp_freeKey( pStringKey );
+}
+
+void test_ut_kvp_keyHandle_reopen( void )
+{
+    ut_kvp_instance_t *pInstance;
+    ut_kvp_key_t *pKey;
+    ut_kvp_status_t status;
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    pKey = ut_kvp_compileKey( pInstance, "decodeTest/checkUint16IsDeadDec" );
+    UT_ASSERT( pKey != NULL );
+
+    /* Not opened, nothing to resolve */
+    UT_ASSERT( ut_kvp_getUInt16ByHandle( pInstance, pKey ) == 0 );
+
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt16ByHandle( pInstance, pKey ) == 0xdead );
+
+    /* Close invalidates the cached node */
+    ut_kvp_close( pInstance );
+    UT_ASSERT( ut_kvp_getUInt16ByHandle( pInstance, pKey ) == 0 );
+
+    /* Re-open resolves against the new document */
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_JSON_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt16ByHandle( pInstance, pKey ) == 0xdead );
+
+    ut_kvp_freeKey( pKey );
+    ut_kvp_destroyInstance( pInstance );
+}
+
+void test_ut_kvp_indexedPaths( void )
+{
+    ut_kvp_instance_t *pInstance;
+    ut_kvp_status_t status;
+    char result_kvp[UT_KVP_MAX_ELEMENT_SIZE]={0xff};
+
+    pInstance = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_INDEX );
+    UT_ASSERT( pInstance != NULL );
+
+    /* Nothing opened, no index to search */
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "decodeTest" ) == false );
+
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_YAML_CONFIG_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+
+    /* Nested sequences and mappings are reachable by full path */
+    status = ut_kvp_getStringField( pInstance, "components/2/ResourceList3/0/dummyCapabilities/1/capability", result_kvp, UT_KVP_MAX_ELEMENT_SIZE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( result_kvp, "DUMMY_CODEC_2" );
+
+    status = ut_kvp_getStringField( pInstance, "/components.0.name", result_kvp, UT_KVP_MAX_ELEMENT_SIZE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( result_kvp, "ComponentManager1" );
+
+    status = ut_kvp_getStringField( pInstance, "hal version", result_kvp, UT_KVP_MAX_ELEMENT_SIZE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( result_kvp, "X.X.X" );
+
+    UT_ASSERT( ut_kvp_getListCount( pInstance, "components/0/ResourceList1/1/dummyCapabilities" ) == 4 );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "components/3" ) == false );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "components/0/ResourceList1/1/id/0" ) == false );
+
+    /* Re-opening rebuilds the index against the new document */
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "decodeTest.checkUint32List.2" ) == 1080 );
+
+    ut_kvp_close( pInstance );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "decodeTest" ) == false );
+
+    /* Each open releases the previous document's index storage as a whole */
+    for ( int i = 0; i < 8; i++ )
+    {
+        status = ut_kvp_open( pInstance, (i & 1) ? KVP_VALID_TEST_YAML_FILE : KVP_VALID_TEST_YAML_CONFIG_FILE );
+        UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+        UT_ASSERT( ut_kvp_fieldPresent( pInstance, "decodeTest" ) == (bool)(i & 1) );
+        UT_ASSERT( ut_kvp_fieldPresent( pInstance, "components/0/name" ) == !(i & 1) );
+    }
+
+    ut_kvp_destroyInstance( pInstance );
+}
+
+void test_ut_kvp_dataBytesToBuffer( void )
+{
+    const unsigned char checkBytes[] = { 0xff, 0xed, 0x15, 0xee };
+    unsigned char buffer[64];
+    uint32_t size = 0;
+    ut_kvp_status_t status;
+
+    UT_LOG_STEP("ut_kvp_getDataBytesToBuffer() - Negative");
+    status = ut_kvp_getDataBytesToBuffer(NULL, "decodeTest/checkBytePrefix", buffer, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_INVALID_INSTANCE);
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, NULL, buffer, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM);
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkBytePrefix", NULL, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM);
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkBytePrefix", buffer, sizeof(buffer), NULL);
+    UT_ASSERT(status == UT_KVP_STATUS_NULL_PARAM);
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "shouldNotWork/checkBytePrefix", buffer, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_KEY_NOT_FOUND);
+    UT_ASSERT(size == 0);
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkByteInvalid", buffer, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_PARSING_ERROR);
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkBytesIncorrect", buffer, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_PARSING_ERROR);
+
+    UT_LOG_STEP("ut_kvp_getDataBytesToBuffer() - Size query");
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkBytePrefix", NULL, 0, &size);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS);
+    UT_ASSERT(size == sizeof(checkBytes));
+
+    UT_LOG_STEP("ut_kvp_getDataBytesToBuffer() - Buffer too small");
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkBytePrefix", buffer, 2, &size);
+    UT_ASSERT(status == UT_KVP_STATUS_INVALID_PARAM);
+    UT_ASSERT(size == sizeof(checkBytes));
+
+    UT_LOG_STEP("ut_kvp_getDataBytesToBuffer() - Positive");
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkBytePrefix", buffer, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS);
+    UT_ASSERT(size == sizeof(checkBytes));
+    UT_ASSERT(memcmp(buffer, checkBytes, sizeof(checkBytes)) == 0);
+
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkBytesDecimalCommaSpace", buffer, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS);
+    UT_ASSERT(size == 4);
+    UT_ASSERT((buffer[0] == 0) && (buffer[1] == 255) && (buffer[2] == 255) && (buffer[3] == 55));
+
+    status = ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkByteSpaceSpaceCommaSpace", buffer, sizeof(buffer), &size);
+    UT_ASSERT(status == UT_KVP_STATUS_SUCCESS);
+    UT_ASSERT(size == 3);
+    UT_ASSERT((buffer[0] == 0xff) && (buffer[1] == 0xdd) && (buffer[2] == 0xee));
+}
+
+static void *test_ut_kvp_dataBytesThread( void *pArg )
+{
+    unsigned char buffer[64];
+    uint32_t size;
+    intptr_t failures = 0;
+
+    (void)pArg;
+    for (int i = 0; i < 1000; i++)
+    {
+        if ((ut_kvp_getDataBytesToBuffer(gpMainTestInstance, "decodeTest/checkBytesComma", buffer, sizeof(buffer), &size) != UT_KVP_STATUS_SUCCESS) ||
+            (size != 48) || (buffer[1] != 0xff) || (buffer[47] != 0x01))
+        {
+            failures++;
+        }
+    }
+
+    return (void *)failures;
+}
+
+void test_ut_kvp_dataBytesThreads( void )
+{
+    pthread_t threads[4];
+    void *pResult;
+
+    UT_LOG_STEP("ut_kvp_getDataBytesToBuffer() - Concurrent readers");
+    for (int i = 0; i < 4; i++)
+    {
+        UT_ASSERT(pthread_create(&threads[i], NULL, test_ut_kvp_dataBytesThread, NULL) == 0);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        pthread_join(threads[i], &pResult);
+        UT_ASSERT(pResult == NULL);
+    }
+}
+
+void test_ut_kvp_openMapped( void )
+{
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_status_t status;
+    const char *pView;
+    size_t length;
+    char result[UT_KVP_MAX_ELEMENT_SIZE];
+
+    /* Negative Tests */
+    UT_LOG_STEP("ut_kvp_openMapped( NULL, NULL )");
+    status = ut_kvp_openMapped( NULL, NULL );
+    UT_ASSERT( status == UT_KVP_STATUS_INVALID_INSTANCE );
+
+    pInstance = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_INDEX );
+    UT_ASSERT( pInstance != NULL );
+
+    UT_LOG_STEP("ut_kvp_openMapped( pInstance, NULL ) - Negative");
+    status = ut_kvp_openMapped( pInstance, NULL );
+    UT_ASSERT( status == UT_KVP_STATUS_INVALID_PARAM );
+
+    UT_LOG_STEP("ut_kvp_openMapped( pInstance, %s - filename doesn't exist ) - Negative", KVP_VALID_TEST_NO_FILE);
+    status = ut_kvp_openMapped( pInstance, KVP_VALID_TEST_NO_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_FILE_OPEN_ERROR );
+
+    UT_LOG_STEP("ut_kvp_openMapped( pInstance, %s - zero length file ) - Negative", KVP_VALID_TEST_ZERO_LENGTH_YAML_FILE);
+    status = ut_kvp_openMapped( pInstance, KVP_VALID_TEST_ZERO_LENGTH_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_PARSING_ERROR );
+
+    /* Positive Tests */
+    UT_LOG_STEP("ut_kvp_openMapped( pInstance, %s ) - Positive", KVP_VALID_TEST_YAML_FILE);
+    status = ut_kvp_openMapped( pInstance, KVP_VALID_TEST_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "decodeTest/checkUint32IsDeadBeefHex" ) == 0xdeadbeef );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "decodeTest.checkBoolTRUE" ) == true );
+    status = ut_kvp_getStringField( pInstance, "decodeTest/checkStringDeadBeef", result, sizeof(result) );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( result, "the beef is dead" );
+
+    /* Reopening replaces the profile and releases the previous mapping */
+    UT_LOG_STEP("ut_kvp_openMapped( pInstance, %s ) - Reopen", KVP_VALID_TEST_JSON_FILE);
+    status = ut_kvp_openMapped( pInstance, KVP_VALID_TEST_JSON_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+
+    status = ut_kvp_getStringView( pInstance, "decodeTest/checkStringDeadBeef", &pView, &length );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( (length == strlen("the beef is dead")) && (strncmp(pView, "the beef is dead", length) == 0) );
+    UT_ASSERT( ut_kvp_getUInt64Field( pInstance, "decodeTest/checkUint64IsDeadBeefHex" ) == 0xdeadbeefdeadbeef );
+    UT_ASSERT( test_ut_kvp_isMapped( KVP_VALID_TEST_JSON_FILE ) == true );
+
+    /* A profile parsed from memory replaces the mapped one, its mapping goes with it */
+    UT_LOG_STEP("ut_kvp_openMemory() - Releases the mapped profile");
+    status = test_ut_kvp_openString( pInstance, "check: 1\n" );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( test_ut_kvp_isMapped( KVP_VALID_TEST_JSON_FILE ) == false );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "check" ) == 1 );
+
+    UT_LOG_STEP("ut_kvp_destroyInstance() - Unmaps the profile");
+    ut_kvp_destroyInstance( pInstance );
+}
+
+void test_ut_kvp_includeCache( void )
+{
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_include_cache_stats_t stats;
+    ut_kvp_status_t status;
+    char zFragment[] = KVP_TEST_INCLUDE_TEMPLATE;
+    char zMain[] = KVP_TEST_INCLUDE_TEMPLATE;
+    FILE *pFile;
+    int fd;
+
+    UT_ASSERT( ut_kvp_getIncludeCacheStats( NULL ) == UT_KVP_STATUS_NULL_PARAM );
+
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( ut_kvp_getIncludeCacheStats( &stats ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( (stats.hits == 0) && (stats.misses == 0) && (stats.entries == 0) );
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    /* Each file is parsed on first use only */
+    UT_LOG_STEP("ut_kvp_open( pInstance, %s ) - Cold", KVP_VALID_TEST_SINGLE_INCLUDE_FILE_YAML);
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_SINGLE_INCLUDE_FILE_YAML );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "21/value" ) == true );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.hits == 0) && (stats.misses == 20) && (stats.entries == 20) );
+
+    UT_LOG_STEP("ut_kvp_open( pInstance, %s ) - Warm", KVP_VALID_TEST_SINGLE_INCLUDE_FILE_YAML);
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_SINGLE_INCLUDE_FILE_YAML );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "2/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "21/value" ) == true );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.hits == 20) && (stats.misses == 20) && (stats.entries == 20) );
+
+    /* A file referenced twice is parsed once, and parsed again once it changes */
+    fd = mkstemp(zFragment);
+    UT_ASSERT( fd >= 0 );
+    close(fd);
+    fd = mkstemp(zMain);
+    UT_ASSERT( fd >= 0 );
+    close(fd);
+
+    pFile = fopen( zFragment, "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "value: 1\n" );
+    fclose( pFile );
+    pFile = fopen( zMain, "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "first: !include %s\nsecond: !include %s\n", zFragment, zFragment );
+    fclose( pFile );
+
+    ut_kvp_clearIncludeCache();
+    status = ut_kvp_open( pInstance, zMain );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "first/value" ) == 1 );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "second/value" ) == 1 );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.hits == 1) && (stats.misses == 1) && (stats.entries == 1) );
+
+    pFile = fopen( zFragment, "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "value: 200\n" );
+    fclose( pFile );
+
+    status = ut_kvp_open( pInstance, zMain );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "first/value" ) == 200 );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "second/value" ) == 200 );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.hits == 2) && (stats.misses == 2) && (stats.entries == 1) );
+
+    ut_kvp_clearIncludeCache();
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.hits == 0) && (stats.misses == 0) && (stats.entries == 0) );
+
+    /* Profiles already open keep their own copy */
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "second/value" ) == 200 );
+
+    ut_kvp_destroyInstance( pInstance );
+    unlink(zMain);
+    unlink(zFragment);
+}
+
+void test_ut_kvp_parallelIncludes( void )
+{
+    const char *profiles[] = { KVP_VALID_TEST_SINGLE_INCLUDE_FILE_YAML, KVP_VALID_TEST_DEPTH_CHECK_INCLUDE_YAML,
+                               KVP_VALID_TEST_SEQUENCE_INCLUDE_YAML, KVP_VALID_TEST_RESOLVE_YAML_TAGS_YAML,
+                               KVP_VALID_TEST_RESOLVE_YAML_TAGS_IN_SEQUENCE_YAML };
+    ut_kvp_instance_t *pSequential = NULL;
+    ut_kvp_instance_t *pParallel = NULL;
+    ut_kvp_include_cache_stats_t stats;
+    char *pExpected;
+    char *pResult;
+
+    pSequential = ut_kvp_createInstance();
+    UT_ASSERT( pSequential != NULL );
+    pParallel = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_PARALLEL_INCLUDES );
+    UT_ASSERT( pParallel != NULL );
+
+    /* Both start from a cold cache, and must end up with the same document */
+    for ( uint32_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++ )
+    {
+        UT_LOG_STEP("ut_kvp_open( pParallel, %s )", profiles[i]);
+        ut_kvp_clearIncludeCache();
+        UT_ASSERT( ut_kvp_open( pSequential, (char *)profiles[i] ) == UT_KVP_STATUS_SUCCESS );
+        ut_kvp_clearIncludeCache();
+        UT_ASSERT( ut_kvp_open( pParallel, (char *)profiles[i] ) == UT_KVP_STATUS_SUCCESS );
+
+        pExpected = ut_kvp_getData( pSequential );
+        pResult = ut_kvp_getData( pParallel );
+        UT_ASSERT( (pExpected != NULL) && (pResult != NULL) );
+        if ( (pExpected != NULL) && (pResult != NULL) )
+        {
+            UT_ASSERT_STRING_EQUAL( pResult, pExpected );
+        }
+        free( pExpected );
+        free( pResult );
+    }
+
+    /* Every include was parsed ahead by the workers, expansion only copied them */
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( ut_kvp_open( pParallel, KVP_VALID_TEST_SINGLE_INCLUDE_FILE_YAML ) == UT_KVP_STATUS_SUCCESS );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.misses == 20) && (stats.hits == 20) );
+    UT_ASSERT( ut_kvp_getBoolField( pParallel, "21/value" ) == true );
+
+    ut_kvp_destroyInstance( pSequential );
+    ut_kvp_destroyInstance( pParallel );
+}
+
+static ut_kvp_status_t test_ut_kvp_openString( ut_kvp_instance_t *pInstance, const char *pszProfile )
+{
+    /* The instance takes over the buffer it is given */
+    char *pProfile = strdup( pszProfile );
+
+    if ( pProfile == NULL )
+    {
+        return UT_KVP_STATUS_INVALID_PARAM;
+    }
+    return ut_kvp_openMemory( pInstance, pProfile, strlen( pProfile ) );
+}
+
+static bool test_ut_kvp_isMapped( const char *pszFile )
+{
+    char zPath[PATH_MAX];
+    char zLine[PATH_MAX + 128];
+    bool mapped = false;
+    FILE *pMaps;
+
+    if ( realpath( pszFile, zPath ) == NULL )
+    {
+        return false;
+    }
+
+    /* Every mapping of the process, a file mapping ends with its path */
+    pMaps = fopen( "/proc/self/maps", "r" );
+    if ( pMaps == NULL )
+    {
+        return false;
+    }
+    while ( ( mapped == false ) && ( fgets( zLine, sizeof(zLine), pMaps ) != NULL ) )
+    {
+        zLine[strcspn( zLine, "\n" )] = '\0';
+        mapped = ( strlen( zLine ) >= strlen( zPath ) ) && ( strcmp( &zLine[strlen( zLine ) - strlen( zPath )], zPath ) == 0 );
+    }
+    fclose( pMaps );
+
+    return mapped;
+}
+
+void test_ut_kvp_urlCache( void )
+{
+    test_ut_http_server_t *pServer;
+    ut_kvp_instance_t *pInstance = NULL;
+    char zDirectory[] = KVP_TEST_URL_CACHE_TEMPLATE;
+    char zProfile[256];
+    char zMissing[256];
+    char zFile[512];
+    struct dirent *pEntry;
+    DIR *pDir;
+
+    UT_ASSERT( ut_kvp_setUrlCacheDirectory( "assets/this_does_not_exist" ) == UT_KVP_STATUS_INVALID_PARAM );
+    UT_ASSERT( mkdtemp( zDirectory ) != NULL );
+    UT_ASSERT( ut_kvp_setUrlCacheDirectory( zDirectory ) == UT_KVP_STATUS_SUCCESS );
+
+    pServer = http_server_start();
+    UT_ASSERT( pServer != NULL );
+    if ( pServer == NULL )
+    {
+        return;
+    }
+    snprintf( zProfile, sizeof(zProfile), "a: !include http://127.0.0.1:%u/alpha.yaml\nb: !include http://127.0.0.1:%u/beta.yaml\n",
+              http_server_port( pServer ), http_server_port( pServer ) );
+    snprintf( zMissing, sizeof(zMissing), "c: !include http://127.0.0.1:%u/gamma.yaml\n", http_server_port( pServer ) );
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    UT_LOG_STEP("ut_kvp_openMemory() - Downloaded and stored");
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "a/alpha/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "b/beta/value" ) == true );
+    UT_ASSERT( http_server_requests( pServer ) == 2 );
+    UT_ASSERT( http_server_not_modified( pServer ) == 0 );
+
+    /* The parsed copies held in memory are asked about again by each open */
+    UT_LOG_STEP("ut_kvp_openMemory() - Revalidated");
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "a/alpha/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "b/beta/value" ) == true );
+    UT_ASSERT( http_server_requests( pServer ) == 4 );
+    UT_ASSERT( http_server_not_modified( pServer ) == 2 );
+
+    /* A new process has only the stored copies, they are revalidated the same way */
+    UT_LOG_STEP("ut_kvp_openMemory() - Revalidated from the directory");
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "a/alpha/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "b/beta/value" ) == true );
+    UT_ASSERT( http_server_requests( pServer ) == 6 );
+    UT_ASSERT( http_server_not_modified( pServer ) == 4 );
+
+    /* Without a directory the copies in memory are still revalidated rather than downloaded */
+    UT_LOG_STEP("ut_kvp_openMemory() - Revalidated without a directory");
+    UT_ASSERT( ut_kvp_setUrlCacheDirectory( NULL ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "a/alpha/value" ) == true );
+    UT_ASSERT( http_server_requests( pServer ) == 8 );
+    UT_ASSERT( http_server_not_modified( pServer ) == 6 );
+    UT_ASSERT( ut_kvp_setUrlCacheDirectory( zDirectory ) == UT_KVP_STATUS_SUCCESS );
+
+    /* Offline, the stored copies are used with the server gone */
+    http_server_stop( pServer );
+    ut_kvp_setUrlOffline( true );
+
+    UT_LOG_STEP("ut_kvp_openMemory() - Offline");
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "a/alpha/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "b/beta/value" ) == true );
+
+    UT_LOG_STEP("ut_kvp_openMemory() - Offline, never stored");
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zMissing ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "c/gamma/value" ) == false );
+
+    ut_kvp_destroyInstance( pInstance );
+    ut_kvp_setUrlOffline( false );
+    UT_ASSERT( ut_kvp_setUrlCacheDirectory( NULL ) == UT_KVP_STATUS_SUCCESS );
+    ut_kvp_clearIncludeCache();
+
+    pDir = opendir( zDirectory );
+    while ( (pDir != NULL) && ((pEntry = readdir( pDir )) != NULL) )
+    {
+        if ( pEntry->d_name[0] != '.' )
+        {
+            snprintf( zFile, sizeof(zFile), "%s/%s", zDirectory, pEntry->d_name );
+            unlink( zFile );
+        }
+    }
+    if ( pDir != NULL )
+    {
+        closedir( pDir );
+    }
+    UT_ASSERT( rmdir( zDirectory ) == 0 );
+}
+
+static uint64_t test_ut_kvp_nowMs( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ((uint64_t)now.tv_sec * 1000u) + ((uint64_t)now.tv_nsec / 1000000u);
+}
+
+void test_ut_kvp_includeTimeouts( void )
+{
+    test_ut_http_server_t *pServer;
+    ut_kvp_instance_t *pInstance = NULL;
+    char zProfile[512];
+    size_t used = 0;
+    uint64_t start;
+
+    UT_ASSERT( ut_kvp_setIncludeTimeouts( NULL, 0, 0, 0 ) == UT_KVP_STATUS_INVALID_INSTANCE );
+
+    pServer = http_server_start();
+    UT_ASSERT( pServer != NULL );
+    if ( pServer == NULL )
+    {
+        return;
+    }
+    for ( int i = 0; i < 6; i++ )
+    {
+        used += snprintf( &zProfile[used], sizeof(zProfile) - used, "s%d: !include http://127.0.0.1:%u/slow%d.yaml\n", i, http_server_port( pServer ), i );
+    }
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    /* Six 300ms includes can't fit a 500ms budget, the open fails once it is spent */
+    http_server_set_delay( pServer, 300 );
+    UT_LOG_STEP("ut_kvp_openMemory() - Budget exhausted");
+    UT_ASSERT( ut_kvp_setIncludeTimeouts( pInstance, 500, 0, 0 ) == UT_KVP_STATUS_SUCCESS );
+    ut_kvp_clearIncludeCache();
+    start = test_ut_kvp_nowMs();
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_TIMEOUT );
+    UT_ASSERT( test_ut_kvp_nowMs() - start < 1500 );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "s0" ) == false );
+
+    /* A transfer timeout fails each include on its own, the rest of the profile still opens */
+    UT_LOG_STEP("ut_kvp_openMemory() - Transfer timeout");
+    UT_ASSERT( ut_kvp_setIncludeTimeouts( pInstance, 0, 1000, 100 ) == UT_KVP_STATUS_SUCCESS );
+    ut_kvp_clearIncludeCache();
+    start = test_ut_kvp_nowMs();
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( test_ut_kvp_nowMs() - start < 1500 );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "s0/slow0/value" ) == false );
+
+    /* Within budget, everything is fetched */
+    UT_LOG_STEP("ut_kvp_openMemory() - Within budget");
+    http_server_set_delay( pServer, 0 );
+    UT_ASSERT( ut_kvp_setIncludeTimeouts( pInstance, 5000, 1000, 1000 ) == UT_KVP_STATUS_SUCCESS );
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "s5/slow5/value" ) == true );
+
+    ut_kvp_destroyInstance( pInstance );
+    ut_kvp_clearIncludeCache();
+    http_server_stop( pServer );
+}
+
+void test_ut_kvp_includeBundle( void )
+{
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_include_cache_stats_t stats;
+    ut_kvp_status_t status;
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    /* Negative Tests */
+    UT_ASSERT( ut_kvp_openBundle( NULL, KVP_VALID_TEST_INCLUDE_BUNDLE, NULL ) == UT_KVP_STATUS_INVALID_INSTANCE );
+    UT_ASSERT( ut_kvp_openBundle( pInstance, NULL, NULL ) == UT_KVP_STATUS_INVALID_PARAM );
+
+    UT_LOG_STEP("ut_kvp_openBundle( pInstance, %s - filename doesn't exist ) - Negative", KVP_VALID_TEST_NO_FILE);
+    status = ut_kvp_openBundle( pInstance, KVP_VALID_TEST_NO_FILE, NULL );
+    UT_ASSERT( status == UT_KVP_STATUS_FILE_OPEN_ERROR );
+
+    UT_LOG_STEP("ut_kvp_openBundle( pInstance, %s - not a bundle ) - Negative", KVP_VALID_TEST_YAML_FILE);
+    status = ut_kvp_openBundle( pInstance, KVP_VALID_TEST_YAML_FILE, NULL );
+    UT_ASSERT( status == UT_KVP_STATUS_PARSING_ERROR );
+
+    UT_LOG_STEP("ut_kvp_openBundle( pInstance, %s, missing member ) - Negative", KVP_VALID_TEST_INCLUDE_BUNDLE);
+    status = ut_kvp_openBundle( pInstance, KVP_VALID_TEST_INCLUDE_BUNDLE, KVP_VALID_TEST_NO_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_FILE_OPEN_ERROR );
+
+    /* The first member is the profile, every include resolves inside the bundle */
+    UT_LOG_STEP("ut_kvp_openBundle( pInstance, %s, NULL ) - Positive", KVP_VALID_TEST_INCLUDE_BUNDLE);
+    ut_kvp_clearIncludeCache();
+    status = ut_kvp_openBundle( pInstance, KVP_VALID_TEST_INCLUDE_BUNDLE, NULL );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "1/value" ) == true );
+    UT_ASSERT( ut_kvp_getListCount( pInstance, "plugin" ) == 2 );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "plugin/0/2/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "plugin/1/3/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "11/5/value" ) == true );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.hits == 0) && (stats.misses == 0) && (stats.entries == 0) );
+
+    /* Any member can be opened, "./" prefixes are ignored */
+    UT_LOG_STEP("ut_kvp_openBundle( pInstance, %s, ./%s ) - Positive", KVP_VALID_TEST_INCLUDE_BUNDLE, KVP_VALID_TEST_SINGLE_INCLUDE_FILE_YAML);
+    status = ut_kvp_openBundle( pInstance, KVP_VALID_TEST_INCLUDE_BUNDLE, "./" KVP_VALID_TEST_SINGLE_INCLUDE_FILE_YAML );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "plugin" ) == false );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "2/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "21/value" ) == true );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.hits == 0) && (stats.misses == 0) && (stats.entries == 0) );
+
+    ut_kvp_destroyInstance( pInstance );
+}
+
+void test_ut_kvp_sharedIncludes( void )
+{
+    static const char *pszProfile =
+        "first: !include assets/include/2s.yaml\n"
+        "second: !include assets/include/2s.yaml\n"
+        "list:\n"
+        "  - !include assets/include/2s.yaml\n"
+        "  - include: assets/include/3s.yaml\n"
+        "  - include: assets/include/3s.yaml\n"
+        "merged:\n"
+        "  include: assets/include/2d.yaml\n";
+    static const char *pszKeys[] = { "first/2/value", "second/2/value", "list/0/2/value", "list/1/3/value",
+                                     "list/2/3/value", "merged/2/value", "merged/3/value" };
+    ut_kvp_instance_t *pCopied = ut_kvp_createInstance();
+    ut_kvp_instance_t *pShared = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_SHARED_INCLUDES );
+    ut_kvp_instance_t *pIndexed = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_SHARED_INCLUDES | UT_KVP_FLAG_INDEX );
+    ut_kvp_include_cache_stats_t stats;
+    ut_kvp_iterator_t *pIterator;
+    char zFiles[3][sizeof(KVP_TEST_INCLUDE_TEMPLATE)];
+    char zProfile[3 * sizeof(KVP_TEST_INCLUDE_TEMPLATE) + 32];
+    char *pData;
+    uint32_t count = 0;
+    FILE *pFile;
+    int fd;
+
+    UT_ASSERT( (pCopied != NULL) && (pShared != NULL) && (pIndexed != NULL) );
+
+    UT_LOG_STEP("ut_kvp_openMemory() - Every site copied");
+    UT_ASSERT( test_ut_kvp_openString( pCopied, pszProfile ) == UT_KVP_STATUS_SUCCESS );
+
+    /* Repeated sites are aliases of the first, they aren't copied again from the include cache */
+    UT_LOG_STEP("ut_kvp_openMemory() - Repeated sites shared");
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( test_ut_kvp_openString( pShared, pszProfile ) == UT_KVP_STATUS_SUCCESS );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( stats.hits == 0 );
+    UT_ASSERT( test_ut_kvp_openString( pIndexed, pszProfile ) == UT_KVP_STATUS_SUCCESS );
+
+    pData = ut_kvp_getData( pShared );
+    UT_ASSERT( (pData != NULL) && (strstr( pData, "*ut_kvp_include_0" ) != NULL) );
+    free( pData );
+
+    // Every key reads the same through an alias, with or without the index
+    for ( uint32_t i = 0; i < sizeof(pszKeys) / sizeof(pszKeys[0]); i++ )
+    {
+        UT_ASSERT( ut_kvp_getBoolField( pCopied, pszKeys[i] ) == true );
+        UT_ASSERT( ut_kvp_getBoolField( pShared, pszKeys[i] ) == true );
+        UT_ASSERT( ut_kvp_getBoolField( pIndexed, pszKeys[i] ) == true );
+    }
+    UT_ASSERT( ut_kvp_getListCount( pShared, "list" ) == 3 );
+    UT_ASSERT( ut_kvp_fieldPresent( pShared, "second/2" ) == true );
+
+    pIterator = ut_kvp_iteratorBegin( pShared, "list" );
+    UT_ASSERT( pIterator != NULL );
+    while ( ut_kvp_iteratorNext( pIterator ) == true )
+    {
+        count++;
+    }
+    UT_ASSERT( count == 3 );
+    ut_kvp_iteratorEnd( pIterator );
+    pIterator = ut_kvp_iteratorBegin( pShared, "second/2" );
+    UT_ASSERT( pIterator != NULL );
+    UT_ASSERT( ut_kvp_iteratorNext( pIterator ) == true );
+    UT_ASSERT( ut_kvp_iteratorGetBool( pIterator ) == true );
+    ut_kvp_iteratorEnd( pIterator );
+
+    /* The fragment is first reached one include deeper, where the depth limit cuts its own include */
+    UT_LOG_STEP("ut_kvp_openMemory() - Same fragment at two depths");
+    for ( int i = 0; i < 3; i++ )
+    {
+        strcpy( zFiles[i], KVP_TEST_INCLUDE_TEMPLATE );
+        fd = mkstemp( zFiles[i] );
+        UT_ASSERT( fd >= 0 );
+        close( fd );
+    }
+    pFile = fopen( zFiles[0], "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "fragment: !include %s\n", zFiles[1] );
+    fclose( pFile );
+    pFile = fopen( zFiles[1], "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "value: 1\nnext: !include %s\n", zFiles[2] );
+    fclose( pFile );
+    pFile = fopen( zFiles[2], "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "value: 2\n" );
+    fclose( pFile );
+    snprintf( zProfile, sizeof(zProfile), "deep: !include %s\nshallow: !include %s\n", zFiles[0], zFiles[1] );
+
+    UT_ASSERT( ut_kvp_setIncludeDepth( pCopied, 3 ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_setIncludeDepth( pShared, 3 ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( test_ut_kvp_openString( pCopied, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( test_ut_kvp_openString( pShared, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_fieldPresent( pCopied, "deep/fragment/next" ) == false );
+    UT_ASSERT( ut_kvp_getUInt32Field( pCopied, "shallow/next/value" ) == 2 );
+    UT_ASSERT( ut_kvp_fieldPresent( pShared, "deep/fragment/next" ) == false );
+    UT_ASSERT( ut_kvp_getUInt32Field( pShared, "deep/fragment/value" ) == 1 );
+    UT_ASSERT( ut_kvp_getUInt32Field( pShared, "shallow/next/value" ) == 2 );
+    for ( int i = 0; i < 3; i++ )
+    {
+        UT_ASSERT( unlink( zFiles[i] ) == 0 );
+    }
+
+    ut_kvp_destroyInstance( pCopied );
+    ut_kvp_destroyInstance( pShared );
+    ut_kvp_destroyInstance( pIndexed );
+    ut_kvp_clearIncludeCache();
+}
+
+void test_ut_kvp_includeCycles( void )
+{
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_include_cache_stats_t stats;
+    char zChain[8][sizeof(KVP_TEST_INCLUDE_TEMPLATE)];
+    char zProfile[64];
+    FILE *pFile;
+    int fd;
+
+    UT_ASSERT( ut_kvp_setIncludeDepth( NULL, 5 ) == UT_KVP_STATUS_INVALID_INSTANCE );
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+    UT_ASSERT( ut_kvp_setIncludeDepth( pInstance, 0 ) == UT_KVP_STATUS_INVALID_PARAM );
+
+    // Each file includes the next, the last one includes the first again
+    for ( int i = 0; i < 8; i++ )
+    {
+        strcpy( zChain[i], KVP_TEST_INCLUDE_TEMPLATE );
+        fd = mkstemp( zChain[i] );
+        UT_ASSERT( fd >= 0 );
+        close( fd );
+    }
+    for ( int i = 0; i < 8; i++ )
+    {
+        pFile = fopen( zChain[i], "w" );
+        UT_ASSERT( pFile != NULL );
+        fprintf( pFile, "value: %d\nnext: !include %s\n", i, zChain[(i + 1) % 8] );
+        fclose( pFile );
+    }
+
+    /* The default depth stops a long chain before its end */
+    UT_LOG_STEP("ut_kvp_open( pInstance, %s ) - Default depth", zChain[0]);
+    UT_ASSERT( ut_kvp_open( pInstance, zChain[0] ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "next/next/next/next/value" ) == 4 );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "next/next/next/next/next/next/value" ) == false );
+
+    /* Deep enough for the whole chain, the cycle back to the profile is cut at its first repeat */
+    UT_LOG_STEP("ut_kvp_open( pInstance, %s ) - Cycle", zChain[0]);
+    UT_ASSERT( ut_kvp_setIncludeDepth( pInstance, 64 ) == UT_KVP_STATUS_SUCCESS );
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( ut_kvp_open( pInstance, zChain[0] ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "next/next/next/next/next/next/next/value" ) == 7 );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "next/next/next/next/next/next/next/next" ) == false );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( stats.misses == 7 );
+
+    /* A profile in memory has no path, the cycle is caught once it comes back round */
+    UT_LOG_STEP("ut_kvp_openMemory() - Cycle");
+    snprintf( zProfile, sizeof(zProfile), "start: !include %s\n", zChain[0] );
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "start/next/next/next/next/next/next/next/value" ) == 7 );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "start/next/next/next/next/next/next/next/next" ) == false );
+
+    ut_kvp_destroyInstance( pInstance );
+    ut_kvp_clearIncludeCache();
+    for ( int i = 0; i < 8; i++ )
+    {
+        unlink( zChain[i] );
+    }
+}
+
+void test_ut_kvp_includeOrder( void )
+{
+    static const char *pszOrder[] = { "first", "second", "middle", "fourth", "last" };
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_iterator_t *pIterator;
+    char zFirst[] = KVP_TEST_INCLUDE_TEMPLATE;
+    char zSecond[] = KVP_TEST_INCLUDE_TEMPLATE;
+    char zProfile[256];
+    const char *pName;
+    size_t length;
+    uint32_t count = 0;
+    FILE *pFile;
+    int fd;
+
+    fd = mkstemp( zFirst );
+    UT_ASSERT( fd >= 0 );
+    close( fd );
+    fd = mkstemp( zSecond );
+    UT_ASSERT( fd >= 0 );
+    close( fd );
+
+    pFile = fopen( zFirst, "w" );
+    UT_ASSERT( pFile != NULL );
+    fputs( "second: 2\nfirst: 10\n", pFile );
+    fclose( pFile );
+    pFile = fopen( zSecond, "w" );
+    UT_ASSERT( pFile != NULL );
+    fputs( "fourth: 4\n", pFile );
+    fclose( pFile );
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+    if ( pInstance == NULL )
+    {
+        return;
+    }
+
+    /* Included keys take the place of the include key, keys the profile already has are overridden */
+    UT_LOG_STEP("ut_kvp_openMemory() - Includes merge at their key");
+    snprintf( zProfile, sizeof(zProfile), "order:\n  first: 1\n  include_0: %s\n  middle: 3\n  include_1: %s\n  last: 5\n", zFirst, zSecond );
+    UT_ASSERT( test_ut_kvp_openString( pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "order/first" ) == 10 );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "order/include_0" ) == false );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "order/include_1" ) == false );
+
+    pIterator = ut_kvp_iteratorBegin( pInstance, "order" );
+    UT_ASSERT( pIterator != NULL );
+    while ( ( pIterator != NULL ) && ( ut_kvp_iteratorNext( pIterator ) == true ) )
+    {
+        pName = ut_kvp_iteratorGetName( pIterator, &length );
+        UT_ASSERT( count < sizeof(pszOrder) / sizeof(pszOrder[0]) );
+        if ( count < sizeof(pszOrder) / sizeof(pszOrder[0]) )
+        {
+            UT_ASSERT( (pName != NULL) && (length == strlen(pszOrder[count])) && (strncmp(pName, pszOrder[count], length) == 0) );
+        }
+        count++;
+    }
+    UT_ASSERT( count == sizeof(pszOrder) / sizeof(pszOrder[0]) );
+    ut_kvp_iteratorEnd( pIterator );
+
+    ut_kvp_destroyInstance( pInstance );
+    ut_kvp_clearIncludeCache();
+    unlink( zFirst );
+    unlink( zSecond );
+}
+
+static void test_ut_kvp_writeFile( const char *pszDirectory, const char *pszName, const char *pszContent )
+{
+    char zPath[PATH_MAX];
+    char zTemp[PATH_MAX];
+    FILE *pFile;
+
+    /* Saved the way most editors do, into a new file renamed over the old one */
+    snprintf( zPath, sizeof(zPath), "%s/%s", pszDirectory, pszName );
+    snprintf( zTemp, sizeof(zTemp), "%s/.%s.tmp", pszDirectory, pszName );
+    pFile = fopen( zTemp, "w" );
+    UT_ASSERT( pFile != NULL );
+    if ( pFile == NULL )
+    {
+        return;
+    }
+    fputs( pszContent, pFile );
+    fclose( pFile );
+    UT_ASSERT( rename( zTemp, zPath ) == 0 );
+}
+
+void test_ut_kvp_watch( void )
+{
+    static const char *pszFiles[] = { "profile.yaml", "first.yaml", "second.yaml", "third.yaml" };
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_include_cache_stats_t stats;
+    ut_kvp_key_t *pKey;
+    char zDirectory[] = KVP_TEST_WATCH_TEMPLATE;
+    char zPath[PATH_MAX];
+    char zContent[PATH_MAX * 2];
+    bool reloaded = true;
+    FILE *pFile;
+    int fd = -1;
+
+    UT_ASSERT( ut_kvp_watch( NULL, NULL ) == UT_KVP_STATUS_INVALID_INSTANCE );
+    UT_ASSERT( ut_kvp_reload( NULL, NULL ) == UT_KVP_STATUS_INVALID_INSTANCE );
+
+    UT_ASSERT( mkdtemp( zDirectory ) != NULL );
+    snprintf( zContent, sizeof(zContent), "first: !include %s/first.yaml\nsecond: !include %s/second.yaml\n", zDirectory, zDirectory );
+    test_ut_kvp_writeFile( zDirectory, "profile.yaml", zContent );
+    test_ut_kvp_writeFile( zDirectory, "first.yaml", "value: 1\n" );
+    test_ut_kvp_writeFile( zDirectory, "second.yaml", "value: 2\n" );
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    /* A profile from memory has no file to reload from */
+    UT_ASSERT( test_ut_kvp_openString( pInstance, "value: 1\n" ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_watch( pInstance, NULL ) == UT_KVP_STATUS_NO_DATA );
+    UT_ASSERT( ut_kvp_reload( pInstance, NULL ) == UT_KVP_STATUS_NO_DATA );
+
+    snprintf( zPath, sizeof(zPath), "%s/profile.yaml", zDirectory );
+    UT_LOG_STEP("ut_kvp_watch( %s )", zPath);
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( ut_kvp_open( pInstance, zPath ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_watch( pInstance, &fd ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( fd >= 0 );
+    pKey = ut_kvp_compileKey( pInstance, "first/value" );
+    UT_ASSERT( pKey != NULL );
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( pInstance, pKey ) == 1 );
+
+    UT_ASSERT( ut_kvp_reload( pInstance, &reloaded ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( reloaded == false );
+
+    /* Only the include that changed is parsed again */
+    UT_LOG_STEP("ut_kvp_reload() - Include changed");
+    test_ut_kvp_writeFile( zDirectory, "first.yaml", "value: 10\n" );
+    UT_ASSERT( ut_kvp_reload( pInstance, &reloaded ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( reloaded == true );
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( pInstance, pKey ) == 10 );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "second/value" ) == 2 );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( (stats.misses == 3) && (stats.hits == 1) );
+
+    /* A file written in place is seen too */
+    UT_LOG_STEP("ut_kvp_reload() - Include written in place");
+    snprintf( zPath, sizeof(zPath), "%s/second.yaml", zDirectory );
+    pFile = fopen( zPath, "w" );
+    UT_ASSERT( pFile != NULL );
+    fputs( "value: 20\n", pFile );
+    fclose( pFile );
+    UT_ASSERT( ut_kvp_reload( pInstance, &reloaded ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( reloaded == true );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "second/value" ) == 20 );
+
+    /* A profile that no longer parses leaves the current one in place */
+    UT_LOG_STEP("ut_kvp_reload() - Profile broken");
+    test_ut_kvp_writeFile( zDirectory, "profile.yaml", "first: [\n" );
+    UT_ASSERT( ut_kvp_reload( pInstance, &reloaded ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( reloaded == false );
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( pInstance, pKey ) == 10 );
+
+    /* The fixed profile includes a new file, which is watched from then on */
+    UT_LOG_STEP("ut_kvp_reload() - Profile fixed");
+    test_ut_kvp_writeFile( zDirectory, "third.yaml", "value: 3\n" );
+    snprintf( zContent, sizeof(zContent), "first: !include %s/third.yaml\n", zDirectory );
+    test_ut_kvp_writeFile( zDirectory, "profile.yaml", zContent );
+    UT_ASSERT( ut_kvp_reload( pInstance, &reloaded ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( reloaded == true );
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( pInstance, pKey ) == 3 );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "second" ) == false );
+
+    test_ut_kvp_writeFile( zDirectory, "third.yaml", "value: 30\n" );
+    UT_ASSERT( ut_kvp_reload( pInstance, &reloaded ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( pInstance, pKey ) == 30 );
+
+    ut_kvp_freeKey( pKey );
+    ut_kvp_destroyInstance( pInstance );
+    ut_kvp_clearIncludeCache();
+    for ( uint32_t i = 0; i < sizeof(pszFiles) / sizeof(pszFiles[0]); i++ )
+    {
+        snprintf( zPath, sizeof(zPath), "%s/%s", zDirectory, pszFiles[i] );
+        unlink( zPath );
+    }
+    UT_ASSERT( rmdir( zDirectory ) == 0 );
+}
+
+// Struct to store what a reader of test_ut_kvp_concurrent() or test_ut_kvp_threadSafe() checks against
+typedef struct
+{
+    ut_kvp_instance_t *pInstance;
+    bool stop;
+    bool copyStrings;   /* Copies instead of views, views may be released by the next write under UT_KVP_FLAG_THREADSAFE */
+} test_ut_kvp_concurrent_t;
+
+static void *test_ut_kvp_concurrentReader( void *pArg )
+{
+    test_ut_kvp_concurrent_t *pShared = (test_ut_kvp_concurrent_t *)pArg;
+    ut_kvp_key_t *pKey = ut_kvp_compileKey( pShared->pInstance, "check" );
+    ut_kvp_key_t *pName = ut_kvp_compileKey( pShared->pInstance, "name" );
+    uint32_t generation = 0;
+    uint32_t check = 0;
+    uint32_t last = 0;
+    intptr_t failures = 0;
+    ut_kvp_field_t fields[] =
+    {
+        { "generation", UT_KVP_FIELD_TYPE_UINT32, &generation, 0, UT_KVP_STATUS_MAX },
+        { "check", UT_KVP_FIELD_TYPE_UINT32, &check, 0, UT_KVP_STATUS_MAX },
+    };
+
+    /* Compiled per thread, a key must be used by one thread at a time */
+    if ( ( pKey == NULL ) || ( pName == NULL ) )
+    {
+        failures++;
+    }
 
-    /* Check for KEY_NOT_FOUND */
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for output_bytes = NULL and bytes_count = 0, when key is not found");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "shouldNotWork/checkStringDeadBeef", &bytes_count);
-    UT_ASSERT(output_bytes == NULL );
-    UT_ASSERT(bytes_count == 0);
+    while ( ( failures == 0 ) && !__atomic_load_n( &pShared->stop, __ATOMIC_ACQUIRE ) )
+    {
+        char zName[8];
+        const char *pView;
+        size_t length;
+
+        /* One call reads one snapshot, both fields always come from the same document */
+        if ( ( ut_kvp_getFields( pShared->pInstance, fields, 2 ) != UT_KVP_STATUS_SUCCESS ) ||
+             ( generation != check ) || ( generation < last ) )
+        {
+            failures++;
+        }
+        last = generation;
+
+        /* Published in order, a later read never sees an older document */
+        if ( ut_kvp_getUInt32ByHandle( pShared->pInstance, pKey ) < last )
+        {
+            failures++;
+        }
+
+        if ( pShared->copyStrings )
+        {
+            if ( ( ut_kvp_getStringField( pShared->pInstance, "name", zName, sizeof(zName) ) != UT_KVP_STATUS_SUCCESS ) ||
+                 ( strcmp( zName, "test" ) != 0 ) )
+            {
+                failures++;
+            }
+            if ( ( ut_kvp_getStringByHandle( pShared->pInstance, pName, zName, sizeof(zName) ) != UT_KVP_STATUS_SUCCESS ) ||
+                 ( strcmp( zName, "test" ) != 0 ) )
+            {
+                failures++;
+            }
+        }
+        else if ( ( ut_kvp_getStringView( pShared->pInstance, "name", &pView, &length ) != UT_KVP_STATUS_SUCCESS ) ||
+                  ( length != 4 ) || ( memcmp( pView, "test", 4 ) != 0 ) )
+        {
+            failures++;
+        }
+    }
 
-    /* Positive tests */
-     if (read_file_into_memory(KVP_VALID_TEST_YAML_FILE, &kvpdata) == 0)
+    if ( pKey != NULL )
     {
-        printf("\nYAML file is = \n%s\n", kvpdata.buffer);
+        ut_kvp_freeKey( pKey );
     }
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesSpace", &bytes_count);
-    UT_ASSERT(output_bytes != NULL);
-    UT_ASSERT(bytes_count != 0);
-    UT_LOG("Parsed %d bytes:\n", bytes_count);
-    for (int i = 0; i < bytes_count; i++)
+    if ( pName != NULL )
     {
-        printf("0x%02x ", output_bytes[i]);
+        ut_kvp_freeKey( pName );
     }
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
+    return (void *)failures;
+}
 
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesComma", &bytes_count);
-    UT_ASSERT(output_bytes != NULL);
-    UT_ASSERT(bytes_count != 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    for (int i = 0; i < bytes_count; i++)
+void test_ut_kvp_concurrent( void )
+{
+    test_ut_kvp_concurrent_t shared;
+    pthread_t threads[4];
+    char zProfile[128];
+    void *pResult;
+
+    memset( &shared, 0, sizeof(shared) );
+    shared.pInstance = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_CONCURRENT | UT_KVP_FLAG_INDEX );
+    UT_ASSERT( shared.pInstance != NULL );
+    if ( shared.pInstance == NULL )
     {
-        printf("0x%02x ", output_bytes[i]);
+        return;
     }
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
 
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for output_bytes = NULL and bytes_count = 0");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesIncorrect", &bytes_count);
-    UT_ASSERT(output_bytes == NULL);
-    UT_ASSERT(bytes_count == 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
+    UT_LOG_STEP("UT_KVP_FLAG_CONCURRENT - Nothing published before the first open");
+    UT_ASSERT( ut_kvp_fieldPresent( shared.pInstance, "check" ) == false );
 
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkByteCommaSpaces", &bytes_count);
-    UT_ASSERT(output_bytes != NULL);
-    UT_ASSERT(bytes_count != 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    for (int i = 0; i < bytes_count; i++)
+    UT_ASSERT( test_ut_kvp_openString( shared.pInstance, "generation: 1\ncheck: 1\nname: test\n" ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( shared.pInstance, "check" ) == 1 );
+
+    UT_LOG_STEP("UT_KVP_FLAG_CONCURRENT - Readers see whole documents while they are replaced");
+    for ( int i = 0; i < 4; i++ )
     {
-        printf("0x%02x ", output_bytes[i]);
+        UT_ASSERT( pthread_create( &threads[i], NULL, test_ut_kvp_concurrentReader, &shared ) == 0 );
     }
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
-
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesDecimalSpace", &bytes_count);
-    UT_ASSERT(output_bytes != NULL);
-    UT_ASSERT(bytes_count != 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    for (int i = 0; i < bytes_count; i++)
+    for ( uint32_t generation = 2; generation <= 500; generation++ )
     {
-        printf("0x%02x ", output_bytes[i]);
+        snprintf( zProfile, sizeof(zProfile), "generation: %u\ncheck: %u\nname: test\n", generation, generation );
+        UT_ASSERT( test_ut_kvp_openString( shared.pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
     }
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
-
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesDecimalComma", &bytes_count);
-    UT_ASSERT(output_bytes != NULL);
-    UT_ASSERT(bytes_count != 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    for (int i = 0; i < bytes_count; i++)
+    __atomic_store_n( &shared.stop, true, __ATOMIC_RELEASE );
+    for ( int i = 0; i < 4; i++ )
     {
-        printf("0x%02x ", output_bytes[i]);
+        pthread_join( threads[i], &pResult );
+        UT_ASSERT( pResult == NULL );
     }
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
+    UT_ASSERT( ut_kvp_getUInt32Field( shared.pInstance, "check" ) == 500 );
 
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytesDecimalCommaSpace", &bytes_count);
-    UT_ASSERT(output_bytes != NULL);
-    UT_ASSERT(bytes_count != 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    for (int i = 0; i < bytes_count; i++)
+    UT_LOG_STEP("UT_KVP_FLAG_CONCURRENT - Readers copy the same string out of a shared document");
+    shared.stop = false;
+    shared.copyStrings = true;
+    for ( int i = 0; i < 4; i++ )
     {
-        printf("0x%02x ", output_bytes[i]);
+        UT_ASSERT( pthread_create( &threads[i], NULL, test_ut_kvp_concurrentReader, &shared ) == 0 );
     }
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
+    for ( uint32_t generation = 501; generation <= 1000; generation++ )
+    {
+        snprintf( zProfile, sizeof(zProfile), "generation: %u\ncheck: %u\nname: test\n", generation, generation );
+        UT_ASSERT( test_ut_kvp_openString( shared.pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    }
+    __atomic_store_n( &shared.stop, true, __ATOMIC_RELEASE );
+    for ( int i = 0; i < 4; i++ )
+    {
+        pthread_join( threads[i], &pResult );
+        UT_ASSERT( pResult == NULL );
+    }
+    UT_ASSERT( ut_kvp_getUInt32Field( shared.pInstance, "check" ) == 1000 );
 
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkByteSpaceSpaceCommaSpace", &bytes_count);
-    UT_ASSERT(output_bytes != NULL);
-    UT_ASSERT(bytes_count != 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    for (int i = 0; i < bytes_count; i++)
+    UT_LOG_STEP("UT_KVP_FLAG_CONCURRENT - A failed open leaves the published document in place");
+    UT_ASSERT( test_ut_kvp_openString( shared.pInstance, "check: [1, 2\n" ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_getUInt32Field( shared.pInstance, "check" ) == 1000 );
+
+    UT_LOG_STEP("UT_KVP_FLAG_CONCURRENT - Close publishes an empty document");
+    ut_kvp_close( shared.pInstance );
+    UT_ASSERT( ut_kvp_fieldPresent( shared.pInstance, "check" ) == false );
+    UT_ASSERT( test_ut_kvp_openString( shared.pInstance, "check: 7\n" ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( shared.pInstance, "check" ) == 7 );
+
+    ut_kvp_destroyInstance( shared.pInstance );
+}
+
+void test_ut_kvp_threadSafe( void )
+{
+    test_ut_kvp_concurrent_t shared;
+    pthread_t threads[4];
+    char zProfile[128];
+    void *pResult;
+
+    UT_LOG_STEP("UT_KVP_FLAG_THREADSAFE - Can't be combined with UT_KVP_FLAG_CONCURRENT");
+    UT_ASSERT( ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_THREADSAFE | UT_KVP_FLAG_CONCURRENT ) == NULL );
+
+    memset( &shared, 0, sizeof(shared) );
+    shared.copyStrings = true;
+    shared.pInstance = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_THREADSAFE | UT_KVP_FLAG_INDEX );
+    UT_ASSERT( shared.pInstance != NULL );
+    if ( shared.pInstance == NULL )
     {
-        printf("0x%02x ", output_bytes[i]);
+        return;
     }
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
 
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for output_bytes = NULL and bytes_count = 0");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkByteInvalid", &bytes_count);
-    UT_ASSERT(output_bytes == NULL);
-    UT_ASSERT(bytes_count == 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    free(output_bytes);
-    output_bytes = NULL;
+    UT_ASSERT( test_ut_kvp_openString( shared.pInstance, "generation: 1\ncheck: 1\nname: test\n" ) == UT_KVP_STATUS_SUCCESS );
 
-    UT_LOG_STEP("ut_kvp_getDataBytes() - checkBytesSpace for valid output_bytes and bytes_count");
-    output_bytes = ut_kvp_getDataBytes(gpMainTestInstance, "decodeTest/checkBytePrefix", &bytes_count);
-    UT_ASSERT(output_bytes != NULL);
-    UT_ASSERT(bytes_count != 0);
-    UT_LOG("Parsed %zu bytes:\n", bytes_count);
-    for (int i = 0; i < bytes_count; i++)
+    UT_LOG_STEP("UT_KVP_FLAG_THREADSAFE - Readers share the lock while the document is re-opened");
+    for ( int i = 0; i < 4; i++ )
     {
-        printf("0x%02x ", output_bytes[i]);
+        UT_ASSERT( pthread_create( &threads[i], NULL, test_ut_kvp_concurrentReader, &shared ) == 0 );
     }
-    UT_LOG("\n");
-    free(output_bytes);
-    output_bytes = NULL;
+    for ( uint32_t generation = 2; generation <= 500; generation++ )
+    {
+        snprintf( zProfile, sizeof(zProfile), "generation: %u\ncheck: %u\nname: test\n", generation, generation );
+        UT_ASSERT( test_ut_kvp_openString( shared.pInstance, zProfile ) == UT_KVP_STATUS_SUCCESS );
+    }
+    __atomic_store_n( &shared.stop, true, __ATOMIC_RELEASE );
+    for ( int i = 0; i < 4; i++ )
+    {
+        pthread_join( threads[i], &pResult );
+        UT_ASSERT( pResult == NULL );
+    }
+    UT_ASSERT( ut_kvp_getUInt32Field( shared.pInstance, "check" ) == 500 );
+
+    UT_LOG_STEP("UT_KVP_FLAG_THREADSAFE - A failed open closes the instance, as without the flag");
+    UT_ASSERT( test_ut_kvp_openString( shared.pInstance, "check: [1, 2\n" ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_fieldPresent( shared.pInstance, "check" ) == false );
+
+    ut_kvp_destroyInstance( shared.pInstance );
 }
 
-void test_ut_kvp_getFloatField( void )
+void test_ut_kvp_clone( void )
 {
-    float result;
-    float checkFloat = 5.1;
+    ut_kvp_instance_t *pInstance;
+    ut_kvp_instance_t *pClone;
+    ut_kvp_instance_t *pSecond;
 
-    UT_LOG_STEP("ut_kvp_getFloatField() ");
-    result = ut_kvp_getFloatField(gpMainTestInstance, "decodeTest.checkFloat");
-    UT_ASSERT(result == checkFloat );
+    UT_LOG_STEP("ut_kvp_clone( NULL ) - Negative");
+    UT_ASSERT( ut_kvp_clone( NULL ) == NULL );
 
-    UT_LOG_STEP("ut_kvp_getFloatField() ");
-    result = ut_kvp_getFloatField(gpMainTestInstance, "decodeTest/checkFloat");
-    UT_ASSERT(result == checkFloat);
+    pInstance = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_INDEX );
+    UT_ASSERT( pInstance != NULL );
+    if ( pInstance == NULL )
+    {
+        return;
+    }
+
+    UT_LOG_STEP("ut_kvp_clone() - An empty instance clones to an empty one");
+    pClone = ut_kvp_clone( pInstance );
+    UT_ASSERT( pClone != NULL );
+    UT_ASSERT( ut_kvp_fieldPresent( pClone, "check" ) == false );
+    ut_kvp_destroyInstance( pClone );
+
+    UT_LOG_STEP("ut_kvp_clone() - The clone keeps its profile once the original is closed");
+    UT_ASSERT( test_ut_kvp_openString( pInstance, "check: 1\nname: base\n" ) == UT_KVP_STATUS_SUCCESS );
+    pClone = ut_kvp_clone( pInstance );
+    UT_ASSERT( pClone != NULL );
+    UT_ASSERT( ut_kvp_getUInt32Field( pClone, "check" ) == 1 );
+    ut_kvp_close( pInstance );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "check" ) == false );
+    UT_ASSERT( ut_kvp_getUInt32Field( pClone, "check" ) == 1 );
+
+    UT_LOG_STEP("ut_kvp_clone() - Re-opening a clone leaves the others on the shared profile");
+    pSecond = ut_kvp_clone( pClone );
+    UT_ASSERT( pSecond != NULL );
+    UT_ASSERT( test_ut_kvp_openString( pClone, "check: 2\n" ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pClone, "check" ) == 2 );
+    UT_ASSERT( ut_kvp_getUInt32Field( pSecond, "check" ) == 1 );
+    ut_kvp_destroyInstance( pSecond );
+    ut_kvp_destroyInstance( pClone );
+
+    UT_LOG_STEP("ut_kvp_clone() - A mapped profile stays mapped until its last instance is destroyed");
+    UT_ASSERT( ut_kvp_openMapped( pInstance, KVP_VALID_TEST_YAML_FILE ) == UT_KVP_STATUS_SUCCESS );
+    pClone = ut_kvp_clone( pInstance );
+    UT_ASSERT( pClone != NULL );
+    ut_kvp_destroyInstance( pInstance );
+    UT_ASSERT( ut_kvp_getUInt32Field( pClone, "decodeTest/checkUint32IsDeadBeefHex" ) == 0xdeadbeef );
+    ut_kvp_destroyInstance( pClone );
+
+    UT_LOG_STEP("ut_kvp_clone() - A concurrent instance clones its published document");
+    pInstance = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_CONCURRENT );
+    UT_ASSERT( pInstance != NULL );
+    if ( pInstance == NULL )
+    {
+        return;
+    }
+    UT_ASSERT( test_ut_kvp_openString( pInstance, "check: 1\n" ) == UT_KVP_STATUS_SUCCESS );
+    pClone = ut_kvp_clone( pInstance );
+    UT_ASSERT( pClone != NULL );
+    UT_ASSERT( test_ut_kvp_openString( pInstance, "check: 2\n" ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "check" ) == 2 );
+    UT_ASSERT( ut_kvp_getUInt32Field( pClone, "check" ) == 1 );
+    ut_kvp_destroyInstance( pInstance );
+    UT_ASSERT( ut_kvp_getUInt32Field( pClone, "check" ) == 1 );
+    ut_kvp_destroyInstance( pClone );
 }
 
-void test_ut_kvp_getDoubleField( void )
+void test_ut_kvp_lazyOpen( void )
 {
-    double result;
-    double checkDoublePi = 3.14159265358979323846;
-    double checkDoubleScientific = -4.2e8;
-    double checkDoubleInvalid = 0;
+    ut_kvp_instance_t *pInstance;
+    ut_kvp_instance_t *pEager;
+    ut_kvp_include_cache_stats_t stats;
+    char zFragment[] = KVP_TEST_INCLUDE_TEMPLATE;
+    char zMain[] = KVP_TEST_INCLUDE_TEMPLATE;
+    char *pLazyData;
+    char *pEagerData;
+    char zValue[16];
+    uint32_t values[2];
+    uint32_t count;
+    uint32_t second = 0;
+    uint32_t broken = 0;
+    ut_kvp_field_t fields[] =
+    {
+        { "second/value", UT_KVP_FIELD_TYPE_UINT32, &second, 0, UT_KVP_STATUS_MAX },
+        { "broken/0", UT_KVP_FIELD_TYPE_UINT32, &broken, 0, UT_KVP_STATUS_MAX },
+    };
+    FILE *pFile;
+    int fd;
+
+    UT_LOG_STEP("UT_KVP_FLAG_LAZY - Can't be combined with UT_KVP_FLAG_CONCURRENT, UT_KVP_FLAG_THREADSAFE or UT_KVP_FLAG_SHARED_INCLUDES");
+    UT_ASSERT( ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_LAZY | UT_KVP_FLAG_CONCURRENT ) == NULL );
+    UT_ASSERT( ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_LAZY | UT_KVP_FLAG_THREADSAFE ) == NULL );
+    UT_ASSERT( ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_LAZY | UT_KVP_FLAG_SHARED_INCLUDES ) == NULL );
+
+    pInstance = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_LAZY | UT_KVP_FLAG_INDEX );
+    UT_ASSERT( pInstance != NULL );
+    pEager = ut_kvp_createInstance();
+    UT_ASSERT( pEager != NULL );
+    if ( (pInstance == NULL) || (pEager == NULL) )
+    {
+        ut_kvp_destroyInstance( pInstance );
+        ut_kvp_destroyInstance( pEager );
+        return;
+    }
 
-    UT_LOG_STEP("ut_kvp_getDoubleField() ");
-    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest.checkDoublePi");
-    UT_ASSERT(result == checkDoublePi );
+    fd = mkstemp(zFragment);
+    UT_ASSERT( fd >= 0 );
+    close(fd);
+    fd = mkstemp(zMain);
+    UT_ASSERT( fd >= 0 );
+    close(fd);
+
+    pFile = fopen( zFragment, "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "value: 1\n" );
+    fclose( pFile );
+    pFile = fopen( zMain, "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "# Sections are parsed on first use\n---\nfirst: !include %s\nsecond:\n  value: 2\nbroken: [1, 2\n", zFragment );
+    fclose( pFile );
+
+    UT_LOG_STEP("ut_kvp_open() - UT_KVP_FLAG_LAZY parses and includes a section only when it is read");
+    ut_kvp_clearIncludeCache();
+    UT_ASSERT( ut_kvp_open( pInstance, zMain ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "second/value" ) == 2 );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( stats.misses == 0 );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "first.value" ) == 1 );
+    ut_kvp_getIncludeCacheStats( &stats );
+    UT_ASSERT( stats.misses == 1 );
+
+    UT_LOG_STEP("ut_kvp_open() - UT_KVP_FLAG_LAZY reports a broken section when it is read");
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "broken/0" ) == false );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "second/value" ) == 2 );
+    UT_ASSERT( ut_kvp_open( pEager, zMain ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_getStringField( pInstance, "broken/0", zValue, sizeof(zValue) ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_getStringField( pInstance, "broken", zValue, sizeof(zValue) ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_getUInt32Array( pInstance, "broken", values, 2, &count ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_getFields( pInstance, fields, 2 ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( (fields[0].status == UT_KVP_STATUS_SUCCESS) && (fields[1].status == UT_KVP_STATUS_PARSING_ERROR) );
+    UT_ASSERT( ut_kvp_getStringField( pInstance, "missing", zValue, sizeof(zValue) ) == UT_KVP_STATUS_KEY_NOT_FOUND );
+
+    UT_LOG_STEP("ut_kvp_open() - UT_KVP_FLAG_LAZY reads the same profile as a full open, %s", KVP_VALID_TEST_RESOLVE_YAML_TAGS_YAML);
+    UT_ASSERT( ut_kvp_open( pInstance, KVP_VALID_TEST_RESOLVE_YAML_TAGS_YAML ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_open( pEager, KVP_VALID_TEST_RESOLVE_YAML_TAGS_YAML ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "plugin/1/3/value" ) == true );
+    UT_ASSERT( ut_kvp_getListCount( pInstance, "plugin" ) == 2 );
+    pLazyData = ut_kvp_getData( pInstance );
+    pEagerData = ut_kvp_getData( pEager );
+    UT_ASSERT( (pLazyData != NULL) && (pEagerData != NULL) );
+    if ( (pLazyData != NULL) && (pEagerData != NULL) )
+    {
+        UT_ASSERT( strcmp( pLazyData, pEagerData ) == 0 );
+    }
+    free( pLazyData );
+    free( pEagerData );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "11/5/value" ) == true );
+
+    UT_LOG_STEP("ut_kvp_open() - UT_KVP_FLAG_LAZY opens a profile with anchors in full");
+    pFile = fopen( zMain, "w" );
+    UT_ASSERT( pFile != NULL );
+    fprintf( pFile, "base: &base\n  value: 3\ncopy: *base\n" );
+    fclose( pFile );
+    UT_ASSERT( ut_kvp_open( pInstance, zMain ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "copy/value" ) == 3 );
 
-    UT_LOG_STEP("ut_kvp_getDoubleField() ");
-    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest/checkDoublePi");
-    UT_ASSERT(result == checkDoublePi);
+    ut_kvp_destroyInstance( pInstance );
+    ut_kvp_destroyInstance( pEager );
+    unlink( zFragment );
+    unlink( zMain );
+}
 
-    UT_LOG_STEP("ut_kvp_getDoubleField() ");
-    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest.checkDoubleScientific");
-    UT_ASSERT(result == checkDoubleScientific );
+void test_ut_kvp_includeTags( void )
+{
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_status_t status;
 
-    UT_LOG_STEP("ut_kvp_getDoubleField() ");
-    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest/checkDoubleScientific");
-    UT_ASSERT(result == checkDoubleScientific);
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
 
-    UT_LOG_STEP("ut_kvp_getDoubleField() ");
-    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest.checkDoubleInvalid");
-    UT_ASSERT(result == checkDoubleInvalid );
+    /* Includes are expanded in place, in mapping values and in sequences */
+    UT_LOG_STEP("ut_kvp_open( pInstance, %s ) - Positive", KVP_VALID_TEST_RESOLVE_YAML_TAGS_YAML);
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_RESOLVE_YAML_TAGS_YAML );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "1/value" ) == true );
+    UT_ASSERT( ut_kvp_getListCount( pInstance, "plugin" ) == 2 );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "plugin/0/2/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "plugin/1/3/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "10/4/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "11/5/value" ) == true );
+
+    /* Reopening replaces the previous document */
+    UT_LOG_STEP("ut_kvp_open( pInstance, %s ) - Reopen", KVP_VALID_TEST_RESOLVE_YAML_TAGS_IN_SEQUENCE_YAML);
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_RESOLVE_YAML_TAGS_IN_SEQUENCE_YAML );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "1/value" ) == false );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "configItem/value/2/value" ) == true );
+    UT_ASSERT( ut_kvp_getListCount( pInstance, "listConfig/valueList" ) == 2 );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "listConfig/valueList/0/3/value" ) == true );
+    UT_ASSERT( ut_kvp_getBoolField( pInstance, "listConfig/valueList/1/4/value" ) == true );
+
+    /* A document without includes is taken over as parsed */
+    UT_LOG_STEP("ut_kvp_open( pInstance, %s ) - No includes", KVP_VALID_TEST_YAML_FILE);
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_fieldPresent( pInstance, "configItem" ) == false );
+    UT_ASSERT( ut_kvp_getUInt32Field( pInstance, "decodeTest/checkUint32IsDeadBeefHex" ) == 0xdeadbeef );
 
-    UT_LOG_STEP("ut_kvp_getDoubleField() ");
-    result = ut_kvp_getDoubleField(gpMainTestInstance, "decodeTest/checkDoubleInvalid");
-    UT_ASSERT(result == checkDoubleInvalid);
+    ut_kvp_destroyInstance( pInstance );
 }
 
-void test_ut_kvp_fieldPresent()
+void test_ut_kvp_image( void )
 {
-    bool result;
+    const char *checkKeys[] = { "decodeTest/checkUint8IsDeHex", "decodeTest/checkUint16IsDeadDec", "decodeTest/checkUint32IsDeadBeefHex",
+                                "decodeTest/checkUint64IsDeadBeefDec", "decodeTest.checkBoolTRuE", "decodeTest/checkBoolFaLse",
+                                "decodeTest/checkFloat", "decodeTest/checkDoubleScientific", "decodeTest/checkDoubleInvalid" };
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_instance_t *pImage = NULL;
+    ut_kvp_status_t status;
+    ut_kvp_iterator_t *pIterator;
+    ut_kvp_iterator_t *pDocIterator;
+    ut_kvp_key_t *pKey;
+    uint16_t u16Value = 0;
+    bool bValue = true;
+    ut_kvp_field_t fields[] =
+    {
+        { "decodeTest/checkUint16IsDeadHex", UT_KVP_FIELD_TYPE_UINT16, &u16Value, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/shouldNotWork", UT_KVP_FIELD_TYPE_BOOL, &bValue, 0, UT_KVP_STATUS_MAX },
+    };
+    char zImage[] = KVP_TEST_IMAGE_TEMPLATE;
+    char result[UT_KVP_MAX_ELEMENT_SIZE];
+    uint32_t u32Values[3];
+    const char *pStrings[3];
+    size_t lengths[3];
+    unsigned char bytes[64];
+    unsigned char *pBytes;
+    const char *pView;
+    size_t length;
+    size_t docLength;
+    uint32_t count;
+    int size;
+    int fd;
+
+    fd = mkstemp(zImage);
+    UT_ASSERT( fd >= 0 );
+    close(fd);
 
-    /* Negative Tests */
-    result = ut_kvp_fieldPresent( gpMainTestInstance, "shouldNotWork/checkBoolTRUE" );
-    UT_ASSERT( result == false );
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+    pImage = ut_kvp_createInstance();
+    UT_ASSERT( pImage != NULL );
 
-    result = ut_kvp_fieldPresent( gpMainTestInstance, "shouldNotWork" );
-    UT_ASSERT( result == false );
+    /* Negative Tests */
+    UT_LOG_STEP("ut_kvp_compileImage() - Negative");
+    UT_ASSERT( ut_kvp_compileImage( NULL, zImage ) == UT_KVP_STATUS_INVALID_INSTANCE );
+    UT_ASSERT( ut_kvp_compileImage( pInstance, NULL ) == UT_KVP_STATUS_INVALID_PARAM );
+    UT_ASSERT( ut_kvp_compileImage( pInstance, zImage ) == UT_KVP_STATUS_NO_DATA );
+
+    UT_LOG_STEP("ut_kvp_openImage() - Negative");
+    UT_ASSERT( ut_kvp_openImage( NULL, zImage ) == UT_KVP_STATUS_INVALID_INSTANCE );
+    UT_ASSERT( ut_kvp_openImage( pImage, NULL ) == UT_KVP_STATUS_INVALID_PARAM );
+    UT_ASSERT( ut_kvp_openImage( pImage, KVP_VALID_TEST_NO_FILE ) == UT_KVP_STATUS_FILE_OPEN_ERROR );
+    UT_ASSERT( ut_kvp_openImage( pImage, KVP_VALID_TEST_ZERO_LENGTH_YAML_FILE ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_openImage( pImage, KVP_VALID_TEST_YAML_FILE ) == UT_KVP_STATUS_PARSING_ERROR );
 
     /* Positive Tests */
-    result = ut_kvp_fieldPresent( gpMainTestInstance, "decodeTest/checkBoolTRUE" );
-    UT_ASSERT( result == true );
+    UT_LOG_STEP("ut_kvp_compileImage( %s ) - Positive", KVP_VALID_TEST_YAML_FILE);
+    status = ut_kvp_open( pInstance, KVP_VALID_TEST_YAML_FILE );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    status = ut_kvp_compileImage( pInstance, zImage );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
 
-    result = ut_kvp_fieldPresent( gpMainTestInstance, "decodeTest" );
-    UT_ASSERT( result == true );
+    UT_LOG_STEP("ut_kvp_openImage() - Positive");
+    status = ut_kvp_openImage( pImage, zImage );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getData( pImage ) == NULL );
+
+    /* Every getter must agree with the parsed document */
+    UT_LOG_STEP("ut_kvp_openImage() - Scalars match the document");
+    for (uint32_t i = 0; i < sizeof(checkKeys) / sizeof(checkKeys[0]); i++)
+    {
+        UT_ASSERT( ut_kvp_getBoolField( pImage, checkKeys[i] ) == ut_kvp_getBoolField( pInstance, checkKeys[i] ) );
+        UT_ASSERT( ut_kvp_getUInt8Field( pImage, checkKeys[i] ) == ut_kvp_getUInt8Field( pInstance, checkKeys[i] ) );
+        UT_ASSERT( ut_kvp_getUInt16Field( pImage, checkKeys[i] ) == ut_kvp_getUInt16Field( pInstance, checkKeys[i] ) );
+        UT_ASSERT( ut_kvp_getUInt32Field( pImage, checkKeys[i] ) == ut_kvp_getUInt32Field( pInstance, checkKeys[i] ) );
+        UT_ASSERT( ut_kvp_getUInt64Field( pImage, checkKeys[i] ) == ut_kvp_getUInt64Field( pInstance, checkKeys[i] ) );
+        UT_ASSERT( ut_kvp_getFloatField( pImage, checkKeys[i] ) == ut_kvp_getFloatField( pInstance, checkKeys[i] ) );
+        UT_ASSERT( ut_kvp_getDoubleField( pImage, checkKeys[i] ) == ut_kvp_getDoubleField( pInstance, checkKeys[i] ) );
+    }
+    UT_ASSERT( ut_kvp_getUInt32Field( pImage, "decodeTest/checkUint32IsDeadBeefHex" ) == 0xdeadbeef );
+    UT_ASSERT( ut_kvp_getUInt64Field( pImage, "decodeTest/checkUint64IsDeadBeefDec" ) == 0xdeadbeefdeadbeef );
+    UT_ASSERT( ut_kvp_getUInt8Field( pImage, "decodeTest/checkUint16IsDeadDec" ) == 0 );
+    UT_ASSERT( ut_kvp_getDoubleField( pImage, "decodeTest/checkDoubleScientific" ) == -4.2e8 );
+
+    UT_LOG_STEP("ut_kvp_openImage() - Strings and presence");
+    status = ut_kvp_getStringField( pImage, "decodeTest/checkStringDeadBeef", result, sizeof(result) );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( result, "the beef is dead" );
+    status = ut_kvp_getStringView( pImage, "decodeTest.checkStringDeadBeef2", &pView, &length );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( (length == strlen("the beef is also dead")) && (strncmp(pView, "the beef is also dead", length) == 0) );
+    UT_ASSERT( ut_kvp_getStringField( pImage, "decodeTest/shouldNotWork", result, sizeof(result) ) == UT_KVP_STATUS_KEY_NOT_FOUND );
+    UT_ASSERT( ut_kvp_getStringField( pImage, "decodeTest/checkStringList", result, sizeof(result) ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_fieldPresent( pImage, "decodeTest/checkStringList" ) == true );
+    UT_ASSERT( ut_kvp_fieldPresent( pImage, "decodeTest/shouldNotWork" ) == false );
+    UT_ASSERT( ut_kvp_getListCount( pImage, "decodeTest/checkUint64List" ) == 3 );
+    UT_ASSERT( ut_kvp_getListCount( pImage, "decodeTest/checkFloat" ) == 0 );
+
+    UT_LOG_STEP("ut_kvp_openImage() - Data bytes");
+    status = ut_kvp_getDataBytesToBuffer( pImage, "decodeTest/checkBytesComma", bytes, sizeof(bytes), &count );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    pBytes = ut_kvp_getDataBytes( pInstance, "decodeTest/checkBytesComma", &size );
+    UT_ASSERT( pBytes != NULL );
+    if (pBytes != NULL)
+    {
+        UT_ASSERT( ((uint32_t)size == count) && (memcmp(bytes, pBytes, count) == 0) );
+        free(pBytes);
+    }
+
+    UT_LOG_STEP("ut_kvp_openImage() - Arrays and batch reads");
+    status = ut_kvp_getUInt32Array( pImage, "decodeTest/checkUint32List", u32Values, 3, &count );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( (count == 3) && (u32Values[0] == 720) && (u32Values[1] == 800) && (u32Values[2] == 1080) );
+    status = ut_kvp_getStringArray( pImage, "decodeTest/checkStringList", pStrings, lengths, 3, &count );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( (count == 3) && (lengths[2] == strlen("stringC")) && (strncmp(pStrings[2], "stringC", lengths[2]) == 0) );
+    UT_ASSERT( ut_kvp_getUInt32Array( pImage, "decodeTest/checkFloat", u32Values, 3, &count ) == UT_KVP_STATUS_PARSING_ERROR );
+
+    status = ut_kvp_getFields( pImage, fields, sizeof(fields)/sizeof(fields[0]) );
+    UT_ASSERT( status == UT_KVP_STATUS_KEY_NOT_FOUND );
+    UT_ASSERT( (fields[0].status == UT_KVP_STATUS_SUCCESS) && (u16Value == 0xdead) );
+    UT_ASSERT( fields[1].status == UT_KVP_STATUS_KEY_NOT_FOUND );
+
+    UT_LOG_STEP("ut_kvp_openImage() - Key handles and iterators");
+    pKey = ut_kvp_compileKey( pImage, "decodeTest.checkUint32IsDeadBeefDec" );
+    UT_ASSERT( pKey != NULL );
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( pImage, pKey ) == 0xdeadbeef );
+    UT_ASSERT( ut_kvp_getUInt32ByHandle( pImage, pKey ) == 0xdeadbeef );
+    ut_kvp_freeKey( pKey );
+
+    /* Children come back in document order, walk both side by side */
+    pIterator = ut_kvp_iteratorBegin( pImage, "decodeTest" );
+    UT_ASSERT( pIterator != NULL );
+    pDocIterator = ut_kvp_iteratorBegin( pInstance, "decodeTest" );
+    UT_ASSERT( pDocIterator != NULL );
+    count = 0;
+    while (ut_kvp_iteratorNext( pDocIterator ) == true)
+    {
+        const char *pName = ut_kvp_iteratorGetName( pDocIterator, &docLength );
+
+        UT_ASSERT( ut_kvp_iteratorNext( pIterator ) == true );
+        UT_ASSERT( ut_kvp_iteratorGetIndex( pIterator ) == count );
+        pView = ut_kvp_iteratorGetName( pIterator, &length );
+        UT_ASSERT( (pView != NULL) && (length == docLength) && (strncmp(pView, pName, length) == 0) );
+        UT_ASSERT( ut_kvp_iteratorGetUInt64( pIterator ) == ut_kvp_iteratorGetUInt64( pDocIterator ) );
+        count++;
+    }
+    UT_ASSERT( count > 0 );
+    UT_ASSERT( ut_kvp_iteratorNext( pIterator ) == false );
+    ut_kvp_iteratorEnd( pDocIterator );
+    ut_kvp_iteratorEnd( pIterator );
+
+    /* Compiling an image instance writes the mapping back out */
+    UT_LOG_STEP("ut_kvp_compileImage( pImage ) - Rewrite");
+    UT_ASSERT( ut_kvp_compileImage( pImage, zImage ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_openImage( pImage, zImage ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt16Field( pImage, "decodeTest/checkUint16IsDeadHex" ) == 0xdead );
+
+    /* Reopening as a document releases the image */
+    UT_LOG_STEP("ut_kvp_open( pImage ) - Replaces the image");
+    UT_ASSERT( ut_kvp_open( pImage, KVP_VALID_TEST_JSON_FILE ) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt16Field( pImage, "decodeTest/checkUint16IsDeadHex" ) == 0xdead );
+
+    /* A truncated image fails validation, the profile already open must survive it */
+    UT_LOG_STEP("ut_kvp_openImage() - A corrupt image keeps the current profile");
+    UT_ASSERT( truncate( zImage, 256 ) == 0 );
+    UT_ASSERT( ut_kvp_openImage( pImage, zImage ) == UT_KVP_STATUS_PARSING_ERROR );
+    UT_ASSERT( ut_kvp_getUInt16Field( pImage, "decodeTest/checkUint16IsDeadHex" ) == 0xdead );
+    status = ut_kvp_getStringField( pImage, "decodeTest/checkStringDeadBeef", result, sizeof(result) );
+    UT_ASSERT( status == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( result, "the beef is dead" );
 
+    ut_kvp_destroyInstance( pImage );
+    ut_kvp_destroyInstance( pInstance );
+    unlink(zImage);
 }
 
 void test_ut_kvp_get_field_without_open( void )
@@ -930,7 +2919,7 @@ void test_ut_kvp_singleIncludeUrlsWithBuildFromFile(void)
 /*These tests, test for availability of include file in the given file
  **The given file only contains file path to be included, however the
  **the included file contains file path of another file and so on.
- **KVP as now supports UT_KVP_MAX_INCLUDE_DEPTH = 5
+ **KVP supports an include depth of 5 by default, see ut_kvp_setIncludeDepth()
  */
 void test_ut_kvp_IncludeDepthCheckWithBuildFromFile(void)
 {
@@ -1026,7 +3015,7 @@ void test_ut_kvp_singleIncludeUrlsWithBuildFromMallocedData(void)
 /*These tests, test for availability of include file in the malloc'd data
  **The malloc'd data only contains file path to be included, however the
  **the included file contains file path of another file and so on.
- **KVP as now supports UT_KVP_MAX_INCLUDE_DEPTH = 5
+ **KVP supports an include depth of 5 by default, see ut_kvp_setIncludeDepth()
  */
 void test_ut_kvp_IncludeDepthCheckWithBuildFromMallocedData(void)
 {
@@ -1103,6 +3092,30 @@ static int test_ut_kvp_createGlobalJSONInstance( void )
     return 0;
 }
 
+static int test_ut_kvp_createGlobalYAMLIndexedInstance( void )
+{
+    ut_kvp_status_t status;
+
+    gpMainTestInstance = ut_kvp_createInstanceWithFlags( UT_KVP_FLAG_INDEX );
+    if ( gpMainTestInstance == NULL )
+    {
+        assert( gpMainTestInstance != NULL );
+        UT_LOG_ERROR("ut_kvp_open() - Read Failure");
+        return -1;
+    }
+
+    status = ut_kvp_open( gpMainTestInstance, KVP_VALID_TEST_YAML_FILE);
+    assert( status == UT_KVP_STATUS_SUCCESS );
+
+    if ( status != UT_KVP_STATUS_SUCCESS )
+    {
+        UT_LOG_ERROR("ut_kvp_open() - Read Failure");
+        return -1;
+    }
+
+    return 0;
+}
+
 static int test_ut_kvp_createGlobalYAMLInstanceForMallocedData( void )
 {
     ut_kvp_status_t status;
@@ -1296,6 +3309,25 @@ void register_kvp_functions( void )
 
     UT_add_test(gpKVPSuite, "kvp create / destroy", test_ut_kvp_testCreateDestroy);
     UT_add_test(gpKVPSuite, "kvp read", test_ut_kvp_open);
+    UT_add_test(gpKVPSuite, "kvp read mapped", test_ut_kvp_openMapped);
+    UT_add_test(gpKVPSuite, "kvp image", test_ut_kvp_image);
+    UT_add_test(gpKVPSuite, "kvp include tags", test_ut_kvp_includeTags);
+    UT_add_test(gpKVPSuite, "kvp include cache", test_ut_kvp_includeCache);
+    UT_add_test(gpKVPSuite, "kvp parallel includes", test_ut_kvp_parallelIncludes);
+    UT_add_test(gpKVPSuite, "kvp URL cache", test_ut_kvp_urlCache);
+    UT_add_test(gpKVPSuite, "kvp include timeouts", test_ut_kvp_includeTimeouts);
+    UT_add_test(gpKVPSuite, "kvp include bundle", test_ut_kvp_includeBundle);
+    UT_add_test(gpKVPSuite, "kvp shared includes", test_ut_kvp_sharedIncludes);
+    UT_add_test(gpKVPSuite, "kvp include cycles", test_ut_kvp_includeCycles);
+    UT_add_test(gpKVPSuite, "kvp include order", test_ut_kvp_includeOrder);
+    UT_add_test(gpKVPSuite, "kvp watch", test_ut_kvp_watch);
+    UT_add_test(gpKVPSuite, "kvp concurrent", test_ut_kvp_concurrent);
+    UT_add_test(gpKVPSuite, "kvp thread safe", test_ut_kvp_threadSafe);
+    UT_add_test(gpKVPSuite, "kvp clone", test_ut_kvp_clone);
+    UT_add_test(gpKVPSuite, "kvp lazy open", test_ut_kvp_lazyOpen);
+    UT_add_test(gpKVPSuite, "kvp long numbers", test_ut_kvp_longNumbers);
+    UT_add_test(gpKVPSuite, "kvp key handle reopen", test_ut_kvp_keyHandle_reopen);
+    UT_add_test(gpKVPSuite, "kvp iterator reopen", test_ut_kvp_iterator_reopen);
 
     gpKVPSuite2 = UT_add_suite("ut-kvp - test main functions YAML Decoder ", test_ut_kvp_createGlobalYAMLInstance, test_ut_kvp_freeGlobalInstance);
     assert(gpKVPSuite2 != NULL);
@@ -1304,6 +3336,10 @@ void register_kvp_functions( void )
     UT_add_test(gpKVPSuite2, "kvp uint16", test_ut_kvp_uint16);
     UT_add_test(gpKVPSuite2, "kvp bool", test_ut_kvp_bool);
     UT_add_test(gpKVPSuite2, "kvp string", test_ut_kvp_string);
+    UT_add_test(gpKVPSuite2, "kvp string view", test_ut_kvp_stringView);
+    UT_add_test(gpKVPSuite2, "kvp get fields", test_ut_kvp_getFields);
+    UT_add_test(gpKVPSuite2, "kvp iterator", test_ut_kvp_iterator);
+    UT_add_test(gpKVPSuite2, "kvp arrays", test_ut_kvp_arrays);
     UT_add_test(gpKVPSuite2, "kvp uint32", test_ut_kvp_uint32);
     UT_add_test(gpKVPSuite2, "kvp uint64", test_ut_kvp_uint64);
     UT_add_test(gpKVPSuite2, "kvp list", test_ut_kvp_list);
@@ -1311,12 +3347,19 @@ void register_kvp_functions( void )
     UT_add_test(gpKVPSuite2, "kvp double", test_ut_kvp_getDoubleField);
     UT_add_test(gpKVPSuite2, "kvp node presence", test_ut_kvp_fieldPresent);
     UT_add_test(gpKVPSuite2, "kvp dataByte", test_ut_kvp_dataByte);
+    UT_add_test(gpKVPSuite2, "kvp dataByte to buffer", test_ut_kvp_dataBytesToBuffer);
+    UT_add_test(gpKVPSuite2, "kvp dataByte threads", test_ut_kvp_dataBytesThreads);
+    UT_add_test(gpKVPSuite2, "kvp key handle", test_ut_kvp_keyHandle);
 
     /* Perform the same parsing tests but use a json file instead */
     gpKVPSuite3 = UT_add_suite("ut-kvp - test main functions JSON Decoder ", test_ut_kvp_createGlobalJSONInstance, test_ut_kvp_freeGlobalInstance);
     assert(gpKVPSuite3 != NULL);
 
     UT_add_test(gpKVPSuite3, "kvp string", test_ut_kvp_string);
+    UT_add_test(gpKVPSuite3, "kvp string view", test_ut_kvp_stringView);
+    UT_add_test(gpKVPSuite3, "kvp get fields", test_ut_kvp_getFields);
+    UT_add_test(gpKVPSuite3, "kvp iterator", test_ut_kvp_iterator);
+    UT_add_test(gpKVPSuite3, "kvp arrays", test_ut_kvp_arrays);
     UT_add_test(gpKVPSuite3, "kvp uint8", test_ut_kvp_uint8);
     UT_add_test(gpKVPSuite3, "kvp uint16", test_ut_kvp_uint16);
 
@@ -1327,6 +3370,7 @@ void register_kvp_functions( void )
     UT_add_test(gpKVPSuite3, "kvp float", test_ut_kvp_getFloatField);
     UT_add_test(gpKVPSuite3, "kvp double", test_ut_kvp_getDoubleField);
     UT_add_test(gpKVPSuite3, "kvp node presence", test_ut_kvp_fieldPresent);
+    UT_add_test(gpKVPSuite3, "kvp key handle", test_ut_kvp_keyHandle);
 
 
     gpKVPSuite4 = UT_add_suite("ut-kvp - test main functions Test without Open ", NULL, NULL);
@@ -1342,18 +3386,28 @@ void register_kvp_functions( void )
     UT_add_test(gpKVPSuite5, "kvp uint16", test_ut_kvp_uint16);
     UT_add_test(gpKVPSuite5, "kvp bool", test_ut_kvp_bool);
     UT_add_test(gpKVPSuite5, "kvp string", test_ut_kvp_string);
+    UT_add_test(gpKVPSuite5, "kvp string view", test_ut_kvp_stringView);
+    UT_add_test(gpKVPSuite5, "kvp get fields", test_ut_kvp_getFields);
+    UT_add_test(gpKVPSuite5, "kvp iterator", test_ut_kvp_iterator);
+    UT_add_test(gpKVPSuite5, "kvp arrays", test_ut_kvp_arrays);
     UT_add_test(gpKVPSuite5, "kvp uint32", test_ut_kvp_uint32);
     UT_add_test(gpKVPSuite5, "kvp uint64", test_ut_kvp_uint64);
     UT_add_test(gpKVPSuite5, "kvp float", test_ut_kvp_getFloatField);
     UT_add_test(gpKVPSuite5, "kvp double", test_ut_kvp_getDoubleField);
     UT_add_test(gpKVPSuite5, "kvp node presence", test_ut_kvp_fieldPresent);
     UT_add_test(gpKVPSuite5, "kvp dataByte", test_ut_kvp_dataByte);
+    UT_add_test(gpKVPSuite5, "kvp dataByte to buffer", test_ut_kvp_dataBytesToBuffer);
+    UT_add_test(gpKVPSuite5, "kvp key handle", test_ut_kvp_keyHandle);
 
     /* Perform the same parsing tests but use a json file instead */
     gpKVPSuite6 = UT_add_suite("ut-kvp - test main functions JSON Decoder with malloc'd data", test_ut_kvp_createGlobalJSONInstanceForMallocedData, test_ut_kvp_freeGlobalInstance);
     assert(gpKVPSuite6 != NULL);
 
     UT_add_test(gpKVPSuite6, "kvp string", test_ut_kvp_string);
+    UT_add_test(gpKVPSuite6, "kvp string view", test_ut_kvp_stringView);
+    UT_add_test(gpKVPSuite6, "kvp get fields", test_ut_kvp_getFields);
+    UT_add_test(gpKVPSuite6, "kvp iterator", test_ut_kvp_iterator);
+    UT_add_test(gpKVPSuite6, "kvp arrays", test_ut_kvp_arrays);
     UT_add_test(gpKVPSuite6, "kvp uint8", test_ut_kvp_uint8);
     UT_add_test(gpKVPSuite6, "kvp uint16", test_ut_kvp_uint16);
     UT_add_test(gpKVPSuite6, "kvp bool", test_ut_kvp_bool);
@@ -1362,6 +3416,7 @@ void register_kvp_functions( void )
     UT_add_test(gpKVPSuite6, "kvp float", test_ut_kvp_getFloatField);
     UT_add_test(gpKVPSuite6, "kvp double", test_ut_kvp_getDoubleField);
     UT_add_test(gpKVPSuite6, "kvp node presence", test_ut_kvp_fieldPresent);
+    UT_add_test(gpKVPSuite6, "kvp key handle", test_ut_kvp_keyHandle);
 
     gpKVPSuite7 = UT_add_suite("ut-kvp - test kvp_open_memory()", test_ut_kvp_createGlobalKVPInstanceForMallocedData, test_ut_kvp_freeGlobalInstance);
     assert(gpKVPSuite7 != NULL);
@@ -1406,4 +3461,27 @@ void register_kvp_functions( void )
     UT_add_test(gpKVPSuite12, "kvp bool from main yaml", test_ut_kvp_bool_on_main_yaml_for_sequence_includes);
     UT_add_test(gpKVPSuite12, "kvp node presence from main yaml", test_ut_kvp_fieldPresent_on_main_yaml_for_sequence_includes);
     UT_add_test(gpKVPSuite12, "kvp ssequence include support on malloc data", test_ut_kvp_ResolveAliasesAnchorsMergeKeysFromMallocedData);
+
+    /* Perform the same parsing tests with the path index enabled */
+    gpKVPSuite13 = UT_add_suite("ut-kvp - test main functions YAML Decoder with index", test_ut_kvp_createGlobalYAMLIndexedInstance, test_ut_kvp_freeGlobalInstance);
+    assert(gpKVPSuite13 != NULL);
+
+    UT_add_test(gpKVPSuite13, "kvp uint8", test_ut_kvp_uint8);
+    UT_add_test(gpKVPSuite13, "kvp uint16", test_ut_kvp_uint16);
+    UT_add_test(gpKVPSuite13, "kvp bool", test_ut_kvp_bool);
+    UT_add_test(gpKVPSuite13, "kvp string", test_ut_kvp_string);
+    UT_add_test(gpKVPSuite13, "kvp string view", test_ut_kvp_stringView);
+    UT_add_test(gpKVPSuite13, "kvp get fields", test_ut_kvp_getFields);
+    UT_add_test(gpKVPSuite13, "kvp iterator", test_ut_kvp_iterator);
+    UT_add_test(gpKVPSuite13, "kvp arrays", test_ut_kvp_arrays);
+    UT_add_test(gpKVPSuite13, "kvp uint32", test_ut_kvp_uint32);
+    UT_add_test(gpKVPSuite13, "kvp uint64", test_ut_kvp_uint64);
+    UT_add_test(gpKVPSuite13, "kvp list", test_ut_kvp_list);
+    UT_add_test(gpKVPSuite13, "kvp float", test_ut_kvp_getFloatField);
+    UT_add_test(gpKVPSuite13, "kvp double", test_ut_kvp_getDoubleField);
+    UT_add_test(gpKVPSuite13, "kvp node presence", test_ut_kvp_fieldPresent);
+    UT_add_test(gpKVPSuite13, "kvp dataByte", test_ut_kvp_dataByte);
+    UT_add_test(gpKVPSuite13, "kvp dataByte to buffer", test_ut_kvp_dataBytesToBuffer);
+    UT_add_test(gpKVPSuite13, "kvp key handle", test_ut_kvp_keyHandle);
+    UT_add_test(gpKVPSuite13, "kvp indexed paths", test_ut_kvp_indexedPaths);
 }
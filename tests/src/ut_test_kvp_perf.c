@@ -0,0 +1,679 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_kvp.h>
+#include <ut_log.h>
+
+#include "ut_test_common.h"
+
+#define KVP_PERF_TEST_YAML_FILE "assets/test_kvp.yaml"
+#define KVP_PERF_ITERATIONS (100000)
+#define KVP_PERF_TABLE_ENTRIES (5000)
+#define KVP_PERF_BLOB_BYTES (1024 * 1024)
+#define KVP_PERF_PROFILE_TEMPLATE "/tmp/ut_kvp_perf_XXXXXX"
+#define KVP_PERF_URL_INCLUDES (20)
+#define KVP_PERF_MAX_THREADS (16)
+
+static ut_kvp_instance_t *gpPerfTestInstance = NULL;
+static UT_test_suite_t *gpKVPPerfSuite = NULL;
+
+static int test_ut_kvp_perf_createInstance(void);
+static int test_ut_kvp_perf_freeInstance(void);
+
+static uint64_t perf_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void perf_report(const char *pszName, uint64_t startNs, uint64_t endNs)
+{
+    UT_LOG("%-40s : %8.1f ns/call\n", pszName, (double)(endNs - startNs) / KVP_PERF_ITERATIONS);
+}
+
+/* Reference path: copy the scalar into a buffer and convert it, as the typed getters used to */
+static uint32_t perf_getUInt32ViaString(ut_kvp_instance_t *pInstance, const char *pszKey)
+{
+    char zResult[UT_KVP_MAX_ELEMENT_SIZE];
+
+    if (ut_kvp_getStringField(pInstance, pszKey, zResult, sizeof(zResult)) != UT_KVP_STATUS_SUCCESS)
+    {
+        return 0;
+    }
+    return (uint32_t)strtoul(zResult, NULL, 0);
+}
+
+void test_ut_kvp_perf_typedGetters(void)
+{
+    volatile uint64_t sink = 0;
+    uint64_t start;
+    ut_kvp_key_t *pKey;
+
+    UT_ASSERT( ut_kvp_getUInt32Field(gpPerfTestInstance, "decodeTest/checkUint32IsDeadBeefHex") == 0xdeadbeef );
+    UT_ASSERT( perf_getUInt32ViaString(gpPerfTestInstance, "decodeTest/checkUint32IsDeadBeefHex") == 0xdeadbeef );
+
+    start = perf_now_ns();
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += perf_getUInt32ViaString(gpPerfTestInstance, "decodeTest/checkUint32IsDeadBeefHex");
+    }
+    perf_report("string copy + strtoul (reference)", start, perf_now_ns());
+
+    start = perf_now_ns();
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += ut_kvp_getUInt32Field(gpPerfTestInstance, "decodeTest/checkUint32IsDeadBeefHex");
+    }
+    perf_report("ut_kvp_getUInt32Field", start, perf_now_ns());
+
+    start = perf_now_ns();
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += ut_kvp_getUInt64Field(gpPerfTestInstance, "decodeTest/checkUint64IsDeadBeefDec");
+    }
+    perf_report("ut_kvp_getUInt64Field", start, perf_now_ns());
+
+    start = perf_now_ns();
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += ut_kvp_getBoolField(gpPerfTestInstance, "decodeTest/checkBoolTRUE");
+    }
+    perf_report("ut_kvp_getBoolField", start, perf_now_ns());
+
+    start = perf_now_ns();
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += (uint64_t)ut_kvp_getDoubleField(gpPerfTestInstance, "decodeTest/checkDoublePi");
+    }
+    perf_report("ut_kvp_getDoubleField", start, perf_now_ns());
+
+    pKey = ut_kvp_compileKey(gpPerfTestInstance, "decodeTest/checkUint32IsDeadBeefHex");
+    UT_ASSERT( pKey != NULL );
+
+    start = perf_now_ns();
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += ut_kvp_getUInt32ByHandle(gpPerfTestInstance, pKey);
+    }
+    perf_report("ut_kvp_getUInt32ByHandle", start, perf_now_ns());
+
+    ut_kvp_freeKey(pKey);
+
+    UT_ASSERT( sink != 0 );
+}
+
+void test_ut_kvp_perf_batchGetters(void)
+{
+    volatile uint64_t sink = 0;
+    uint32_t failures = 0;
+    uint64_t start;
+    uint32_t u32Hex = 0;
+    uint32_t u32Dec = 0;
+    uint64_t u64Hex = 0;
+    uint64_t u64Dec = 0;
+    bool bValue = false;
+    ut_kvp_field_t fields[] =
+    {
+        { "decodeTest/checkUint32IsDeadBeefHex", UT_KVP_FIELD_TYPE_UINT32, &u32Hex, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkUint32IsDeadBeefDec", UT_KVP_FIELD_TYPE_UINT32, &u32Dec, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkUint64IsDeadBeefHex", UT_KVP_FIELD_TYPE_UINT64, &u64Hex, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkUint64IsDeadBeefDec", UT_KVP_FIELD_TYPE_UINT64, &u64Dec, 0, UT_KVP_STATUS_MAX },
+        { "decodeTest/checkBoolTRUE", UT_KVP_FIELD_TYPE_BOOL, &bValue, 0, UT_KVP_STATUS_MAX },
+    };
+
+    start = perf_now_ns();
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += ut_kvp_getUInt32Field(gpPerfTestInstance, "decodeTest/checkUint32IsDeadBeefHex");
+        sink += ut_kvp_getUInt32Field(gpPerfTestInstance, "decodeTest/checkUint32IsDeadBeefDec");
+        sink += ut_kvp_getUInt64Field(gpPerfTestInstance, "decodeTest/checkUint64IsDeadBeefHex");
+        sink += ut_kvp_getUInt64Field(gpPerfTestInstance, "decodeTest/checkUint64IsDeadBeefDec");
+        sink += ut_kvp_getBoolField(gpPerfTestInstance, "decodeTest/checkBoolTRUE");
+    }
+    perf_report("5 single getters", start, perf_now_ns());
+
+    /* Failures are counted rather than asserted, so the loop times the getter alone */
+    start = perf_now_ns();
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        if (ut_kvp_getFields(gpPerfTestInstance, fields, sizeof(fields)/sizeof(fields[0])) != UT_KVP_STATUS_SUCCESS)
+        {
+            failures++;
+        }
+        sink += u32Hex + u32Dec + u64Hex + u64Dec + bValue;
+    }
+    perf_report("ut_kvp_getFields (5 fields)", start, perf_now_ns());
+
+    UT_ASSERT( failures == 0 );
+    UT_ASSERT( u32Hex == u32Dec );
+    UT_ASSERT( u64Hex == u64Dec );
+    UT_ASSERT( sink != 0 );
+}
+
+void test_ut_kvp_perf_arrayGetters(void)
+{
+    ut_kvp_instance_t *pInstance;
+    uint32_t *pValues;
+    uint32_t count = 0;
+    uint64_t start;
+    uint64_t end;
+    char zKey[UT_KVP_MAX_ELEMENT_SIZE];
+    size_t size = 16 + (KVP_PERF_TABLE_ENTRIES * 16);
+    size_t used;
+    char *pData;
+    bool match = true;
+
+    /* Build a calibration style table, ownership of pData passes to the instance */
+    pData = malloc(size);
+    UT_ASSERT( pData != NULL );
+    if ( pData == NULL )
+    {
+        return;
+    }
+    used = snprintf(pData, size, "table:\n");
+    for (uint32_t i = 0; i < KVP_PERF_TABLE_ENTRIES; i++)
+    {
+        used += snprintf(&pData[used], size - used, "  - %u\n", 100000000u + (i * 7919u));
+    }
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+    UT_ASSERT( ut_kvp_openMemory(pInstance, pData, (uint32_t)used) == UT_KVP_STATUS_SUCCESS );
+
+    pValues = malloc(KVP_PERF_TABLE_ENTRIES * sizeof(uint32_t));
+    UT_ASSERT( pValues != NULL );
+    if ( pValues == NULL )
+    {
+        ut_kvp_destroyInstance(pInstance);
+        return;
+    }
+
+    start = perf_now_ns();
+    for (uint32_t i = 0; i < KVP_PERF_TABLE_ENTRIES; i++)
+    {
+        snprintf(zKey, sizeof(zKey), "table/%u", i);
+        pValues[i] = ut_kvp_getUInt32Field(pInstance, zKey);
+    }
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f ns/element\n", "ut_kvp_getUInt32Field per element", (double)(end - start) / KVP_PERF_TABLE_ENTRIES);
+
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_getUInt32Array(pInstance, "table", pValues, KVP_PERF_TABLE_ENTRIES, &count) == UT_KVP_STATUS_SUCCESS );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f ns/element\n", "ut_kvp_getUInt32Array", (double)(end - start) / KVP_PERF_TABLE_ENTRIES);
+
+    UT_ASSERT( count == KVP_PERF_TABLE_ENTRIES );
+    for (uint32_t i = 0; i < KVP_PERF_TABLE_ENTRIES; i++)
+    {
+        match = match && (pValues[i] == 100000000u + (i * 7919u));
+    }
+    UT_ASSERT( match == true );
+
+    free(pValues);
+    ut_kvp_destroyInstance(pInstance);
+}
+
+void test_ut_kvp_perf_dataBytes(void)
+{
+    ut_kvp_instance_t *pInstance;
+    unsigned char *pBytes;
+    unsigned char *pBuffer;
+    uint32_t size = 0;
+    int count = 0;
+    uint64_t start;
+    uint64_t end;
+    size_t dataSize = 16 + (KVP_PERF_BLOB_BYTES * 5);
+    size_t used;
+    char *pData;
+
+    /* A firmware style blob, ownership of pData passes to the instance */
+    pData = malloc(dataSize);
+    UT_ASSERT( pData != NULL );
+    if ( pData == NULL )
+    {
+        return;
+    }
+    used = snprintf(pData, dataSize, "blob: ");
+    for (uint32_t i = 0; i < KVP_PERF_BLOB_BYTES; i++)
+    {
+        used += snprintf(&pData[used], dataSize - used, "0x%02x%s", i & 0xff, (i + 1 < KVP_PERF_BLOB_BYTES) ? " " : "\n");
+    }
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+    UT_ASSERT( ut_kvp_openMemory(pInstance, pData, (uint32_t)used) == UT_KVP_STATUS_SUCCESS );
+
+    start = perf_now_ns();
+    pBytes = ut_kvp_getDataBytes(pInstance, "blob", &count);
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f ns/byte\n", "ut_kvp_getDataBytes", (double)(end - start) / KVP_PERF_BLOB_BYTES);
+    UT_ASSERT( pBytes != NULL );
+    UT_ASSERT( count == KVP_PERF_BLOB_BYTES );
+
+    pBuffer = malloc(KVP_PERF_BLOB_BYTES);
+    UT_ASSERT( pBuffer != NULL );
+    if ( pBuffer != NULL )
+    {
+        start = perf_now_ns();
+        UT_ASSERT( ut_kvp_getDataBytesToBuffer(pInstance, "blob", pBuffer, KVP_PERF_BLOB_BYTES, &size) == UT_KVP_STATUS_SUCCESS );
+        end = perf_now_ns();
+        UT_LOG("%-40s : %8.1f ns/byte\n", "ut_kvp_getDataBytesToBuffer", (double)(end - start) / KVP_PERF_BLOB_BYTES);
+        UT_ASSERT( size == KVP_PERF_BLOB_BYTES );
+        UT_ASSERT( (pBytes != NULL) && (memcmp(pBytes, pBuffer, KVP_PERF_BLOB_BYTES) == 0) );
+        free(pBuffer);
+    }
+
+    free(pBytes);
+    ut_kvp_destroyInstance(pInstance);
+}
+
+/* A large profile on disk, one mapping per table entry, under "table" or each a top-level section */
+static bool perf_writeProfile(char *pszFileName, bool sections)
+{
+    FILE *pFile;
+    int fd;
+
+    fd = mkstemp(pszFileName);
+    if ( fd < 0 )
+    {
+        return false;
+    }
+    pFile = fdopen(fd, "w");
+    if ( pFile == NULL )
+    {
+        close(fd);
+        unlink(pszFileName);
+        return false;
+    }
+    if (sections == false)
+    {
+        fprintf(pFile, "table:\n");
+    }
+    for (uint32_t i = 0; i < KVP_PERF_TABLE_ENTRIES; i++)
+    {
+        fprintf(pFile, "%sentry%u:\n%s  id: %u\n%s  name: \"calibration entry %u\"\n", sections ? "" : "  ", i,
+                sections ? "" : "  ", 100000000u + (i * 7919u), sections ? "" : "  ", i);
+    }
+    fclose(pFile);
+
+    return true;
+}
+
+void test_ut_kvp_perf_openMapped(void)
+{
+    ut_kvp_instance_t *pInstance;
+    char zFileName[] = KVP_PERF_PROFILE_TEMPLATE;
+    uint64_t start;
+    uint64_t end;
+    bool written;
+
+    written = perf_writeProfile(zFileName, false);
+    UT_ASSERT( written == true );
+    if ( written == false )
+    {
+        return;
+    }
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_open(pInstance, zFileName) == UT_KVP_STATUS_SUCCESS );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "ut_kvp_open", (double)(end - start) / 1000.0);
+    UT_ASSERT( ut_kvp_getUInt32Field(pInstance, "table/entry4999/id") == 100000000u + (4999u * 7919u) );
+    ut_kvp_close(pInstance);
+
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_openMapped(pInstance, zFileName) == UT_KVP_STATUS_SUCCESS );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "ut_kvp_openMapped", (double)(end - start) / 1000.0);
+    UT_ASSERT( ut_kvp_getUInt32Field(pInstance, "table/entry4999/id") == 100000000u + (4999u * 7919u) );
+
+    ut_kvp_destroyInstance(pInstance);
+    unlink(zFileName);
+}
+
+void test_ut_kvp_perf_clone(void)
+{
+    ut_kvp_instance_t *pInstance;
+    ut_kvp_instance_t *pClone;
+    char zFileName[] = KVP_PERF_PROFILE_TEMPLATE;
+    uint64_t start;
+    uint64_t end;
+    bool written;
+
+    written = perf_writeProfile(zFileName, false);
+    UT_ASSERT( written == true );
+    if ( written == false )
+    {
+        return;
+    }
+
+    pInstance = ut_kvp_createInstanceWithFlags(UT_KVP_FLAG_INDEX);
+    UT_ASSERT( pInstance != NULL );
+
+    /* A private copy used to take a second parse of the profile */
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_open(pInstance, zFileName) == UT_KVP_STATUS_SUCCESS );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "ut_kvp_open", (double)(end - start) / 1000.0);
+
+    start = perf_now_ns();
+    pClone = ut_kvp_clone(pInstance);
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "ut_kvp_clone", (double)(end - start) / 1000.0);
+    UT_ASSERT( pClone != NULL );
+    UT_ASSERT( ut_kvp_getUInt32Field(pClone, "table/entry4999/id") == 100000000u + (4999u * 7919u) );
+
+    ut_kvp_destroyInstance(pClone);
+    ut_kvp_destroyInstance(pInstance);
+    unlink(zFileName);
+}
+
+void test_ut_kvp_perf_lazyOpen(void)
+{
+    ut_kvp_instance_t *pInstance;
+    char zFileName[] = KVP_PERF_PROFILE_TEMPLATE;
+    uint64_t start;
+    uint64_t end;
+    bool written;
+
+    written = perf_writeProfile(zFileName, true);
+    UT_ASSERT( written == true );
+    if ( written == false )
+    {
+        return;
+    }
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_open(pInstance, zFileName) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field(pInstance, "entry4999/id") == 100000000u + (4999u * 7919u) );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "ut_kvp_open, one section read", (double)(end - start) / 1000.0);
+    ut_kvp_destroyInstance(pInstance);
+
+    /* Only the section read is parsed */
+    pInstance = ut_kvp_createInstanceWithFlags(UT_KVP_FLAG_LAZY);
+    UT_ASSERT( pInstance != NULL );
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_open(pInstance, zFileName) == UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT( ut_kvp_getUInt32Field(pInstance, "entry4999/id") == 100000000u + (4999u * 7919u) );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "UT_KVP_FLAG_LAZY, one section read", (double)(end - start) / 1000.0);
+    ut_kvp_destroyInstance(pInstance);
+
+    unlink(zFileName);
+}
+
+void test_ut_kvp_perf_openImage(void)
+{
+    volatile uint64_t sink = 0;
+    ut_kvp_instance_t *pInstance;
+    char zFileName[] = KVP_PERF_PROFILE_TEMPLATE;
+    char zImageName[] = KVP_PERF_PROFILE_TEMPLATE;
+    uint64_t start;
+    uint64_t end;
+    bool written;
+    int fd;
+
+    written = perf_writeProfile(zFileName, false);
+    UT_ASSERT( written == true );
+    if ( written == false )
+    {
+        return;
+    }
+    fd = mkstemp(zImageName);
+    UT_ASSERT( fd >= 0 );
+    if ( fd < 0 )
+    {
+        unlink(zFileName);
+        return;
+    }
+    close(fd);
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT( pInstance != NULL );
+
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_open(pInstance, zFileName) == UT_KVP_STATUS_SUCCESS );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "ut_kvp_open", (double)(end - start) / 1000.0);
+
+    start = perf_now_ns();
+    for (uint32_t i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += ut_kvp_getUInt32Field(pInstance, "table/entry4999/id");
+    }
+    perf_report("ut_kvp_getUInt32Field (document)", start, perf_now_ns());
+
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_compileImage(pInstance, zImageName) == UT_KVP_STATUS_SUCCESS );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "ut_kvp_compileImage", (double)(end - start) / 1000.0);
+
+    start = perf_now_ns();
+    UT_ASSERT( ut_kvp_openImage(pInstance, zImageName) == UT_KVP_STATUS_SUCCESS );
+    end = perf_now_ns();
+    UT_LOG("%-40s : %8.1f us\n", "ut_kvp_openImage", (double)(end - start) / 1000.0);
+    UT_ASSERT( ut_kvp_getUInt32Field(pInstance, "table/entry4999/id") == 100000000u + (4999u * 7919u) );
+
+    start = perf_now_ns();
+    for (uint32_t i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        sink += ut_kvp_getUInt32Field(pInstance, "table/entry4999/id");
+    }
+    perf_report("ut_kvp_getUInt32Field (image)", start, perf_now_ns());
+    UT_ASSERT( sink == 2ULL * KVP_PERF_ITERATIONS * (100000000u + (4999u * 7919u)) );
+
+    ut_kvp_destroyInstance(pInstance);
+    unlink(zImageName);
+    unlink(zFileName);
+}
+
+void test_ut_kvp_perf_urlIncludes(void)
+{
+    const uint32_t modes[] = { UT_KVP_FLAG_NONE, UT_KVP_FLAG_PARALLEL_INCLUDES };
+    test_ut_http_server_t *pServer;
+    ut_kvp_instance_t *pInstance;
+    char zKey[32];
+    char *pProfile;
+    size_t used = 0;
+    uint64_t start;
+    uint64_t end;
+
+    pServer = http_server_start();
+    UT_ASSERT( pServer != NULL );
+    if (pServer == NULL)
+    {
+        return;
+    }
+
+    for (uint32_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        unsigned int connections = http_server_connections(pServer);
+        unsigned int requests = http_server_requests(pServer);
+
+        /* The profile is taken over by the instance, so it is built again for each open */
+        pProfile = malloc(KVP_PERF_URL_INCLUDES * 96);
+        UT_ASSERT( pProfile != NULL );
+        used = 0;
+        for (uint32_t i = 0; i < KVP_PERF_URL_INCLUDES; i++)
+        {
+            used += sprintf(&pProfile[used], "f%u: !include http://127.0.0.1:%u/fragment%u.yaml\n", i, http_server_port(pServer), i);
+        }
+
+        pInstance = ut_kvp_createInstanceWithFlags(modes[m]);
+        UT_ASSERT( pInstance != NULL );
+
+        ut_kvp_clearIncludeCache();
+        start = perf_now_ns();
+        UT_ASSERT( ut_kvp_openMemory(pInstance, pProfile, used) == UT_KVP_STATUS_SUCCESS );
+        end = perf_now_ns();
+
+        for (uint32_t i = 0; i < KVP_PERF_URL_INCLUDES; i++)
+        {
+            snprintf(zKey, sizeof(zKey), "f%u/fragment%u/value", i, i);
+            UT_ASSERT( ut_kvp_getBoolField(pInstance, zKey) == true );
+        }
+
+        connections = http_server_connections(pServer) - connections;
+        requests = http_server_requests(pServer) - requests;
+        UT_LOG("%-40s : %8.1f us, %u requests on %u connections\n",
+               (modes[m] == UT_KVP_FLAG_NONE) ? "ut_kvp_openMemory (URL includes)" : "ut_kvp_openMemory (parallel URL includes)",
+               (double)(end - start) / 1000.0, requests, connections);
+
+        /* Connections stay open between includes, and between profiles */
+        UT_ASSERT( requests == KVP_PERF_URL_INCLUDES );
+        UT_ASSERT( connections <= ((m == 0) ? 1 : 4) );
+
+        ut_kvp_destroyInstance(pInstance);
+    }
+
+    ut_kvp_clearIncludeCache();
+    http_server_stop(pServer);
+}
+
+// Struct to store what each thread of test_ut_kvp_perf_threadedReads() reads
+typedef struct
+{
+    ut_kvp_instance_t *pInstance;
+    uint64_t sink;
+} perf_reader_t;
+
+static void *perf_readerThread(void *pArg)
+{
+    perf_reader_t *pReader = (perf_reader_t *)pArg;
+
+    for (int i = 0; i < KVP_PERF_ITERATIONS; i++)
+    {
+        pReader->sink += ut_kvp_getUInt32Field(pReader->pInstance, "decodeTest/checkUint32IsDeadBeefHex");
+    }
+
+    return NULL;
+}
+
+/* Aggregate reads per second with 1, 2, 4 ... threads, each doing KVP_PERF_ITERATIONS reads */
+static void perf_threadedReads(const char *pszMode, uint32_t flags, uint32_t maxThreads)
+{
+    perf_reader_t readers[KVP_PERF_MAX_THREADS];
+    pthread_t threads[KVP_PERF_MAX_THREADS];
+    ut_kvp_instance_t *pInstance;
+    uint64_t start;
+    uint64_t end;
+
+    pInstance = ut_kvp_createInstanceWithFlags(flags);
+    UT_ASSERT( pInstance != NULL );
+    if (pInstance == NULL)
+    {
+        return;
+    }
+    UT_ASSERT( ut_kvp_open(pInstance, KVP_PERF_TEST_YAML_FILE) == UT_KVP_STATUS_SUCCESS );
+
+    for (uint32_t count = 1; count <= maxThreads; count *= 2)
+    {
+        start = perf_now_ns();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            readers[i].pInstance = pInstance;
+            readers[i].sink = 0;
+            UT_ASSERT( pthread_create(&threads[i], NULL, perf_readerThread, &readers[i]) == 0 );
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            pthread_join(threads[i], NULL);
+            UT_ASSERT( readers[i].sink == (uint64_t)0xdeadbeef * KVP_PERF_ITERATIONS );
+        }
+        end = perf_now_ns();
+
+        UT_LOG("%-24s %2u threads : %8.2f M reads/s\n", pszMode, count,
+               ((double)count * KVP_PERF_ITERATIONS * 1000.0) / (double)(end - start));
+    }
+
+    ut_kvp_destroyInstance(pInstance);
+}
+
+void test_ut_kvp_perf_threadedReads(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t maxThreads = (cores < 1) ? 1 : ((cores > KVP_PERF_MAX_THREADS) ? KVP_PERF_MAX_THREADS : (uint32_t)cores);
+
+    perf_threadedReads("UT_KVP_FLAG_THREADSAFE", UT_KVP_FLAG_THREADSAFE | UT_KVP_FLAG_INDEX, maxThreads);
+    perf_threadedReads("UT_KVP_FLAG_CONCURRENT", UT_KVP_FLAG_CONCURRENT | UT_KVP_FLAG_INDEX, maxThreads);
+}
+
+static int test_ut_kvp_perf_createInstance(void)
+{
+    ut_kvp_status_t status;
+
+    gpPerfTestInstance = ut_kvp_createInstance();
+    if ( gpPerfTestInstance == NULL )
+    {
+        UT_LOG_ERROR("ut_kvp_createInstance() - Failure");
+        return -1;
+    }
+
+    status = ut_kvp_open(gpPerfTestInstance, KVP_PERF_TEST_YAML_FILE);
+    if ( status != UT_KVP_STATUS_SUCCESS )
+    {
+        UT_LOG_ERROR("ut_kvp_open() - Read Failure");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_ut_kvp_perf_freeInstance(void)
+{
+    ut_kvp_destroyInstance(gpPerfTestInstance);
+    gpPerfTestInstance = NULL;
+    return 0;
+}
+
+void register_kvp_perf_functions(void)
+{
+    gpKVPPerfSuite = UT_add_suite("ut-kvp - performance", test_ut_kvp_perf_createInstance, test_ut_kvp_perf_freeInstance);
+    assert(gpKVPPerfSuite != NULL);
+
+    UT_add_test(gpKVPPerfSuite, "kvp typed getters", test_ut_kvp_perf_typedGetters);
+    UT_add_test(gpKVPPerfSuite, "kvp batch getters", test_ut_kvp_perf_batchGetters);
+    UT_add_test(gpKVPPerfSuite, "kvp array getters", test_ut_kvp_perf_arrayGetters);
+    UT_add_test(gpKVPPerfSuite, "kvp data bytes", test_ut_kvp_perf_dataBytes);
+    UT_add_test(gpKVPPerfSuite, "kvp open mapped", test_ut_kvp_perf_openMapped);
+    UT_add_test(gpKVPPerfSuite, "kvp clone", test_ut_kvp_perf_clone);
+    UT_add_test(gpKVPPerfSuite, "kvp lazy open", test_ut_kvp_perf_lazyOpen);
+    UT_add_test(gpKVPPerfSuite, "kvp open image", test_ut_kvp_perf_openImage);
+    UT_add_test(gpKVPPerfSuite, "kvp URL includes", test_ut_kvp_perf_urlIncludes);
+    UT_add_test(gpKVPPerfSuite, "kvp threaded reads", test_ut_kvp_perf_threadedReads);
+}
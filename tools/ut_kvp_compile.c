@@ -0,0 +1,69 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Module Includes */
+#include <ut_kvp.h>
+
+/**
+ * @brief Compiles a KVP profile into an image for ut_kvp_openImage()
+ *
+ * Usage: ut-kvp-compile <input profile> <output image>
+ */
+int main(int argc, char **argv)
+{
+    ut_kvp_instance_t *pInstance;
+    ut_kvp_status_t status;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <input profile> <output image>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    pInstance = ut_kvp_createInstance();
+    if (pInstance == NULL)
+    {
+        fprintf(stderr, "Unable to create a KVP instance\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Includes are resolved here, the image holds the final document */
+    status = ut_kvp_open(pInstance, argv[1]);
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        fprintf(stderr, "Unable to open [%s], status [%d]\n", argv[1], status);
+        ut_kvp_destroyInstance(pInstance);
+        return EXIT_FAILURE;
+    }
+
+    status = ut_kvp_compileImage(pInstance, argv[2]);
+    if (status != UT_KVP_STATUS_SUCCESS)
+    {
+        fprintf(stderr, "Unable to write [%s], status [%d]\n", argv[2], status);
+        ut_kvp_destroyInstance(pInstance);
+        return EXIT_FAILURE;
+    }
+
+    ut_kvp_destroyInstance(pInstance);
+    return EXIT_SUCCESS;
+}